@@ -3,155 +3,466 @@
 #include <string.h>
 #include <stdio.h>
 
-static char* sdup(const char* s) {
-    if (!s) return NULL;
-    size_t n = strlen(s);
-    char* r = (char*)malloc(n + 1);
+// Arena
+
+#define ARENA_ALIGNEMENT 8
+#define ARENA_BLOC_MIN   (64 * 1024)
+#define ARENA_BLOC_MAX   (1024 * 1024)
+
+struct ASTArenaBloc {
+    ASTArenaBloc* suivant;
+    size_t taille;          // octets de données après l'en-tête
+};
+
+void ast_arena_init(ASTArena* a) {
+    memset(a, 0, sizeof(*a));
+}
+
+static void partage_liberer(ASTPartage* t);
+
+void ast_arena_liberer(ASTArena* a) {
+    partage_liberer(a->partage);
+    ASTArenaBloc* b = a->blocs;
+    while (b) {
+        ASTArenaBloc* suivant = b->suivant;
+        free(b);
+        b = suivant;
+    }
+    ast_arena_init(a);
+}
+
+void ast_arena_absorber(ASTArena* a, ASTArena* b) {
+    partage_liberer(b->partage);
+    b->partage = NULL;
+    if (!b->blocs) return;
+    if (!a->blocs) {
+        ASTPartage* partage = a->partage;
+        *a = *b;
+        a->partage = partage;
+        ast_arena_init(b);
+        return;
+    }
+
+    // Les blocs de b passent derrière le bloc courant de a, qui reste en
+    // tête : a continue d'allouer là où il en était
+    ASTArenaBloc* dernier = b->blocs;
+    while (dernier->suivant) dernier = dernier->suivant;
+    dernier->suivant = a->blocs->suivant;
+    a->blocs->suivant = b->blocs;
+
+    a->nb_blocs += b->nb_blocs;
+    a->octets_reserves += b->octets_reserves;
+    a->octets_utilises += b->octets_utilises;
+    a->octets_noeuds += b->octets_noeuds;
+    a->octets_chaines += b->octets_chaines;
+    a->octets_listes += b->octets_listes;
+    a->nb_noeuds += b->nb_noeuds;
+    a->nb_reutilises += b->nb_reutilises;
+    a->octets_evites += b->octets_evites;
+    ast_arena_init(b);
+}
+
+// Nouveau bloc courant, d'au moins n octets. Taille doublée à chaque
+// bloc jusqu'à ARENA_BLOC_MAX : peu de blocs pour les gros programmes.
+static bool arena_nouveau_bloc(ASTArena* a, size_t n) {
+    size_t taille = ARENA_BLOC_MIN;
+    for (int i = 0; i < a->nb_blocs && taille < ARENA_BLOC_MAX; i++) taille *= 2;
+    if (taille < n) taille = n;
+
+    // l'en-tête (deux mots) garde les données alignées
+    ASTArenaBloc* b = (ASTArenaBloc*)malloc(sizeof(ASTArenaBloc) + taille);
+    if (!b) return false;
+    b->suivant = a->blocs;
+    b->taille = taille;
+    a->blocs = b;
+    a->courant = (char*)(b + 1);
+    a->fin = a->courant + taille;
+    a->nb_blocs++;
+    a->octets_reserves += taille;
+    return true;
+}
+
+static void* arena_alloc(ASTArena* a, size_t n) {
+    n = (n + ARENA_ALIGNEMENT - 1) & ~(size_t)(ARENA_ALIGNEMENT - 1);
+    if ((size_t)(a->fin - a->courant) < n) {
+        if (!arena_nouveau_bloc(a, n)) return NULL;
+    }
+    void* r = a->courant;
+    a->courant += n;
+    a->octets_utilises += n;
+    return r;
+}
+
+char* ast_arena_texte(ASTArena* a, const char* s, size_t n) {
+    char* r = (char*)arena_alloc(a, n + 1);
     if (!r) return NULL;
-    memcpy(r, s, n + 1);
+    memcpy(r, s, n);
+    r[n] = '\0';
+    a->octets_chaines += n + 1;
     return r;
 }
 
+static char* arena_sdup(ASTArena* a, const char* s) {
+    if (!s) return NULL;
+    return ast_arena_texte(a, s, strlen(s));
+}
+
+void ast_arena_afficher_stats(const ASTArena* a) {
+    printf("Arena AST : %d noeuds, %zu octets utilisés / %zu réservés (%d blocs)\n",
+           a->nb_noeuds, a->octets_utilises, a->octets_reserves, a->nb_blocs);
+    printf("  noeuds %zu, chaînes %zu, listes %zu octets\n",
+           a->octets_noeuds, a->octets_chaines, a->octets_listes);
+    if (a->partage) {
+        printf("  partage : %d noeuds réutilisés, %zu octets évités\n",
+               a->nb_reutilises, a->octets_evites);
+    }
+}
+
 void ast_list_init(ASTList* list) {
     list->items = NULL;
     list->count = 0;
     list->cap = 0;
 }
 
-void ast_list_push(ASTList* list, ASTNode* node) {
+// Le tableau plein est recopié dans un tableau deux fois plus grand ;
+// l'ancien reste dans l'arena (au plus autant que le tableau final),
+// sauf s'il est le dernier alloué : il est alors agrandi sur place.
+void ast_list_push(ASTArena* a, ASTList* list, ASTNode* node) {
     if (!list) return;
     if (list->count >= list->cap) {
-        int ncap = (list->cap == 0) ? 8 : list->cap * 2;
-        ASTNode** nitems = (ASTNode**)realloc(list->items, (size_t)ncap * sizeof(ASTNode*));
-        if (!nitems) return;
-        list->items = nitems;
+        int ncap = (list->cap == 0) ? 4 : list->cap * 2;
+        size_t avant = (size_t)list->cap * sizeof(ASTNode*);
+        size_t apres = (size_t)ncap * sizeof(ASTNode*);
+
+        if (list->items && (char*)list->items + avant == a->courant &&
+            (size_t)(a->fin - a->courant) >= apres - avant) {
+            a->courant += apres - avant;
+            a->octets_utilises += apres - avant;
+        } else {
+            ASTNode** nitems = (ASTNode**)arena_alloc(a, apres);
+            if (!nitems) return;
+            if (list->count > 0) memcpy(nitems, list->items, (size_t)list->count * sizeof(ASTNode*));
+            list->items = nitems;
+        }
+        a->octets_listes += apres - avant;
         list->cap = ncap;
     }
     list->items[list->count++] = node;
 }
 
-void ast_list_free_shallow(ASTList* list) {
-    if (!list) return;
-    free(list->items);
-    list->items = NULL;
-    list->count = 0;
-    list->cap = 0;
-}
-
-static ASTNode* ast_alloc(ASTKind kind, int line, int col) {
-    ASTNode* n = (ASTNode*)calloc(1, sizeof(ASTNode));
+// Taille allouée par type de nœud : en-tête + membre de l'union utilisé.
+// Un littéral ou un identificateur ne paie pas la taille d'un IF.
+#define TAILLE_NOEUD(membre) (offsetof(ASTNode, as) + sizeof(((ASTNode*)0)->as.membre))
+
+static const size_t TAILLE_PAR_TYPE[] = {
+    [AST_PROGRAM]        = TAILLE_NOEUD(program),
+    [AST_DECL_VAR]       = TAILLE_NOEUD(decl_var),
+    [AST_DECL_CONST]     = TAILLE_NOEUD(decl_const),
+    [AST_DECL_ARRAY]     = TAILLE_NOEUD(decl_array),
+    [AST_TYPE_ARRAY]     = TAILLE_NOEUD(type_array),
+    [AST_TYPE_PRIMITIVE] = TAILLE_NOEUD(type_prim),
+    [AST_TYPE_NAMED]     = TAILLE_NOEUD(type_named),
+    [AST_DEF_STRUCT]     = TAILLE_NOEUD(def_struct),
+    [AST_DEF_FUNC]       = TAILLE_NOEUD(def_func),
+    [AST_DEF_PROC]       = TAILLE_NOEUD(def_proc),
+    [AST_PARAM]          = TAILLE_NOEUD(param),
+    [AST_FIELD]          = TAILLE_NOEUD(field),
+    [AST_BLOCK]          = TAILLE_NOEUD(block),
+    [AST_ASSIGN]         = TAILLE_NOEUD(assign),
+    [AST_IF]             = TAILLE_NOEUD(if_stmt),
+    [AST_WHILE]          = TAILLE_NOEUD(while_stmt),
+    [AST_FOR]            = TAILLE_NOEUD(for_stmt),
+    [AST_REPEAT]         = TAILLE_NOEUD(repeat_stmt),
+    [AST_CALL_STMT]      = TAILLE_NOEUD(call_stmt),
+    [AST_RETURN]         = TAILLE_NOEUD(ret_stmt),
+    [AST_WRITE]          = TAILLE_NOEUD(write_stmt),
+    [AST_READ]           = TAILLE_NOEUD(read_stmt),
+    [AST_BREAK]          = offsetof(ASTNode, as),
+    [AST_QUIT_FOR]       = offsetof(ASTNode, as),
+    [AST_SWITCH]         = TAILLE_NOEUD(switch_stmt),
+    [AST_CASE]           = TAILLE_NOEUD(case_stmt),
+    [AST_BINARY]         = TAILLE_NOEUD(binary),
+    [AST_UNARY]          = TAILLE_NOEUD(unary),
+    [AST_LITERAL_INT]    = TAILLE_NOEUD(lit_int),
+    [AST_LITERAL_REAL]   = TAILLE_NOEUD(lit_real),
+    [AST_LITERAL_STRING] = TAILLE_NOEUD(lit_string),
+    [AST_LITERAL_BOOL]   = TAILLE_NOEUD(lit_bool),
+    [AST_IDENT]          = TAILLE_NOEUD(ident),
+    [AST_INDEX]          = TAILLE_NOEUD(index),
+    [AST_FIELD_ACCESS]   = TAILLE_NOEUD(field_access),
+    [AST_CALL]           = TAILLE_NOEUD(call),
+};
+
+static ASTNode* ast_alloc(ASTArena* a, ASTKind kind, int line, int col) {
+    size_t taille = TAILLE_PAR_TYPE[kind];
+    ASTNode* n = (ASTNode*)arena_alloc(a, taille);
     if (!n) return NULL;
+    memset(n, 0, taille);
     n->kind = kind;
     n->line = line;
     n->col = col;
+    a->nb_noeuds++;
+    a->octets_noeuds += taille;
     return n;
 }
 
-ASTNode* ast_new_program(const char* name, int line, int col) {
-    ASTNode* n = ast_alloc(AST_PROGRAM, line, col);
-    n->as.program.name = sdup(name);
+ASTNode* ast_new_node(ASTArena* a, ASTKind kind, int line, int col) {
+    return ast_alloc(a, kind, line, col);
+}
+
+// Partage (hash-consing)
+//
+// Table ouverte de nœuds, indexée par le hachage de leur clé : type,
+// opérateur, enfants ou nom (pointeurs), valeur ou texte des littéraux.
+
+typedef struct {
+    ASTKind kind;
+    int op;
+    const void* p1;
+    const void* p2;
+    long long v;
+    const char* texte;      // littéraux réels et chaînes (comparé par contenu)
+    uint32_t h;
+} CleNoeud;
+
+struct ASTPartage {
+    ASTNode** noeuds;       // NULL : case libre
+    uint32_t* hachages;
+    uint32_t cap;           // puissance de 2
+    uint32_t nb;
+};
+
+static void partage_liberer(ASTPartage* t) {
+    if (!t) return;
+    free(t->noeuds);
+    free(t->hachages);
+    free(t);
+}
+
+void ast_arena_partager(ASTArena* a) {
+    if (!a->partage) a->partage = (ASTPartage*)calloc(1, sizeof(ASTPartage));
+}
+
+void ast_partage_nouvelle_portee(ASTArena* a) {
+    ASTPartage* t = a->partage;
+    if (!t || t->nb == 0) return;
+    memset(t->noeuds, 0, (size_t)t->cap * sizeof(ASTNode*));
+    t->nb = 0;
+}
+
+static void cle_de(const ASTNode* n, CleNoeud* c) {
+    memset(c, 0, sizeof(*c));
+    c->kind = n->kind;
+    switch (n->kind) {
+        case AST_BINARY:
+            c->op = (int)n->as.binary.op;
+            c->p1 = n->as.binary.lhs;
+            c->p2 = n->as.binary.rhs;
+            break;
+        case AST_UNARY:
+            c->op = (int)n->as.unary.op;
+            c->p1 = n->as.unary.expr;
+            break;
+        case AST_INDEX:
+            c->p1 = n->as.index.base;
+            c->p2 = n->as.index.index;
+            break;
+        case AST_FIELD_ACCESS:
+            c->p1 = n->as.field_access.base;
+            c->p2 = n->as.field_access.field;
+            break;
+        case AST_IDENT:            c->p1 = n->as.ident.name; break;
+        case AST_LITERAL_INT:      c->v = n->as.lit_int.value; break;
+        case AST_LITERAL_BOOL:     c->v = n->as.lit_bool.value; break;
+        case AST_LITERAL_REAL:     c->texte = n->as.lit_real.text; break;
+        case AST_LITERAL_STRING:   c->texte = n->as.lit_string.text; break;
+        default: break;
+    }
+}
+
+static bool meme_cle(const CleNoeud* x, const CleNoeud* y) {
+    if (x->kind != y->kind || x->op != y->op || x->p1 != y->p1 || x->p2 != y->p2 || x->v != y->v) {
+        return false;
+    }
+    if (!x->texte || !y->texte) return x->texte == y->texte;
+    return strcmp(x->texte, y->texte) == 0;
+}
+
+// FNV-1a sur les champs de la clé
+static uint32_t hacher_cle(const CleNoeud* c) {
+    uint64_t mots[5] = {
+        (uint64_t)c->kind, (uint64_t)c->op, (uint64_t)(uintptr_t)c->p1,
+        (uint64_t)(uintptr_t)c->p2, (uint64_t)c->v
+    };
+    uint32_t h = 2166136261u;
+    const unsigned char* o = (const unsigned char*)mots;
+    for (size_t i = 0; i < sizeof(mots); i++) { h ^= o[i]; h *= 16777619u; }
+    if (c->texte) {
+        for (const char* s = c->texte; *s; s++) { h ^= (unsigned char)*s; h *= 16777619u; }
+    }
+    return h;
+}
+
+// Nœud déjà construit pour cette clé (et son hachage rempli), ou NULL
+static ASTNode* partage_trouver(ASTArena* a, CleNoeud* c) {
+    ASTPartage* t = a->partage;
+    if (!t) return NULL;
+    c->h = hacher_cle(c);
+    if (t->cap == 0) return NULL;
+
+    for (uint32_t i = c->h & (t->cap - 1); t->noeuds[i]; i = (i + 1) & (t->cap - 1)) {
+        if (t->hachages[i] != c->h) continue;
+        CleNoeud k;
+        cle_de(t->noeuds[i], &k);
+        if (meme_cle(&k, c)) {
+            a->nb_reutilises++;
+            a->octets_evites += TAILLE_PAR_TYPE[c->kind];
+            return t->noeuds[i];
+        }
+    }
+    return NULL;
+}
+
+static bool partage_agrandir(ASTPartage* t) {
+    uint32_t ncap = (t->cap == 0) ? 1024 : t->cap * 2;
+    ASTNode** noeuds = (ASTNode**)calloc(ncap, sizeof(ASTNode*));
+    uint32_t* hachages = (uint32_t*)malloc((size_t)ncap * sizeof(uint32_t));
+    if (!noeuds || !hachages) { free(noeuds); free(hachages); return false; }
+
+    for (uint32_t i = 0; i < t->cap; i++) {
+        if (!t->noeuds[i]) continue;
+        uint32_t j = t->hachages[i] & (ncap - 1);
+        while (noeuds[j]) j = (j + 1) & (ncap - 1);
+        noeuds[j] = t->noeuds[i];
+        hachages[j] = t->hachages[i];
+    }
+    free(t->noeuds);
+    free(t->hachages);
+    t->noeuds = noeuds;
+    t->hachages = hachages;
+    t->cap = ncap;
+    return true;
+}
+
+// n vient d'être construit pour la clé c (hachée par partage_trouver)
+static ASTNode* partage_ajouter(ASTArena* a, const CleNoeud* c, ASTNode* n) {
+    ASTPartage* t = a->partage;
+    if (!t || !n) return n;
+    if ((t->nb + 1) * 2 > t->cap && !partage_agrandir(t)) return n;
+
+    uint32_t i = c->h & (t->cap - 1);
+    while (t->noeuds[i]) i = (i + 1) & (t->cap - 1);
+    t->noeuds[i] = n;
+    t->hachages[i] = c->h;
+    t->nb++;
+    return n;
+}
+
+ASTNode* ast_new_program(ASTArena* a, const char* name, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_PROGRAM, line, col);
+    n->as.program.name = name;
     ast_list_init(&n->as.program.decls);
     ast_list_init(&n->as.program.defs);
     n->as.program.main_block = NULL;
     return n;
 }
 
-ASTNode* ast_new_block(int line, int col) {
-    ASTNode* n = ast_alloc(AST_BLOCK, line, col);
+ASTNode* ast_new_block(ASTArena* a, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_BLOCK, line, col);
     ast_list_init(&n->as.block.stmts);
     return n;
 }
 
-ASTNode* ast_new_type_primitive(PrimitiveType prim, int line, int col) {
-    ASTNode* n = ast_alloc(AST_TYPE_PRIMITIVE, line, col);
+ASTNode* ast_new_type_primitive(ASTArena* a, PrimitiveType prim, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_TYPE_PRIMITIVE, line, col);
     n->as.type_prim.prim = prim;
     return n;
 }
 
-ASTNode* ast_new_type_named(const char* name, int line, int col) {
-    ASTNode* n = ast_alloc(AST_TYPE_NAMED, line, col);
-    n->as.type_named.name = sdup(name);
+ASTNode* ast_new_type_named(ASTArena* a, const char* name, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_TYPE_NAMED, line, col);
+    n->as.type_named.name = name;
     return n;
 }
 
-ASTNode* ast_new_decl_var(const char* name, ASTNode* type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DECL_VAR, line, col);
-    n->as.decl_var.name = sdup(name);
+ASTNode* ast_new_decl_var(ASTArena* a, const char* name, ASTNode* type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DECL_VAR, line, col);
+    n->as.decl_var.name = name;
     n->as.decl_var.type = type;
     return n;
 }
 
-ASTNode* ast_new_decl_const(const char* name, ASTNode* type, ASTNode* value, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DECL_CONST, line, col);
-    n->as.decl_const.name = sdup(name);
+ASTNode* ast_new_decl_const(ASTArena* a, const char* name, ASTNode* type, ASTNode* value, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DECL_CONST, line, col);
+    n->as.decl_const.name = name;
     n->as.decl_const.type = type;
     n->as.decl_const.value = value;
     return n;
 }
 
-ASTNode* ast_new_decl_array(const char* name, ASTNode* elem_type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DECL_ARRAY, line, col);
-    n->as.decl_array.name = sdup(name);
+ASTNode* ast_new_decl_array(ASTArena* a, const char* name, ASTNode* elem_type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DECL_ARRAY, line, col);
+    n->as.decl_array.name = name;
     n->as.decl_array.elem_type = elem_type;
     ast_list_init(&n->as.decl_array.dims);
     return n;
 }
 
-ASTNode* ast_new_def_struct(const char* name, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DEF_STRUCT, line, col);
-    n->as.def_struct.name = sdup(name);
+ASTNode* ast_new_def_struct(ASTArena* a, const char* name, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DEF_STRUCT, line, col);
+    n->as.def_struct.name = name;
     ast_list_init(&n->as.def_struct.fields);
     return n;
 }
 
-ASTNode* ast_new_field(const char* name, ASTNode* type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_FIELD, line, col);
-    n->as.field.name = sdup(name);
+ASTNode* ast_new_field(ASTArena* a, const char* name, ASTNode* type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_FIELD, line, col);
+    n->as.field.name = name;
     n->as.field.type = type;
     return n;
 }
 
-ASTNode* ast_new_def_func(const char* name, ASTNode* return_type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DEF_FUNC, line, col);
-    n->as.def_func.name = sdup(name);
+ASTNode* ast_new_def_func(ASTArena* a, const char* name, ASTNode* return_type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DEF_FUNC, line, col);
+    n->as.def_func.name = name;
     ast_list_init(&n->as.def_func.params);
     n->as.def_func.return_type = return_type;
     n->as.def_func.body = NULL;
     return n;
 }
 
-ASTNode* ast_new_def_proc(const char* name, int line, int col) {
-    ASTNode* n = ast_alloc(AST_DEF_PROC, line, col);
-    n->as.def_proc.name = sdup(name);
+ASTNode* ast_new_def_proc(ASTArena* a, const char* name, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_DEF_PROC, line, col);
+    n->as.def_proc.name = name;
     ast_list_init(&n->as.def_proc.params);
     n->as.def_proc.body = NULL;
     return n;
 }
 
-ASTNode* ast_new_param(const char* name, ASTNode* type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_PARAM, line, col);
-    n->as.param.name = sdup(name);
+ASTNode* ast_new_param(ASTArena* a, const char* name, ASTNode* type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_PARAM, line, col);
+    n->as.param.name = name;
     n->as.param.type = type;
     return n;
 }
 
-ASTNode* ast_new_type_array(ASTNode* elem_type, int line, int col) {
-    ASTNode* n = ast_alloc(AST_TYPE_ARRAY, line, col);
+ASTNode* ast_new_type_array(ASTArena* a, ASTNode* elem_type, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_TYPE_ARRAY, line, col);
     n->as.type_array.elem_type = elem_type;
     ast_list_init(&n->as.type_array.dims);
     return n;
 }
 
 
-ASTNode* ast_new_assign(ASTNode* target, ASTNode* value, int line, int col) {
-    ASTNode* n = ast_alloc(AST_ASSIGN, line, col);
+ASTNode* ast_new_assign(ASTArena* a, ASTNode* target, ASTNode* value, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_ASSIGN, line, col);
     n->as.assign.target = target;
     n->as.assign.value = value;
     return n;
 }
 
-ASTNode* ast_new_if(ASTNode* cond, ASTNode* then_block, int line, int col) {
-    ASTNode* n = ast_alloc(AST_IF, line, col);
+ASTNode* ast_new_if(ASTArena* a, ASTNode* cond, ASTNode* then_block, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_IF, line, col);
     n->as.if_stmt.cond = cond;
     n->as.if_stmt.then_block = then_block;
     ast_list_init(&n->as.if_stmt.elif_conds);
@@ -160,16 +471,16 @@ ASTNode* ast_new_if(ASTNode* cond, ASTNode* then_block, int line, int col) {
     return n;
 }
 
-ASTNode* ast_new_while(ASTNode* cond, ASTNode* body, int line, int col) {
-    ASTNode* n = ast_alloc(AST_WHILE, line, col);
+ASTNode* ast_new_while(ASTArena* a, ASTNode* cond, ASTNode* body, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_WHILE, line, col);
     n->as.while_stmt.cond = cond;
     n->as.while_stmt.body = body;
     return n;
 }
 
-ASTNode* ast_new_for(const char* var, ASTNode* start, ASTNode* end, ASTNode* step, ASTNode* body, int line, int col) {
-    ASTNode* n = ast_alloc(AST_FOR, line, col);
-    n->as.for_stmt.var = sdup(var);
+ASTNode* ast_new_for(ASTArena* a, const char* var, ASTNode* start, ASTNode* end, ASTNode* step, ASTNode* body, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_FOR, line, col);
+    n->as.for_stmt.var = var;
     n->as.for_stmt.start = start;
     n->as.for_stmt.end = end;
     n->as.for_stmt.step = step;
@@ -177,121 +488,148 @@ ASTNode* ast_new_for(const char* var, ASTNode* start, ASTNode* end, ASTNode* ste
     return n;
 }
 
-ASTNode* ast_new_repeat(ASTNode* body, ASTNode* until_cond, int line, int col) {
-    ASTNode* n = ast_alloc(AST_REPEAT, line, col);
+ASTNode* ast_new_repeat(ASTArena* a, ASTNode* body, ASTNode* until_cond, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_REPEAT, line, col);
     n->as.repeat_stmt.body = body;
     n->as.repeat_stmt.until_cond = until_cond;
     return n;
 }
 
-ASTNode* ast_new_write(int line, int col) {
-    ASTNode* n = ast_alloc(AST_WRITE, line, col);
+ASTNode* ast_new_write(ASTArena* a, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_WRITE, line, col);
     ast_list_init(&n->as.write_stmt.args);
     return n;
 }
 
-ASTNode* ast_new_read(int line, int col) {
-    ASTNode* n = ast_alloc(AST_READ, line, col);
+ASTNode* ast_new_read(ASTArena* a, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_READ, line, col);
     ast_list_init(&n->as.read_stmt.targets);
     return n;
 }
 
-ASTNode* ast_new_return(ASTNode* value, int line, int col) {
-    ASTNode* n = ast_alloc(AST_RETURN, line, col);
+ASTNode* ast_new_return(ASTArena* a, ASTNode* value, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_RETURN, line, col);
     n->as.ret_stmt.value = value;
     return n;
 }
 
-ASTNode* ast_new_call_stmt(ASTNode* call_expr, int line, int col) {
-    ASTNode* n = ast_alloc(AST_CALL_STMT, line, col);
+ASTNode* ast_new_call_stmt(ASTArena* a, ASTNode* call_expr, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_CALL_STMT, line, col);
     n->as.call_stmt.call = call_expr;
     return n;
 }
 
-ASTNode* ast_new_break(int line, int col) {
-    return ast_alloc(AST_BREAK, line, col);
+ASTNode* ast_new_break(ASTArena* a, int line, int col) {
+    return ast_alloc(a, AST_BREAK, line, col);
 }
 
-ASTNode* ast_new_quit_for(int line, int col) {
-    return ast_alloc(AST_QUIT_FOR, line, col);
+ASTNode* ast_new_quit_for(ASTArena* a, int line, int col) {
+    return ast_alloc(a, AST_QUIT_FOR, line, col);
 }
 
-ASTNode* ast_new_switch(ASTNode* expr, int line, int col) {
-    ASTNode* n = ast_alloc(AST_SWITCH, line, col);
+ASTNode* ast_new_switch(ASTArena* a, ASTNode* expr, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_SWITCH, line, col);
     n->as.switch_stmt.expr = expr;
     ast_list_init(&n->as.switch_stmt.cases);
     n->as.switch_stmt.default_block = NULL;
     return n;
 }
 
-ASTNode* ast_new_case(int line, int col) {
-    ASTNode* n = ast_alloc(AST_CASE, line, col);
+ASTNode* ast_new_case(ASTArena* a, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_CASE, line, col);
     ast_list_init(&n->as.case_stmt.values);
     n->as.case_stmt.body = NULL;
     return n;
 }
 
-ASTNode* ast_new_binary(TokenType op, ASTNode* lhs, ASTNode* rhs, int line, int col) {
-    ASTNode* n = ast_alloc(AST_BINARY, line, col);
+ASTNode* ast_new_binary(ASTArena* a, TokenType op, ASTNode* lhs, ASTNode* rhs, int line, int col) {
+    CleNoeud cle = { AST_BINARY, (int)op, lhs, rhs, 0, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_BINARY, line, col);
     n->as.binary.op = op;
     n->as.binary.lhs = lhs;
     n->as.binary.rhs = rhs;
-    return n;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_unary(TokenType op, ASTNode* expr, int line, int col) {
-    ASTNode* n = ast_alloc(AST_UNARY, line, col);
+ASTNode* ast_new_unary(ASTArena* a, TokenType op, ASTNode* expr, int line, int col) {
+    CleNoeud cle = { AST_UNARY, (int)op, expr, NULL, 0, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_UNARY, line, col);
     n->as.unary.op = op;
     n->as.unary.expr = expr;
-    return n;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_lit_int(long long v, int line, int col) {
-    ASTNode* n = ast_alloc(AST_LITERAL_INT, line, col);
+ASTNode* ast_new_lit_int(ASTArena* a, long long v, int line, int col) {
+    CleNoeud cle = { AST_LITERAL_INT, 0, NULL, NULL, v, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_LITERAL_INT, line, col);
     n->as.lit_int.value = v;
-    return n;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_lit_real(const char* text, int line, int col) {
-    ASTNode* n = ast_alloc(AST_LITERAL_REAL, line, col);
-    n->as.lit_real.text = sdup(text);
-    return n;
+ASTNode* ast_new_lit_real(ASTArena* a, const char* text, int line, int col) {
+    CleNoeud cle = { AST_LITERAL_REAL, 0, NULL, NULL, 0, text, 0 };
+    ASTNode* n = text ? partage_trouver(a, &cle) : NULL;
+    if (n) return n;
+    n = ast_alloc(a, AST_LITERAL_REAL, line, col);
+    n->as.lit_real.text = arena_sdup(a, text);
+    return text ? partage_ajouter(a, &cle, n) : n;
 }
 
-ASTNode* ast_new_lit_string(const char* text, int line, int col) {
-    ASTNode* n = ast_alloc(AST_LITERAL_STRING, line, col);
-    n->as.lit_string.text = sdup(text);
-    return n;
+ASTNode* ast_new_lit_string(ASTArena* a, const char* text, int line, int col) {
+    CleNoeud cle = { AST_LITERAL_STRING, 0, NULL, NULL, 0, text, 0 };
+    ASTNode* n = text ? partage_trouver(a, &cle) : NULL;
+    if (n) return n;
+    n = ast_alloc(a, AST_LITERAL_STRING, line, col);
+    n->as.lit_string.text = arena_sdup(a, text);
+    return text ? partage_ajouter(a, &cle, n) : n;
 }
 
-ASTNode* ast_new_lit_bool(bool v, int line, int col) {
-    ASTNode* n = ast_alloc(AST_LITERAL_BOOL, line, col);
+ASTNode* ast_new_lit_bool(ASTArena* a, bool v, int line, int col) {
+    CleNoeud cle = { AST_LITERAL_BOOL, 0, NULL, NULL, v, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_LITERAL_BOOL, line, col);
     n->as.lit_bool.value = v;
-    return n;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_ident(const char* name, int line, int col) {
-    ASTNode* n = ast_alloc(AST_IDENT, line, col);
-    n->as.ident.name = sdup(name);
-    return n;
+ASTNode* ast_new_ident(ASTArena* a, const char* name, int line, int col) {
+    CleNoeud cle = { AST_IDENT, 0, name, NULL, 0, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_IDENT, line, col);
+    n->as.ident.name = name;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_index(ASTNode* base, ASTNode* index, int line, int col) {
-    ASTNode* n = ast_alloc(AST_INDEX, line, col);
+ASTNode* ast_new_index(ASTArena* a, ASTNode* base, ASTNode* index, int line, int col) {
+    CleNoeud cle = { AST_INDEX, 0, base, index, 0, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_INDEX, line, col);
     n->as.index.base = base;
     n->as.index.index = index;
-    return n;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_field_access(ASTNode* base, const char* field, int line, int col) {
-    ASTNode* n = ast_alloc(AST_FIELD_ACCESS, line, col);
+ASTNode* ast_new_field_access(ASTArena* a, ASTNode* base, const char* field, int line, int col) {
+    CleNoeud cle = { AST_FIELD_ACCESS, 0, base, field, 0, NULL, 0 };
+    ASTNode* n = partage_trouver(a, &cle);
+    if (n) return n;
+    n = ast_alloc(a, AST_FIELD_ACCESS, line, col);
     n->as.field_access.base = base;
-    n->as.field_access.field = sdup(field);
-    return n;
+    n->as.field_access.field = field;
+    return partage_ajouter(a, &cle, n);
 }
 
-ASTNode* ast_new_call(ASTNode* callee, int line, int col) {
-    ASTNode* n = ast_alloc(AST_CALL, line, col);
+ASTNode* ast_new_call(ASTArena* a, ASTNode* callee, int line, int col) {
+    ASTNode* n = ast_alloc(a, AST_CALL, line, col);
     n->as.call.callee = callee;
     ast_list_init(&n->as.call.args);
     return n;
@@ -299,199 +637,19 @@ ASTNode* ast_new_call(ASTNode* callee, int line, int col) {
 
 // Fonctions d'aide (ajout)
 
-void ast_block_add(ASTNode* block, ASTNode* stmt) {
+void ast_block_add(ASTArena* a, ASTNode* block, ASTNode* stmt) {
     if (!block || block->kind != AST_BLOCK) return;
-    ast_list_push(&block->as.block.stmts, stmt);
+    ast_list_push(a, &block->as.block.stmts, stmt);
 }
 
-void ast_program_add_decl(ASTNode* program, ASTNode* decl) {
+void ast_program_add_decl(ASTArena* a, ASTNode* program, ASTNode* decl) {
     if (!program || program->kind != AST_PROGRAM) return;
-    ast_list_push(&program->as.program.decls, decl);
+    ast_list_push(a, &program->as.program.decls, decl);
 }
 
-void ast_program_add_def(ASTNode* program, ASTNode* def) {
+void ast_program_add_def(ASTArena* a, ASTNode* program, ASTNode* def) {
     if (!program || program->kind != AST_PROGRAM) return;
-    ast_list_push(&program->as.program.defs, def);
-}
-
-// Libération mémoire
-
-static void ast_free_list(ASTList* list) {
-    for (int i = 0; i < list->count; i++) {
-        ast_free(list->items[i]);
-    }
-    ast_list_free_shallow(list);
-}
-
-void ast_free(ASTNode* node) {
-    if (!node) return;
-
-    switch (node->kind) {
-        case AST_PROGRAM:
-            free(node->as.program.name);
-            ast_free_list(&node->as.program.decls);
-            ast_free_list(&node->as.program.defs);
-            ast_free(node->as.program.main_block);
-            break;
-
-        case AST_DECL_VAR:
-            free(node->as.decl_var.name);
-            ast_free(node->as.decl_var.type);
-            break;
-
-        case AST_DECL_CONST:
-            free(node->as.decl_const.name);
-            ast_free(node->as.decl_const.type);
-            ast_free(node->as.decl_const.value);
-            break;
-
-        case AST_DECL_ARRAY:
-            free(node->as.decl_array.name);
-            ast_free(node->as.decl_array.elem_type);
-            ast_free_list(&node->as.decl_array.dims);
-            break;
-
-        case AST_TYPE_NAMED:
-            free(node->as.type_named.name);
-            break;
-
-        case AST_TYPE_ARRAY:
-           ast_free(node->as.type_array.elem_type);
-           ast_free_list(&node->as.type_array.dims);
-           break;
-
-
-        case AST_DEF_STRUCT:
-            free(node->as.def_struct.name);
-            ast_free_list(&node->as.def_struct.fields);
-            break;
-
-        case AST_FIELD:
-            free(node->as.field.name);
-            ast_free(node->as.field.type);
-            break;
-
-        case AST_DEF_FUNC:
-            free(node->as.def_func.name);
-            ast_free_list(&node->as.def_func.params);
-            ast_free(node->as.def_func.return_type);
-            ast_free(node->as.def_func.body);
-            break;
-
-        case AST_DEF_PROC:
-            free(node->as.def_proc.name);
-            ast_free_list(&node->as.def_proc.params);
-            ast_free(node->as.def_proc.body);
-            break;
-
-        case AST_PARAM:
-            free(node->as.param.name);
-            ast_free(node->as.param.type);
-            break;
-
-        case AST_BLOCK:
-            ast_free_list(&node->as.block.stmts);
-            break;
-
-        case AST_ASSIGN:
-            ast_free(node->as.assign.target);
-            ast_free(node->as.assign.value);
-            break;
-
-        case AST_IF:
-            ast_free(node->as.if_stmt.cond);
-            ast_free(node->as.if_stmt.then_block);
-            ast_free_list(&node->as.if_stmt.elif_conds);
-            ast_free_list(&node->as.if_stmt.elif_blocks);
-            ast_free(node->as.if_stmt.else_block);
-            break;
-
-        case AST_WHILE:
-            ast_free(node->as.while_stmt.cond);
-            ast_free(node->as.while_stmt.body);
-            break;
-
-        case AST_FOR:
-            free(node->as.for_stmt.var);
-            ast_free(node->as.for_stmt.start);
-            ast_free(node->as.for_stmt.end);
-            ast_free(node->as.for_stmt.step);
-            ast_free(node->as.for_stmt.body);
-            break;
-
-        case AST_REPEAT:
-            ast_free(node->as.repeat_stmt.body);
-            ast_free(node->as.repeat_stmt.until_cond);
-            break;
-
-        case AST_WRITE:
-            ast_free_list(&node->as.write_stmt.args);
-            break;
-
-        case AST_READ:
-            ast_free_list(&node->as.read_stmt.targets);
-            break;
-
-        case AST_RETURN:
-            ast_free(node->as.ret_stmt.value);
-            break;
-
-        case AST_CALL_STMT:
-            ast_free(node->as.call_stmt.call);
-            break;
-
-        case AST_SWITCH:
-            ast_free(node->as.switch_stmt.expr);
-            ast_free_list(&node->as.switch_stmt.cases);
-            ast_free(node->as.switch_stmt.default_block);
-            break;
-
-        case AST_CASE:
-            ast_free_list(&node->as.case_stmt.values);
-            ast_free(node->as.case_stmt.body);
-            break;
-
-        case AST_BINARY:
-            ast_free(node->as.binary.lhs);
-            ast_free(node->as.binary.rhs);
-            break;
-
-        case AST_UNARY:
-            ast_free(node->as.unary.expr);
-            break;
-
-        case AST_LITERAL_REAL:
-            free(node->as.lit_real.text);
-            break;
-
-        case AST_LITERAL_STRING:
-            free(node->as.lit_string.text);
-            break;
-
-        case AST_IDENT:
-            free(node->as.ident.name);
-            break;
-
-        case AST_INDEX:
-            ast_free(node->as.index.base);
-            ast_free(node->as.index.index);
-            break;
-
-        case AST_FIELD_ACCESS:
-            ast_free(node->as.field_access.base);
-            free(node->as.field_access.field);
-            break;
-
-        case AST_CALL:
-            ast_free(node->as.call.callee);
-            ast_free_list(&node->as.call.args);
-            break;
-
-        default:
-            break;
-    }
-
-    free(node);
+    ast_list_push(a, &program->as.program.defs, def);
 }
 
 // Affichage (simple)
@@ -509,8 +667,48 @@ static const char* prim_to_str(PrimitiveType p) {
     }
 }
 
-static void ast_print_rec(ASTNode* n, int ind) {
+// Affichage sans récursion : pile d'actions (nœud à afficher, ou
+// intitulé "TEXTE" / "TEXTE(nb)" à afficher), dépilées dans l'ordre.
+typedef struct {
+    ASTNode* noeud;
+    const char* texte;  // NULL : afficher noeud
+    int nb;             // < 0 : pas de "(nb)" après le texte
+    int ind;
+} ActionAffichage;
+
+typedef struct {
+    ActionAffichage* actions;
+    int nb;
+    int cap;
+} PileAffichage;
+
+static void empiler_action(PileAffichage* pile, ASTNode* n, const char* texte, int nb, int ind) {
+    if (pile->nb >= pile->cap) {
+        int ncap = (pile->cap == 0) ? 64 : pile->cap * 2;
+        ActionAffichage* na = (ActionAffichage*)realloc(pile->actions, (size_t)ncap * sizeof(ActionAffichage));
+        if (!na) return;
+        pile->actions = na;
+        pile->cap = ncap;
+    }
+    ActionAffichage* a = &pile->actions[pile->nb++];
+    a->noeud = n;
+    a->texte = texte;
+    a->nb = nb;
+    a->ind = ind;
+}
+
+static void empiler_affichage(PileAffichage* pile, ASTNode* n, int ind) {
+    empiler_action(pile, n, NULL, -1, ind);
+}
+
+static void empiler_texte(PileAffichage* pile, const char* texte, int nb, int ind) {
+    empiler_action(pile, NULL, texte, nb, ind);
+}
+
+// Affiche la ligne de n ; ce qui suit (enfants, intitulés) est empilé
+static void ast_print_noeud(ASTNode* n, int ind, PileAffichage* pile) {
     if (!n) { indent(ind); printf("(null)\n"); return; }
+    int debut = pile->nb;
 
     indent(ind);
     printf("[%d:%d] ", n->line, n->col);
@@ -518,30 +716,30 @@ static void ast_print_rec(ASTNode* n, int ind) {
     switch (n->kind) {
         case AST_PROGRAM:
             printf("PROGRAM %s\n", n->as.program.name ? n->as.program.name : "(noname)");
-            indent(ind+2); printf("DECLS(%d)\n", n->as.program.decls.count);
-            for (int i=0;i<n->as.program.decls.count;i++) ast_print_rec(n->as.program.decls.items[i], ind+4);
-            indent(ind+2); printf("DEFS(%d)\n", n->as.program.defs.count);
-            for (int i=0;i<n->as.program.defs.count;i++) ast_print_rec(n->as.program.defs.items[i], ind+4);
-            indent(ind+2); printf("MAIN\n");
-            ast_print_rec(n->as.program.main_block, ind+4);
+            empiler_texte(pile, "DECLS", n->as.program.decls.count, ind+2);
+            for (int i=0;i<n->as.program.decls.count;i++) empiler_affichage(pile, n->as.program.decls.items[i], ind+4);
+            empiler_texte(pile, "DEFS", n->as.program.defs.count, ind+2);
+            for (int i=0;i<n->as.program.defs.count;i++) empiler_affichage(pile, n->as.program.defs.items[i], ind+4);
+            empiler_texte(pile, "MAIN", -1, ind+2);
+            empiler_affichage(pile, n->as.program.main_block, ind+4);
             break;
 
         case AST_DECL_VAR:
             printf("DECL_VAR %s\n", n->as.decl_var.name);
-            ast_print_rec(n->as.decl_var.type, ind+2);
+            empiler_affichage(pile, n->as.decl_var.type, ind+2);
             break;
 
         case AST_DECL_CONST:
             printf("DECL_CONST %s\n", n->as.decl_const.name);
-            ast_print_rec(n->as.decl_const.type, ind+2);
-            ast_print_rec(n->as.decl_const.value, ind+2);
+            empiler_affichage(pile, n->as.decl_const.type, ind+2);
+            empiler_affichage(pile, n->as.decl_const.value, ind+2);
             break;
 
         case AST_DECL_ARRAY:
             printf("DECL_ARRAY %s\n", n->as.decl_array.name);
-            ast_print_rec(n->as.decl_array.elem_type, ind+2);
-            indent(ind+2); printf("DIMS(%d)\n", n->as.decl_array.dims.count);
-            for (int i=0;i<n->as.decl_array.dims.count;i++) ast_print_rec(n->as.decl_array.dims.items[i], ind+4);
+            empiler_affichage(pile, n->as.decl_array.elem_type, ind+2);
+            empiler_texte(pile, "DIMS", n->as.decl_array.dims.count, ind+2);
+            for (int i=0;i<n->as.decl_array.dims.count;i++) empiler_affichage(pile, n->as.decl_array.dims.items[i], ind+4);
             break;
 
         case AST_TYPE_PRIMITIVE:
@@ -554,121 +752,121 @@ static void ast_print_rec(ASTNode* n, int ind) {
 
         case AST_DEF_STRUCT:
             printf("STRUCT %s\n", n->as.def_struct.name);
-            for (int i=0;i<n->as.def_struct.fields.count;i++) ast_print_rec(n->as.def_struct.fields.items[i], ind+2);
+            for (int i=0;i<n->as.def_struct.fields.count;i++) empiler_affichage(pile, n->as.def_struct.fields.items[i], ind+2);
             break;
 
         case AST_FIELD:
             printf("FIELD %s\n", n->as.field.name);
-            ast_print_rec(n->as.field.type, ind+2);
+            empiler_affichage(pile, n->as.field.type, ind+2);
             break;
 
         case AST_DEF_FUNC:
             printf("FUNC %s\n", n->as.def_func.name);
-            indent(ind+2); printf("PARAMS(%d)\n", n->as.def_func.params.count);
-            for (int i=0;i<n->as.def_func.params.count;i++) ast_print_rec(n->as.def_func.params.items[i], ind+4);
-            indent(ind+2); printf("RET\n");
-            ast_print_rec(n->as.def_func.return_type, ind+4);
-            indent(ind+2); printf("BODY\n");
-            ast_print_rec(n->as.def_func.body, ind+4);
+            empiler_texte(pile, "PARAMS", n->as.def_func.params.count, ind+2);
+            for (int i=0;i<n->as.def_func.params.count;i++) empiler_affichage(pile, n->as.def_func.params.items[i], ind+4);
+            empiler_texte(pile, "RET", -1, ind+2);
+            empiler_affichage(pile, n->as.def_func.return_type, ind+4);
+            empiler_texte(pile, "BODY", -1, ind+2);
+            empiler_affichage(pile, n->as.def_func.body, ind+4);
             break;
 
         case AST_DEF_PROC:
             printf("PROC %s\n", n->as.def_proc.name);
-            indent(ind+2); printf("PARAMS(%d)\n", n->as.def_proc.params.count);
-            for (int i=0;i<n->as.def_proc.params.count;i++) ast_print_rec(n->as.def_proc.params.items[i], ind+4);
-            indent(ind+2); printf("BODY\n");
-            ast_print_rec(n->as.def_proc.body, ind+4);
+            empiler_texte(pile, "PARAMS", n->as.def_proc.params.count, ind+2);
+            for (int i=0;i<n->as.def_proc.params.count;i++) empiler_affichage(pile, n->as.def_proc.params.items[i], ind+4);
+            empiler_texte(pile, "BODY", -1, ind+2);
+            empiler_affichage(pile, n->as.def_proc.body, ind+4);
             break;
 
         case AST_PARAM:
             printf("PARAM %s\n", n->as.param.name);
-            ast_print_rec(n->as.param.type, ind+2);
+            empiler_affichage(pile, n->as.param.type, ind+2);
             break;
 
         case AST_BLOCK:
             printf("BLOCK(%d)\n", n->as.block.stmts.count);
-            for (int i=0;i<n->as.block.stmts.count;i++) ast_print_rec(n->as.block.stmts.items[i], ind+2);
+            for (int i=0;i<n->as.block.stmts.count;i++) empiler_affichage(pile, n->as.block.stmts.items[i], ind+2);
             break;
 
         case AST_ASSIGN:
             printf("ASSIGN\n");
-            ast_print_rec(n->as.assign.target, ind+2);
-            ast_print_rec(n->as.assign.value, ind+2);
+            empiler_affichage(pile, n->as.assign.target, ind+2);
+            empiler_affichage(pile, n->as.assign.value, ind+2);
             break;
 
         case AST_IF:
             printf("IF\n");
-            ast_print_rec(n->as.if_stmt.cond, ind+2);
-            ast_print_rec(n->as.if_stmt.then_block, ind+2);
+            empiler_affichage(pile, n->as.if_stmt.cond, ind+2);
+            empiler_affichage(pile, n->as.if_stmt.then_block, ind+2);
             for (int i=0;i<n->as.if_stmt.elif_conds.count;i++) {
-                indent(ind); printf("ELIF\n");
-                ast_print_rec(n->as.if_stmt.elif_conds.items[i], ind+2);
-                ast_print_rec(n->as.if_stmt.elif_blocks.items[i], ind+2);
+                empiler_texte(pile, "ELIF", -1, ind);
+                empiler_affichage(pile, n->as.if_stmt.elif_conds.items[i], ind+2);
+                empiler_affichage(pile, n->as.if_stmt.elif_blocks.items[i], ind+2);
             }
             if (n->as.if_stmt.else_block) {
-                indent(ind); printf("ELSE\n");
-                ast_print_rec(n->as.if_stmt.else_block, ind+2);
+                empiler_texte(pile, "ELSE", -1, ind);
+                empiler_affichage(pile, n->as.if_stmt.else_block, ind+2);
             }
             break;
         case AST_CALL_STMT:
             printf("CALL_STMT\n");
-            ast_print_rec(n->as.call_stmt.call, ind+2);
+            empiler_affichage(pile, n->as.call_stmt.call, ind+2);
             break;
 
         case AST_WHILE:
             printf("WHILE\n");
-            ast_print_rec(n->as.while_stmt.cond, ind+2);
-            ast_print_rec(n->as.while_stmt.body, ind+2);
+            empiler_affichage(pile, n->as.while_stmt.cond, ind+2);
+            empiler_affichage(pile, n->as.while_stmt.body, ind+2);
             break;
 
         case AST_FOR:
             printf("FOR %s\n", n->as.for_stmt.var);
-            ast_print_rec(n->as.for_stmt.start, ind+2);
-            ast_print_rec(n->as.for_stmt.end, ind+2);
-            if (n->as.for_stmt.step) ast_print_rec(n->as.for_stmt.step, ind+2);
-            ast_print_rec(n->as.for_stmt.body, ind+2);
+            empiler_affichage(pile, n->as.for_stmt.start, ind+2);
+            empiler_affichage(pile, n->as.for_stmt.end, ind+2);
+            if (n->as.for_stmt.step) empiler_affichage(pile, n->as.for_stmt.step, ind+2);
+            empiler_affichage(pile, n->as.for_stmt.body, ind+2);
             break;
 
         case AST_WRITE:
             printf("ECRIRE\n");
-            for (int i=0;i<n->as.write_stmt.args.count;i++) ast_print_rec(n->as.write_stmt.args.items[i], ind+2);
+            for (int i=0;i<n->as.write_stmt.args.count;i++) empiler_affichage(pile, n->as.write_stmt.args.items[i], ind+2);
             break;
 
         case AST_READ:
             printf("LIRE\n");
-            for (int i=0;i<n->as.read_stmt.targets.count;i++) ast_print_rec(n->as.read_stmt.targets.items[i], ind+2);
+            for (int i=0;i<n->as.read_stmt.targets.count;i++) empiler_affichage(pile, n->as.read_stmt.targets.items[i], ind+2);
             break;
 
         case AST_RETURN:
             printf("RETURN\n");
-            ast_print_rec(n->as.ret_stmt.value, ind+2);
+            empiler_affichage(pile, n->as.ret_stmt.value, ind+2);
             break;
 
         case AST_SWITCH:
             printf("SELON\n");
-            ast_print_rec(n->as.switch_stmt.expr, ind+2);
-            for (int i=0;i<n->as.switch_stmt.cases.count;i++) ast_print_rec(n->as.switch_stmt.cases.items[i], ind+2);
+            empiler_affichage(pile, n->as.switch_stmt.expr, ind+2);
+            for (int i=0;i<n->as.switch_stmt.cases.count;i++) empiler_affichage(pile, n->as.switch_stmt.cases.items[i], ind+2);
             if (n->as.switch_stmt.default_block) {
-                indent(ind+2); printf("DEFAUT\n");
-                ast_print_rec(n->as.switch_stmt.default_block, ind+4);
+                empiler_texte(pile, "DEFAUT", -1, ind+2);
+                empiler_affichage(pile, n->as.switch_stmt.default_block, ind+4);
             }
             break;
 
         case AST_CASE:
             printf("CAS values(%d)\n", n->as.case_stmt.values.count);
-            for (int i=0;i<n->as.case_stmt.values.count;i++) ast_print_rec(n->as.case_stmt.values.items[i], ind+2);
-            ast_print_rec(n->as.case_stmt.body, ind+2);
+            for (int i=0;i<n->as.case_stmt.values.count;i++) empiler_affichage(pile, n->as.case_stmt.values.items[i], ind+2);
+            empiler_affichage(pile, n->as.case_stmt.body, ind+2);
             break;
 
         case AST_BINARY:
             printf("BINOP %s\n", token_to_string(n->as.binary.op));
-            ast_print_rec(n->as.binary.lhs, ind+2);
-            ast_print_rec(n->as.binary.rhs, ind+2);
+            empiler_affichage(pile, n->as.binary.lhs, ind+2);
+            empiler_affichage(pile, n->as.binary.rhs, ind+2);
             break;
 
         case AST_UNARY:
             printf("UNARY %s\n", token_to_string(n->as.unary.op));
-            ast_print_rec(n->as.unary.expr, ind+2);
+            empiler_affichage(pile, n->as.unary.expr, ind+2);
             break;
 
         case AST_LITERAL_INT:
@@ -693,19 +891,19 @@ static void ast_print_rec(ASTNode* n, int ind) {
 
         case AST_INDEX:
             printf("INDEX\n");
-            ast_print_rec(n->as.index.base, ind+2);
-            ast_print_rec(n->as.index.index, ind+2);
+            empiler_affichage(pile, n->as.index.base, ind+2);
+            empiler_affichage(pile, n->as.index.index, ind+2);
             break;
 
         case AST_FIELD_ACCESS:
             printf("FIELD .%s\n", n->as.field_access.field);
-            ast_print_rec(n->as.field_access.base, ind+2);
+            empiler_affichage(pile, n->as.field_access.base, ind+2);
             break;
 
         case AST_CALL:
             printf("CALL\n");
-            ast_print_rec(n->as.call.callee, ind+2);
-            for (int i=0;i<n->as.call.args.count;i++) ast_print_rec(n->as.call.args.items[i], ind+2);
+            empiler_affichage(pile, n->as.call.callee, ind+2);
+            for (int i=0;i<n->as.call.args.count;i++) empiler_affichage(pile, n->as.call.args.items[i], ind+2);
             break;
 
         case AST_BREAK:
@@ -720,8 +918,168 @@ static void ast_print_rec(ASTNode* n, int ind) {
             printf("NODE kind=%d\n", (int)n->kind);
             break;
     }
+
+    // Empilés dans l'ordre d'affichage : on inverse pour dépiler dans cet ordre
+    for (int i = debut, j = pile->nb - 1; i < j; i++, j--) {
+        ActionAffichage t = pile->actions[i];
+        pile->actions[i] = pile->actions[j];
+        pile->actions[j] = t;
+    }
 }
 
 void ast_print(ASTNode* node) {
-    ast_print_rec(node, 0);
+    PileAffichage pile = { NULL, 0, 0 };
+    empiler_affichage(&pile, node, 0);
+
+    while (pile.nb > 0) {
+        ActionAffichage a = pile.actions[--pile.nb];
+        if (a.texte) {
+            indent(a.ind);
+            if (a.nb >= 0) printf("%s(%d)\n", a.texte, a.nb);
+            else printf("%s\n", a.texte);
+        } else {
+            ast_print_noeud(a.noeud, a.ind, &pile);
+        }
+    }
+    free(pile.actions);
+}
+
+// Schéma et parcours
+
+#define ENFANT_NOEUD(champ) { AST_ENFANT_NOEUD, offsetof(ASTNode, as.champ) },
+#define ENFANT_LISTE(champ) { AST_ENFANT_LISTE, offsetof(ASTNode, as.champ) },
+#define ENFANTS_TYPE(kind, champs) \
+    static const ASTEnfant enfants_##kind[] = { champs { AST_ENFANT_FIN, 0 } };
+#define ENTREE_TYPE(kind, champs) [kind] = enfants_##kind,
+
+AST_SCHEMA(ENFANTS_TYPE, ENFANT_NOEUD, ENFANT_LISTE)
+
+const ASTEnfant* const AST_ENFANTS[] = {
+    AST_SCHEMA(ENTREE_TYPE, ENFANT_NOEUD, ENFANT_LISTE)
+};
+
+#undef ENFANT_NOEUD
+#undef ENFANT_LISTE
+#undef ENFANTS_TYPE
+#undef ENTREE_TYPE
+
+typedef struct {
+    ASTNode* noeud;
+    const ASTEnfant* champ;  // champ en cours
+    int i;                   // indice dans la liste en cours
+    uint32_t actifs;         // visiteurs entrés dans le nœud
+    uint32_t descente;       // visiteurs qui parcourent ses enfants
+} CadreParcours;
+
+// Enfant suivant du cadre (NULL : plus d'enfant)
+static ASTNode* enfant_suivant(CadreParcours* c) {
+    while (c->champ->genre != AST_ENFANT_FIN) {
+        char* champ = (char*)c->noeud + c->champ->offset;
+
+        if (c->champ->genre == AST_ENFANT_NOEUD) {
+            c->champ++;
+            ASTNode* e = *(ASTNode**)champ;
+            if (e) return e;
+            continue;
+        }
+
+        ASTList* l = (ASTList*)champ;
+        while (c->i < l->count) {
+            ASTNode* e = l->items[c->i++];
+            if (e) return e;
+        }
+        c->champ++;
+        c->i = 0;
+    }
+    return NULL;
+}
+
+void ast_parcourir(ASTNode* racine, const ASTVisiteur* visiteurs, int nb) {
+    if (!racine || nb <= 0) return;
+    if (nb > AST_VISITEURS_MAX) nb = AST_VISITEURS_MAX;
+
+    CadreParcours* pile = NULL;
+    int hauteur = 0, cap = 0;
+    uint32_t tous = (nb == 32) ? 0xFFFFFFFFu : ((1u << nb) - 1);
+
+    ASTNode* n = racine;
+    uint32_t actifs = tous;
+    while (true) {
+        // Entrée dans n
+        if (n) {
+            if (hauteur >= cap) {
+                int ncap = (cap == 0) ? 64 : cap * 2;
+                CadreParcours* np = (CadreParcours*)realloc(pile, (size_t)ncap * sizeof(CadreParcours));
+                if (!np) {
+                    fprintf(stderr, "Erreur d'allocation mémoire (parcours de l'AST)\n");
+                    abort();
+                }
+                pile = np;
+                cap = ncap;
+            }
+            CadreParcours* c = &pile[hauteur++];
+            c->noeud = n;
+            c->champ = AST_ENFANTS[n->kind];
+            c->i = 0;
+            c->actifs = actifs;
+            c->descente = 0;
+            for (int v = 0; v < nb; v++) {
+                if (!(actifs & (1u << v))) continue;
+                if (!visiteurs[v].avant || visiteurs[v].avant(n, visiteurs[v].ctx)) {
+                    c->descente |= 1u << v;
+                }
+            }
+        }
+        if (hauteur == 0) break;
+
+        CadreParcours* c = &pile[hauteur - 1];
+        n = c->descente ? enfant_suivant(c) : NULL;
+        if (n) {
+            actifs = c->descente;
+            continue;
+        }
+
+        // Sortie du nœud au sommet
+        for (int v = 0; v < nb; v++) {
+            if ((c->actifs & (1u << v)) && visiteurs[v].apres) {
+                visiteurs[v].apres(c->noeud, visiteurs[v].ctx);
+            }
+        }
+        hauteur--;
+    }
+    free(pile);
+}
+
+// Deux analyses indépendantes, un seul parcours
+
+typedef struct { int nb; } CompteNoeuds;
+typedef struct { int courante; int max; } Profondeur;
+
+static bool compter_noeud(ASTNode* n, void* ctx) {
+    (void)n;
+    ((CompteNoeuds*)ctx)->nb++;
+    return true;
+}
+
+static bool entrer_profondeur(ASTNode* n, void* ctx) {
+    (void)n;
+    Profondeur* p = (Profondeur*)ctx;
+    if (++p->courante > p->max) p->max = p->courante;
+    return true;
+}
+
+static void sortir_profondeur(ASTNode* n, void* ctx) {
+    (void)n;
+    ((Profondeur*)ctx)->courante--;
+}
+
+void ast_afficher_forme(ASTNode* racine) {
+    CompteNoeuds compte = { 0 };
+    Profondeur profondeur = { 0, 0 };
+    ASTVisiteur visiteurs[] = {
+        { compter_noeud, NULL, &compte },
+        { entrer_profondeur, sortir_profondeur, &profondeur },
+    };
+    ast_parcourir(racine, visiteurs, 2);
+    printf("Arbre : %d noeuds atteignables, profondeur %d\n", compte.nb, profondeur.max);
 }
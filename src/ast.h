@@ -2,6 +2,7 @@
 #define AST_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "token.h"
 
 // AST Types
@@ -71,6 +72,7 @@ typedef enum {
 } PrimitiveType;
 
 typedef struct ASTNode ASTNode;
+struct Type;   // semantique.h
 
 // Simple list container
 typedef struct {
@@ -79,6 +81,18 @@ typedef struct {
     int cap;
 } ASTList;
 
+// Un nœud n'est alloué que jusqu'au membre de `as` qui correspond à son
+// kind (voir ast_alloc) : ne lire que ce membre, ne pas copier un ASTNode
+// par valeur.
+//
+// Les noms (name, var, field) sont des chaînes internées (intern.h) :
+// les comparer par pointeur. Les constructeurs les reçoivent déjà
+// internés et ne les copient pas.
+//
+// Annotations posées par l'analyse sémantique et lues par les
+// générateurs : `type` (type canonique, voir semantique.h) sur chaque
+// expression, `ident.decl` (nœud de déclaration : AST_DECL_*, AST_PARAM,
+// AST_DEF_*) sur chaque identificateur résolu. NULL avant l'analyse.
 struct ASTNode {
     ASTKind kind;
 
@@ -86,10 +100,12 @@ struct ASTNode {
     int line;
     int col;
 
+    struct Type* type;
+
     union {
         // PROGRAM: name + decls + defs + main_block
         struct {
-            char* name;
+            const char* name;
             ASTList decls;   // AST_DECL_*
             ASTList defs;    // AST_DEF_*
             ASTNode* main_block; // AST_BLOCK
@@ -97,20 +113,20 @@ struct ASTNode {
 
         // DECL_VAR: name + type
         struct {
-            char* name;
+            const char* name;
             ASTNode* type; // AST_TYPE_*
         } decl_var;
 
         // DECL_CONST: name + type + value (expr)
         struct {
-            char* name;
+            const char* name;
             ASTNode* type;   // AST_TYPE_*
             ASTNode* value;  // expression
         } decl_const;
 
         // DECL_ARRAY: name + elem_type + dims (expressions)
         struct {
-            char* name;
+            const char* name;
             ASTNode* elem_type; // AST_TYPE_*
             ASTList dims;       // expressions (usually const)
         } decl_array;
@@ -122,18 +138,18 @@ struct ASTNode {
 
         // TYPE_NAMED
         struct {
-            char* name;
+            const char* name;
         } type_named;
 
         // STRUCT: name + fields (AST_FIELD)
         struct {
-            char* name;
+            const char* name;
             ASTList fields; // AST_FIELD
         } def_struct;
 
         // FUNC: name + params + return_type + body
         struct {
-            char* name;
+            const char* name;
             ASTList params;      // AST_PARAM
             ASTNode* return_type; // AST_TYPE_*
             ASTNode* body;       // AST_BLOCK
@@ -141,14 +157,14 @@ struct ASTNode {
 
         // PROC: name + params + body
         struct {
-            char* name;
+            const char* name;
             ASTList params; // AST_PARAM
             ASTNode* body;  // AST_BLOCK
         } def_proc;
 
         // PARAM: name + type
         struct {
-            char* name;
+            const char* name;
             ASTNode* type; // AST_TYPE_*
         } param;
 
@@ -161,7 +177,7 @@ struct ASTNode {
 
         // FIELD: name + type
         struct {
-            char* name;
+            const char* name;
             ASTNode* type; // AST_TYPE_*
         } field;
 
@@ -193,7 +209,7 @@ struct ASTNode {
 
         // FOR: var name + start expr + end expr + step expr? + body
         struct {
-            char* var;
+            const char* var;
             ASTNode* start;
             ASTNode* end;
             ASTNode* step; // may be NULL
@@ -259,7 +275,7 @@ struct ASTNode {
         struct { bool value; } lit_bool;
 
         // IDENT
-        struct { char* name; } ident;
+        struct { const char* name; ASTNode* decl; } ident;
 
         // INDEX: base + index
         struct {
@@ -270,7 +286,7 @@ struct ASTNode {
         // FIELD_ACCESS: base + field
         struct {
             ASTNode* base;
-            char* field;
+            const char* field;
         } field_access;
 
         // CALL: callee + args
@@ -281,75 +297,207 @@ struct ASTNode {
     } as;
 };
 
+// =====================
+// Arena
+// =====================
+// Nœuds, textes des littéraux et tableaux des ASTList sont alloués
+// par avancée de pointeur dans des blocs chaînés ; tout l'arbre est
+// libéré d'un coup par ast_arena_liberer(), en O(blocs).
+typedef struct ASTArenaBloc ASTArenaBloc;
+typedef struct ASTPartage ASTPartage;
+
+typedef struct {
+    ASTArenaBloc* blocs;   // bloc courant en tête
+    char* courant;         // prochain octet libre du bloc courant
+    char* fin;
+
+    // Statistiques (dimensionnement)
+    int nb_blocs;
+    size_t octets_reserves;  // taille totale des blocs
+    size_t octets_utilises;  // alloués, alignement compris
+    size_t octets_noeuds;
+    size_t octets_chaines;
+    size_t octets_listes;    // tableaux des ASTList (anciens compris)
+    int nb_noeuds;
+
+    // Partage des sous-expressions identiques (NULL : désactivé)
+    ASTPartage* partage;
+    int nb_reutilises;       // constructions servies par un nœud existant
+    size_t octets_evites;
+} ASTArena;
+
+void ast_arena_init(ASTArena* a);
+void ast_arena_liberer(ASTArena* a);
+void ast_arena_afficher_stats(const ASTArena* a);
+
+// Les blocs de b (arena d'un autre thread) passent à a ; b est vidé
+void ast_arena_absorber(ASTArena* a, ASTArena* b);
+
+// Partage (hash-consing) des expressions pures : ast_new_binary, _unary,
+// _index, _field_access, _ident et les littéraux rendent le nœud déjà
+// construit s'il est structurellement identique (enfants comparés par
+// pointeur, puisqu'ils sont eux-mêmes partagés). Un nœud partagé garde la
+// position de sa première occurrence. Les nœuds ne sont jamais libérés un
+// par un : l'arena libère tout d'un coup, quel que soit le nombre de
+// références.
+void ast_arena_partager(ASTArena* a);
+// Oublie les nœuds déjà vus : le parser ouvre une portée par définition,
+// après les paramètres et chaque déclaration locale, et pour le bloc
+// principal (un même nom y désigne un même symbole)
+void ast_partage_nouvelle_portee(ASTArena* a);
+
+// Copie des n octets de s, terminée par '\0'
+char* ast_arena_texte(ASTArena* a, const char* s, size_t n);
+
 // =====================
 // List helpers
 // =====================
 void ast_list_init(ASTList* list);
-void ast_list_push(ASTList* list, ASTNode* node);
-void ast_list_free_shallow(ASTList* list);
+void ast_list_push(ASTArena* a, ASTList* list, ASTNode* node);
 
 // =====================
 // Node constructors
 // =====================
-ASTNode* ast_new_program(const char* name, int line, int col);
-ASTNode* ast_new_block(int line, int col);
+// Nœud de ce type, champs à zéro (rechargement du cache, cache_ast.c)
+ASTNode* ast_new_node(ASTArena* a, ASTKind kind, int line, int col);
 
-ASTNode* ast_new_type_primitive(PrimitiveType prim, int line, int col);
-ASTNode* ast_new_type_named(const char* name, int line, int col);
-ASTNode* ast_new_type_array(ASTNode* elem_type, int line, int col);
+ASTNode* ast_new_program(ASTArena* a, const char* name, int line, int col);
+ASTNode* ast_new_block(ASTArena* a, int line, int col);
 
+ASTNode* ast_new_type_primitive(ASTArena* a, PrimitiveType prim, int line, int col);
+ASTNode* ast_new_type_named(ASTArena* a, const char* name, int line, int col);
+ASTNode* ast_new_type_array(ASTArena* a, ASTNode* elem_type, int line, int col);
 
-ASTNode* ast_new_decl_var(const char* name, ASTNode* type, int line, int col);
-ASTNode* ast_new_decl_const(const char* name, ASTNode* type, ASTNode* value, int line, int col);
-ASTNode* ast_new_decl_array(const char* name, ASTNode* elem_type, int line, int col);
 
-ASTNode* ast_new_def_struct(const char* name, int line, int col);
-ASTNode* ast_new_field(const char* name, ASTNode* type, int line, int col);
+ASTNode* ast_new_decl_var(ASTArena* a, const char* name, ASTNode* type, int line, int col);
+ASTNode* ast_new_decl_const(ASTArena* a, const char* name, ASTNode* type, ASTNode* value, int line, int col);
+ASTNode* ast_new_decl_array(ASTArena* a, const char* name, ASTNode* elem_type, int line, int col);
 
-ASTNode* ast_new_def_func(const char* name, ASTNode* return_type, int line, int col);
-ASTNode* ast_new_def_proc(const char* name, int line, int col);
-ASTNode* ast_new_param(const char* name, ASTNode* type, int line, int col);
+ASTNode* ast_new_def_struct(ASTArena* a, const char* name, int line, int col);
+ASTNode* ast_new_field(ASTArena* a, const char* name, ASTNode* type, int line, int col);
 
-ASTNode* ast_new_assign(ASTNode* target, ASTNode* value, int line, int col);
-ASTNode* ast_new_if(ASTNode* cond, ASTNode* then_block, int line, int col);
-ASTNode* ast_new_while(ASTNode* cond, ASTNode* body, int line, int col);
-ASTNode* ast_new_for(const char* var, ASTNode* start, ASTNode* end, ASTNode* step, ASTNode* body, int line, int col);
-ASTNode* ast_new_repeat(ASTNode* body, ASTNode* until_cond, int line, int col);
+ASTNode* ast_new_def_func(ASTArena* a, const char* name, ASTNode* return_type, int line, int col);
+ASTNode* ast_new_def_proc(ASTArena* a, const char* name, int line, int col);
+ASTNode* ast_new_param(ASTArena* a, const char* name, ASTNode* type, int line, int col);
 
-ASTNode* ast_new_write(int line, int col);
-ASTNode* ast_new_read(int line, int col);
-ASTNode* ast_new_return(ASTNode* value, int line, int col);
-ASTNode* ast_new_call_stmt(ASTNode* call_expr, int line, int col);
-ASTNode* ast_new_break(int line, int col);
-ASTNode* ast_new_quit_for(int line, int col);
+ASTNode* ast_new_assign(ASTArena* a, ASTNode* target, ASTNode* value, int line, int col);
+ASTNode* ast_new_if(ASTArena* a, ASTNode* cond, ASTNode* then_block, int line, int col);
+ASTNode* ast_new_while(ASTArena* a, ASTNode* cond, ASTNode* body, int line, int col);
+ASTNode* ast_new_for(ASTArena* a, const char* var, ASTNode* start, ASTNode* end, ASTNode* step, ASTNode* body, int line, int col);
+ASTNode* ast_new_repeat(ASTArena* a, ASTNode* body, ASTNode* until_cond, int line, int col);
 
-ASTNode* ast_new_switch(ASTNode* expr, int line, int col);
-ASTNode* ast_new_case(int line, int col);
+ASTNode* ast_new_write(ASTArena* a, int line, int col);
+ASTNode* ast_new_read(ASTArena* a, int line, int col);
+ASTNode* ast_new_return(ASTArena* a, ASTNode* value, int line, int col);
+ASTNode* ast_new_call_stmt(ASTArena* a, ASTNode* call_expr, int line, int col);
+ASTNode* ast_new_break(ASTArena* a, int line, int col);
+ASTNode* ast_new_quit_for(ASTArena* a, int line, int col);
 
-ASTNode* ast_new_binary(TokenType op, ASTNode* lhs, ASTNode* rhs, int line, int col);
-ASTNode* ast_new_unary(TokenType op, ASTNode* expr, int line, int col);
+ASTNode* ast_new_switch(ASTArena* a, ASTNode* expr, int line, int col);
+ASTNode* ast_new_case(ASTArena* a, int line, int col);
 
-ASTNode* ast_new_lit_int(long long v, int line, int col);
-ASTNode* ast_new_lit_real(const char* text, int line, int col);
-ASTNode* ast_new_lit_string(const char* text, int line, int col);
-ASTNode* ast_new_lit_bool(bool v, int line, int col);
+ASTNode* ast_new_binary(ASTArena* a, TokenType op, ASTNode* lhs, ASTNode* rhs, int line, int col);
+ASTNode* ast_new_unary(ASTArena* a, TokenType op, ASTNode* expr, int line, int col);
 
-ASTNode* ast_new_ident(const char* name, int line, int col);
+ASTNode* ast_new_lit_int(ASTArena* a, long long v, int line, int col);
+ASTNode* ast_new_lit_real(ASTArena* a, const char* text, int line, int col);
+ASTNode* ast_new_lit_string(ASTArena* a, const char* text, int line, int col);
+ASTNode* ast_new_lit_bool(ASTArena* a, bool v, int line, int col);
 
-ASTNode* ast_new_index(ASTNode* base, ASTNode* index, int line, int col);
-ASTNode* ast_new_field_access(ASTNode* base, const char* field, int line, int col);
-ASTNode* ast_new_call(ASTNode* callee, int line, int col);
+ASTNode* ast_new_ident(ASTArena* a, const char* name, int line, int col);
+
+ASTNode* ast_new_index(ASTArena* a, ASTNode* base, ASTNode* index, int line, int col);
+ASTNode* ast_new_field_access(ASTArena* a, ASTNode* base, const char* field, int line, int col);
+ASTNode* ast_new_call(ASTArena* a, ASTNode* callee, int line, int col);
 
 // =====================
 // Utilities
 // =====================
-void ast_block_add(ASTNode* block, ASTNode* stmt);
-void ast_program_add_decl(ASTNode* program, ASTNode* decl);
-void ast_program_add_def(ASTNode* program, ASTNode* def);
-
-void ast_free(ASTNode* node);
+void ast_block_add(ASTArena* a, ASTNode* block, ASTNode* stmt);
+void ast_program_add_decl(ASTArena* a, ASTNode* program, ASTNode* decl);
+void ast_program_add_def(ASTArena* a, ASTNode* program, ASTNode* def);
 
 // Optional pretty print
 void ast_print(ASTNode* node);
 
+// =====================
+// Schéma et parcours
+// =====================
+// Enfants de chaque type de nœud, dans l'ordre des champs : N(champ) pour
+// un ASTNode* (peut être NULL), L(champ) pour une ASTList. C'est la seule
+// description de la forme de l'arbre : les tables de ast.c et le parcours
+// générique en sont tirés. Tenir à jour avec l'union de ASTNode.
+#define AST_SCHEMA(X, N, L) \
+    X(AST_PROGRAM,        L(program.decls) L(program.defs) N(program.main_block)) \
+    X(AST_DECL_VAR,       N(decl_var.type)) \
+    X(AST_DECL_CONST,     N(decl_const.type) N(decl_const.value)) \
+    X(AST_DECL_ARRAY,     N(decl_array.elem_type) L(decl_array.dims)) \
+    X(AST_TYPE_ARRAY,     N(type_array.elem_type) L(type_array.dims)) \
+    X(AST_TYPE_PRIMITIVE, ) \
+    X(AST_TYPE_NAMED,     ) \
+    X(AST_DEF_STRUCT,     L(def_struct.fields)) \
+    X(AST_DEF_FUNC,       L(def_func.params) N(def_func.return_type) N(def_func.body)) \
+    X(AST_DEF_PROC,       L(def_proc.params) N(def_proc.body)) \
+    X(AST_PARAM,          N(param.type)) \
+    X(AST_FIELD,          N(field.type)) \
+    X(AST_BLOCK,          L(block.stmts)) \
+    X(AST_ASSIGN,         N(assign.target) N(assign.value)) \
+    X(AST_IF,             N(if_stmt.cond) N(if_stmt.then_block) L(if_stmt.elif_conds) \
+                          L(if_stmt.elif_blocks) N(if_stmt.else_block)) \
+    X(AST_WHILE,          N(while_stmt.cond) N(while_stmt.body)) \
+    X(AST_FOR,            N(for_stmt.start) N(for_stmt.end) N(for_stmt.step) N(for_stmt.body)) \
+    X(AST_REPEAT,         N(repeat_stmt.body) N(repeat_stmt.until_cond)) \
+    X(AST_CALL_STMT,      N(call_stmt.call)) \
+    X(AST_RETURN,         N(ret_stmt.value)) \
+    X(AST_WRITE,          L(write_stmt.args)) \
+    X(AST_READ,           L(read_stmt.targets)) \
+    X(AST_BREAK,          ) \
+    X(AST_QUIT_FOR,       ) \
+    X(AST_SWITCH,         N(switch_stmt.expr) L(switch_stmt.cases) N(switch_stmt.default_block)) \
+    X(AST_CASE,           L(case_stmt.values) N(case_stmt.body)) \
+    X(AST_BINARY,         N(binary.lhs) N(binary.rhs)) \
+    X(AST_UNARY,          N(unary.expr)) \
+    X(AST_LITERAL_INT,    ) \
+    X(AST_LITERAL_REAL,   ) \
+    X(AST_LITERAL_STRING, ) \
+    X(AST_LITERAL_BOOL,   ) \
+    X(AST_IDENT,          ) \
+    X(AST_INDEX,          N(index.base) N(index.index)) \
+    X(AST_FIELD_ACCESS,   N(field_access.base)) \
+    X(AST_CALL,           N(call.callee) L(call.args))
+
+typedef enum {
+    AST_ENFANT_FIN,
+    AST_ENFANT_NOEUD,
+    AST_ENFANT_LISTE
+} ASTGenreEnfant;
+
+typedef struct {
+    ASTGenreEnfant genre;
+    size_t offset;          // du champ dans ASTNode
+} ASTEnfant;
+
+// Champs enfants par type (ASTKind), terminés par AST_ENFANT_FIN
+extern const ASTEnfant* const AST_ENFANTS[];
+
+// Visiteur : avant() à l'entrée d'un nœud (false : ne pas descendre dans
+// ses enfants pour ce visiteur), apres() à la sortie. L'un ou l'autre
+// peut être NULL.
+typedef struct {
+    bool (*avant)(ASTNode* n, void* ctx);
+    void (*apres)(ASTNode* n, void* ctx);
+    void* ctx;
+} ASTVisiteur;
+
+#define AST_VISITEURS_MAX 32
+
+// Parcours en profondeur, enfants dans l'ordre du schéma (les enfants
+// NULL sont sautés), sans récursion. Plusieurs visiteurs indépendants
+// partagent un seul parcours : en chaque nœud, leurs avant() puis, à la
+// sortie, leurs apres() sont appelés dans l'ordre du tableau.
+void ast_parcourir(ASTNode* racine, const ASTVisiteur* visiteurs, int nb);
+
+// Nœuds atteignables et profondeur de l'arbre (option --stats)
+void ast_afficher_forme(ASTNode* racine);
+
 #endif
@@ -0,0 +1,578 @@
+#include "cache_ast.h"
+#include "source.h"
+#include "intern.h"
+#include "token.h"
+#include "semantique.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char MAGIQUE[8] = { 'A', 'L', 'G', 'O', 'A', 'S', 'T', '\0' };
+
+#define TAILLE_ENTETE (8 + 4 + 4 + 8 + 8)
+#define CHAINE_NULLE 0xFFFFFFFFu
+#define TYPE_NUL 0xFF
+#define TYPE_PROFONDEUR_MAX 8
+
+// FNV-1a 64 bits
+uint64_t cache_ast_hacher(const char* source, size_t longueur) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < longueur; i++) {
+        h ^= (unsigned char)source[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+char* cache_ast_chemin(const char* chemin_source) {
+    size_t n = strlen(chemin_source);
+    char* r = (char*)malloc(n + sizeof(".algoast"));
+    if (!r) return NULL;
+    memcpy(r, chemin_source, n + 1);
+    if (n >= 5 && strcmp(chemin_source + n - 5, ".algo") == 0) strcat(r, "ast");
+    else strcat(r, ".algoast");
+    return r;
+}
+
+// Indices des nœuds (écriture) : table ouverte pointeur -> indice
+
+typedef struct {
+    ASTNode** cles;
+    uint32_t* indices;
+    uint32_t cap;       // puissance de 2
+    uint32_t nb;
+} TableIndices;
+
+static uint32_t hacher_pointeur(const ASTNode* n, uint32_t cap) {
+    uint64_t v = (uint64_t)(uintptr_t)n;
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdull;
+    v ^= v >> 33;
+    return (uint32_t)v & (cap - 1);
+}
+
+static bool table_agrandir(TableIndices* t) {
+    uint32_t ncap = (t->cap == 0) ? 1024 : t->cap * 2;
+    ASTNode** cles = (ASTNode**)calloc(ncap, sizeof(ASTNode*));
+    uint32_t* indices = (uint32_t*)malloc((size_t)ncap * sizeof(uint32_t));
+    if (!cles || !indices) { free(cles); free(indices); return false; }
+
+    for (uint32_t i = 0; i < t->cap; i++) {
+        if (!t->cles[i]) continue;
+        uint32_t j = hacher_pointeur(t->cles[i], ncap);
+        while (cles[j]) j = (j + 1) & (ncap - 1);
+        cles[j] = t->cles[i];
+        indices[j] = t->indices[i];
+    }
+    free(t->cles);
+    free(t->indices);
+    t->cles = cles;
+    t->indices = indices;
+    t->cap = ncap;
+    return true;
+}
+
+// Indice de n, ou ~0 s'il n'est pas encore dans la table
+static uint32_t table_indice(const TableIndices* t, const ASTNode* n) {
+    if (t->cap == 0) return ~0u;
+    uint32_t i = hacher_pointeur(n, t->cap);
+    while (t->cles[i]) {
+        if (t->cles[i] == n) return t->indices[i];
+        i = (i + 1) & (t->cap - 1);
+    }
+    return ~0u;
+}
+
+static bool table_ajouter(TableIndices* t, ASTNode* n, uint32_t indice) {
+    if ((t->nb + 1) * 2 > t->cap && !table_agrandir(t)) return false;
+    uint32_t i = hacher_pointeur(n, t->cap);
+    while (t->cles[i]) i = (i + 1) & (t->cap - 1);
+    t->cles[i] = n;
+    t->indices[i] = indice;
+    t->nb++;
+    return true;
+}
+
+// Parcours des champs
+//
+// champs() décrit, pour chaque type de nœud, ses champs dans l'ordre du
+// format. Le même parcours sert à écrire et à relire, selon le mode. Les
+// nœuds sont numérotés au préalable par un parcours de l'arbre
+// (ast_parcourir).
+
+typedef enum { ECRIRE, LIRE } ModeSerial;
+
+typedef struct {
+    ModeSerial mode;
+    bool ok;
+
+    // ECRIRE
+    TableIndices table;
+    ASTNode** noeuds;       // par indice
+    uint32_t nb_noeuds;
+    uint32_t cap_noeuds;
+    unsigned char* tampon;
+    size_t taille;
+    size_t cap_tampon;
+
+    // LIRE
+    const unsigned char* p;
+    const unsigned char* fin;
+    ASTNode** lus;          // par indice
+    ASTArena* arena;
+} Serial;
+
+static void ecrire(Serial* s, const void* octets, size_t n) {
+    if (!s->ok) return;
+    if (s->taille + n > s->cap_tampon) {
+        size_t ncap = (s->cap_tampon == 0) ? 64 * 1024 : s->cap_tampon * 2;
+        while (ncap < s->taille + n) ncap *= 2;
+        unsigned char* t = (unsigned char*)realloc(s->tampon, ncap);
+        if (!t) { s->ok = false; return; }
+        s->tampon = t;
+        s->cap_tampon = ncap;
+    }
+    memcpy(s->tampon + s->taille, octets, n);
+    s->taille += n;
+}
+
+static void lire(Serial* s, void* octets, size_t n) {
+    if (!s->ok || (size_t)(s->fin - s->p) < n) { s->ok = false; memset(octets, 0, n); return; }
+    memcpy(octets, s->p, n);
+    s->p += n;
+}
+
+static void ecrire_u32(Serial* s, uint32_t v) { ecrire(s, &v, sizeof(v)); }
+static uint32_t lire_u32(Serial* s) { uint32_t v; lire(s, &v, sizeof(v)); return v; }
+
+// Visiteur : nouveau nœud, indice suivant (un nœud déjà numéroté n'est
+// pas reparcouru)
+static bool numeroter(ASTNode* n, void* ctx) {
+    Serial* s = (Serial*)ctx;
+    if (!s->ok || table_indice(&s->table, n) != ~0u) return false;
+    if (s->nb_noeuds >= s->cap_noeuds) {
+        uint32_t ncap = (s->cap_noeuds == 0) ? 1024 : s->cap_noeuds * 2;
+        ASTNode** t = (ASTNode**)realloc(s->noeuds, (size_t)ncap * sizeof(ASTNode*));
+        if (!t) { s->ok = false; return false; }
+        s->noeuds = t;
+        s->cap_noeuds = ncap;
+    }
+    if (!table_ajouter(&s->table, n, s->nb_noeuds)) { s->ok = false; return false; }
+    s->noeuds[s->nb_noeuds++] = n;
+    return true;
+}
+
+static ASTNode* lire_reference(Serial* s) {
+    uint32_t r = lire_u32(s);
+    if (r == 0) return NULL;
+    if (r > s->nb_noeuds) { s->ok = false; return NULL; }
+    return s->lus[r - 1];
+}
+
+static void champ_noeud(Serial* s, ASTNode** champ) {
+    switch (s->mode) {
+        case ECRIRE: ecrire_u32(s, *champ ? table_indice(&s->table, *champ) + 1 : 0); break;
+        case LIRE: *champ = lire_reference(s); break;
+    }
+}
+
+static void champ_liste(Serial* s, ASTList* l) {
+    switch (s->mode) {
+        case ECRIRE:
+            ecrire_u32(s, (uint32_t)l->count);
+            for (int i = 0; i < l->count; i++) champ_noeud(s, &l->items[i]);
+            break;
+        case LIRE: {
+            uint32_t nb = lire_u32(s);
+            if (nb > (size_t)(s->fin - s->p) / sizeof(uint32_t)) { s->ok = false; break; }
+            for (uint32_t i = 0; i < nb && s->ok; i++) {
+                ast_list_push(s->arena, l, lire_reference(s));
+            }
+            break;
+        }
+    }
+}
+
+// Chaîne : longueur puis octets. Les noms sont réinternés à la lecture,
+// les textes des littéraux recopiés dans l'arena.
+static const char* lire_chaine(Serial* s, uint32_t* n) {
+    *n = lire_u32(s);
+    if (*n == CHAINE_NULLE || !s->ok) return NULL;
+    if (*n > (size_t)(s->fin - s->p)) { s->ok = false; return NULL; }
+    const char* r = (const char*)s->p;
+    s->p += *n;
+    return r;
+}
+
+static void ecrire_chaine(Serial* s, const char* c) {
+    if (!c) { ecrire_u32(s, CHAINE_NULLE); return; }
+    uint32_t n = (uint32_t)strlen(c);
+    ecrire_u32(s, n);
+    ecrire(s, c, n);
+}
+
+static void champ_nom(Serial* s, const char** champ) {
+    if (s->mode == ECRIRE) ecrire_chaine(s, *champ);
+    else if (s->mode == LIRE) {
+        uint32_t n;
+        const char* c = lire_chaine(s, &n);
+        *champ = c ? intern_n(c, n) : NULL;
+    }
+}
+
+static void champ_texte(Serial* s, char** champ) {
+    if (s->mode == ECRIRE) ecrire_chaine(s, *champ);
+    else if (s->mode == LIRE) {
+        uint32_t n;
+        const char* c = lire_chaine(s, &n);
+        *champ = c ? ast_arena_texte(s->arena, c, n) : NULL;
+    }
+}
+
+static void champ_entier(Serial* s, long long* champ) {
+    if (s->mode == ECRIRE) ecrire(s, champ, sizeof(*champ));
+    else if (s->mode == LIRE) lire(s, champ, sizeof(*champ));
+}
+
+static void champ_bool(Serial* s, bool* champ) {
+    if (s->mode == ECRIRE) {
+        unsigned char b = *champ ? 1 : 0;
+        ecrire(s, &b, 1);
+    } else if (s->mode == LIRE) {
+        unsigned char b;
+        lire(s, &b, 1);
+        *champ = b != 0;
+    }
+}
+
+static void champ_op(Serial* s, TokenType* champ) {
+    if (s->mode == ECRIRE) ecrire_u32(s, (uint32_t)*champ);
+    else if (s->mode == LIRE) {
+        uint32_t v = lire_u32(s);
+        if (v >= TOK_NB_TYPES) s->ok = false;
+        else *champ = (TokenType)v;
+    }
+}
+
+static void champ_prim(Serial* s, PrimitiveType* champ) {
+    if (s->mode == ECRIRE) ecrire_u32(s, (uint32_t)*champ);
+    else if (s->mode == LIRE) {
+        uint32_t v = lire_u32(s);
+        if (v > TYPE_BOOLEEN) s->ok = false;
+        else *champ = (PrimitiveType)v;
+    }
+}
+
+// Type (annotation de l'analyse sémantique) : un octet TypeKind, TYPE_NUL
+// pour NULL ; un tableau ajoute ses dimensions puis le type des éléments,
+// une structure son nom. Relu en type canonique (sem_type_*).
+static void ecrire_type(Serial* s, const Type* t) {
+    unsigned char k = t ? (unsigned char)t->kind : TYPE_NUL;
+    ecrire(s, &k, 1);
+    if (!t) return;
+    if (t->kind == TY_ARRAY) {
+        ecrire_u32(s, (uint32_t)t->as.array.dims);
+        ecrire_type(s, t->as.array.elem);
+    } else if (t->kind == TY_STRUCT) {
+        ecrire_chaine(s, t->as.st.name);
+    }
+}
+
+static Type* lire_type(Serial* s, int profondeur) {
+    unsigned char k;
+    lire(s, &k, 1);
+    if (!s->ok || k == TYPE_NUL) return NULL;
+    if (k == TY_ARRAY) {
+        uint32_t dims = lire_u32(s);
+        if (profondeur >= TYPE_PROFONDEUR_MAX || dims == 0 || dims > 0xFFFF) { s->ok = false; return NULL; }
+        Type* elem = lire_type(s, profondeur + 1);
+        if (!s->ok || !elem) { s->ok = false; return NULL; }
+        return sem_type_tableau(elem, (int)dims);
+    }
+    if (k == TY_STRUCT) {
+        const char* nom = NULL;
+        champ_nom(s, &nom);
+        if (!s->ok || !nom) { s->ok = false; return NULL; }
+        return sem_type_structure(nom);
+    }
+    if (k > TY_STRING) { s->ok = false; return NULL; }
+    return sem_type_primitif((TypeKind)k);
+}
+
+static void champ_type(Serial* s, struct Type** champ) {
+    if (s->mode == ECRIRE) ecrire_type(s, *champ);
+    else if (s->mode == LIRE) *champ = lire_type(s, 0);
+}
+
+static void champs(Serial* s, ASTNode* n) {
+    champ_type(s, &n->type);
+    switch (n->kind) {
+        case AST_PROGRAM:
+            champ_nom(s, &n->as.program.name);
+            champ_liste(s, &n->as.program.decls);
+            champ_liste(s, &n->as.program.defs);
+            champ_noeud(s, &n->as.program.main_block);
+            break;
+        case AST_DECL_VAR:
+            champ_nom(s, &n->as.decl_var.name);
+            champ_noeud(s, &n->as.decl_var.type);
+            break;
+        case AST_DECL_CONST:
+            champ_nom(s, &n->as.decl_const.name);
+            champ_noeud(s, &n->as.decl_const.type);
+            champ_noeud(s, &n->as.decl_const.value);
+            break;
+        case AST_DECL_ARRAY:
+            champ_nom(s, &n->as.decl_array.name);
+            champ_noeud(s, &n->as.decl_array.elem_type);
+            champ_liste(s, &n->as.decl_array.dims);
+            break;
+        case AST_TYPE_ARRAY:
+            champ_noeud(s, &n->as.type_array.elem_type);
+            champ_liste(s, &n->as.type_array.dims);
+            break;
+        case AST_TYPE_PRIMITIVE:
+            champ_prim(s, &n->as.type_prim.prim);
+            break;
+        case AST_TYPE_NAMED:
+            champ_nom(s, &n->as.type_named.name);
+            break;
+        case AST_DEF_STRUCT:
+            champ_nom(s, &n->as.def_struct.name);
+            champ_liste(s, &n->as.def_struct.fields);
+            break;
+        case AST_DEF_FUNC:
+            champ_nom(s, &n->as.def_func.name);
+            champ_liste(s, &n->as.def_func.params);
+            champ_noeud(s, &n->as.def_func.return_type);
+            champ_noeud(s, &n->as.def_func.body);
+            break;
+        case AST_DEF_PROC:
+            champ_nom(s, &n->as.def_proc.name);
+            champ_liste(s, &n->as.def_proc.params);
+            champ_noeud(s, &n->as.def_proc.body);
+            break;
+        case AST_PARAM:
+            champ_nom(s, &n->as.param.name);
+            champ_noeud(s, &n->as.param.type);
+            break;
+        case AST_FIELD:
+            champ_nom(s, &n->as.field.name);
+            champ_noeud(s, &n->as.field.type);
+            break;
+        case AST_BLOCK:
+            champ_liste(s, &n->as.block.stmts);
+            break;
+        case AST_ASSIGN:
+            champ_noeud(s, &n->as.assign.target);
+            champ_noeud(s, &n->as.assign.value);
+            break;
+        case AST_IF:
+            champ_noeud(s, &n->as.if_stmt.cond);
+            champ_noeud(s, &n->as.if_stmt.then_block);
+            champ_liste(s, &n->as.if_stmt.elif_conds);
+            champ_liste(s, &n->as.if_stmt.elif_blocks);
+            champ_noeud(s, &n->as.if_stmt.else_block);
+            break;
+        case AST_WHILE:
+            champ_noeud(s, &n->as.while_stmt.cond);
+            champ_noeud(s, &n->as.while_stmt.body);
+            break;
+        case AST_FOR:
+            champ_nom(s, &n->as.for_stmt.var);
+            champ_noeud(s, &n->as.for_stmt.start);
+            champ_noeud(s, &n->as.for_stmt.end);
+            champ_noeud(s, &n->as.for_stmt.step);
+            champ_noeud(s, &n->as.for_stmt.body);
+            break;
+        case AST_REPEAT:
+            champ_noeud(s, &n->as.repeat_stmt.body);
+            champ_noeud(s, &n->as.repeat_stmt.until_cond);
+            break;
+        case AST_CALL_STMT:
+            champ_noeud(s, &n->as.call_stmt.call);
+            break;
+        case AST_RETURN:
+            champ_noeud(s, &n->as.ret_stmt.value);
+            break;
+        case AST_WRITE:
+            champ_liste(s, &n->as.write_stmt.args);
+            break;
+        case AST_READ:
+            champ_liste(s, &n->as.read_stmt.targets);
+            break;
+        case AST_BREAK:
+        case AST_QUIT_FOR:
+            break;
+        case AST_SWITCH:
+            champ_noeud(s, &n->as.switch_stmt.expr);
+            champ_liste(s, &n->as.switch_stmt.cases);
+            champ_noeud(s, &n->as.switch_stmt.default_block);
+            break;
+        case AST_CASE:
+            champ_liste(s, &n->as.case_stmt.values);
+            champ_noeud(s, &n->as.case_stmt.body);
+            break;
+        case AST_BINARY:
+            champ_op(s, &n->as.binary.op);
+            champ_noeud(s, &n->as.binary.lhs);
+            champ_noeud(s, &n->as.binary.rhs);
+            break;
+        case AST_UNARY:
+            champ_op(s, &n->as.unary.op);
+            champ_noeud(s, &n->as.unary.expr);
+            break;
+        case AST_LITERAL_INT:
+            champ_entier(s, &n->as.lit_int.value);
+            break;
+        case AST_LITERAL_REAL:
+            champ_texte(s, &n->as.lit_real.text);
+            break;
+        case AST_LITERAL_STRING:
+            champ_texte(s, &n->as.lit_string.text);
+            break;
+        case AST_LITERAL_BOOL:
+            champ_bool(s, &n->as.lit_bool.value);
+            break;
+        case AST_IDENT:
+            champ_nom(s, &n->as.ident.name);
+            champ_noeud(s, &n->as.ident.decl);
+            break;
+        case AST_INDEX:
+            champ_noeud(s, &n->as.index.base);
+            champ_noeud(s, &n->as.index.index);
+            break;
+        case AST_FIELD_ACCESS:
+            champ_noeud(s, &n->as.field_access.base);
+            champ_nom(s, &n->as.field_access.field);
+            break;
+        case AST_CALL:
+            champ_noeud(s, &n->as.call.callee);
+            champ_liste(s, &n->as.call.args);
+            break;
+    }
+}
+
+static void serial_liberer(Serial* s) {
+    free(s->table.cles);
+    free(s->table.indices);
+    free(s->noeuds);
+    free(s->tampon);
+    free(s->lus);
+}
+
+// ÉCRITURE
+
+bool cache_ast_ecrire(const char* chemin, uint64_t hachage, ASTNode* prog) {
+    if (!prog) return false;
+
+    Serial s;
+    memset(&s, 0, sizeof(s));
+    s.ok = true;
+
+    // Numérotation en ordre préfixe : la racine a l'indice 0
+    ASTVisiteur numerotation = { numeroter, NULL, &s };
+    ast_parcourir(prog, &numerotation, 1);
+
+    s.mode = ECRIRE;
+    uint32_t version = CACHE_AST_VERSION;
+    ecrire(&s, MAGIQUE, sizeof(MAGIQUE));
+    ecrire_u32(&s, version);
+    ecrire_u32(&s, s.nb_noeuds);
+    ecrire(&s, &hachage, sizeof(hachage));
+    uint64_t controle = 0;
+    ecrire(&s, &controle, sizeof(controle));
+    for (uint32_t i = 0; i < s.nb_noeuds; i++) {
+        unsigned char kind = (unsigned char)s.noeuds[i]->kind;
+        ecrire(&s, &kind, 1);
+    }
+    for (uint32_t i = 0; i < s.nb_noeuds && s.ok; i++) {
+        ASTNode* n = s.noeuds[i];
+        int32_t pos[2] = { n->line, n->col };
+        ecrire(&s, pos, sizeof(pos));
+        champs(&s, n);
+    }
+
+    bool ok = s.ok;
+    if (ok) {
+        controle = cache_ast_hacher((const char*)s.tampon + TAILLE_ENTETE, s.taille - TAILLE_ENTETE);
+        memcpy(s.tampon + TAILLE_ENTETE - sizeof(controle), &controle, sizeof(controle));
+
+        // Fichier temporaire renommé : un lecteur ne voit jamais de
+        // fichier à moitié écrit
+        size_t n = strlen(chemin);
+        char* tmp = (char*)malloc(n + sizeof(".tmp"));
+        FILE* f = NULL;
+        if (tmp) {
+            memcpy(tmp, chemin, n);
+            memcpy(tmp + n, ".tmp", sizeof(".tmp"));
+            f = fopen(tmp, "wb");
+        }
+        ok = f && fwrite(s.tampon, 1, s.taille, f) == s.taille;
+        if (f && fclose(f) != 0) ok = false;
+        if (ok) ok = rename(tmp, chemin) == 0;
+        if (!ok && f) remove(tmp);
+        free(tmp);
+    }
+
+    serial_liberer(&s);
+    return ok;
+}
+
+// CHARGEMENT
+
+ASTNode* cache_ast_charger(const char* chemin, uint64_t hachage, ASTArena* arena) {
+    SourceEntree fichier;
+    if (!source_ouvrir(&fichier, chemin)) return NULL;
+
+    Serial s;
+    memset(&s, 0, sizeof(s));
+    s.ok = true;
+    s.mode = LIRE;
+    s.arena = arena;
+    s.p = (const unsigned char*)fichier.donnees;
+    s.fin = s.p + fichier.longueur;
+
+    ASTNode* prog = NULL;
+
+    char magique[sizeof(MAGIQUE)];
+    uint64_t h, controle;
+    lire(&s, magique, sizeof(magique));
+    uint32_t version = lire_u32(&s);
+    s.nb_noeuds = lire_u32(&s);
+    lire(&s, &h, sizeof(h));
+    lire(&s, &controle, sizeof(controle));
+
+    if (!s.ok || memcmp(magique, MAGIQUE, sizeof(MAGIQUE)) != 0 ||
+        version != CACHE_AST_VERSION || h != hachage ||
+        s.nb_noeuds == 0 || s.nb_noeuds > (size_t)(s.fin - s.p) ||
+        controle != cache_ast_hacher((const char*)s.p, (size_t)(s.fin - s.p))) {
+        goto fin;
+    }
+
+    // 1) un nœud vide par type, 2) champs et positions
+    const unsigned char* kinds = s.p;
+    s.p += s.nb_noeuds;
+    s.lus = (ASTNode**)malloc((size_t)s.nb_noeuds * sizeof(ASTNode*));
+    if (!s.lus) goto fin;
+    for (uint32_t i = 0; i < s.nb_noeuds; i++) {
+        if (kinds[i] > AST_CALL) goto fin;
+        s.lus[i] = ast_new_node(arena, (ASTKind)kinds[i], 0, 0);
+        if (!s.lus[i]) goto fin;
+    }
+
+    for (uint32_t i = 0; i < s.nb_noeuds && s.ok; i++) {
+        int32_t pos[2];
+        lire(&s, pos, sizeof(pos));
+        s.lus[i]->line = pos[0];
+        s.lus[i]->col = pos[1];
+        champs(&s, s.lus[i]);
+    }
+
+    if (s.ok && s.p == s.fin && s.lus[0]->kind == AST_PROGRAM) prog = s.lus[0];
+
+fin:
+    serial_liberer(&s);
+    source_fermer(&fichier);
+    return prog;
+}
@@ -0,0 +1,44 @@
+#ifndef CACHE_AST_H
+#define CACHE_AST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+
+// Cache binaire de l'AST (.algoast).
+//
+// Après une analyse sémantique réussie, l'AST est écrit dans un fichier
+// versionné, associé au hachage du texte source. Une compilation suivante
+// du même texte projette ce fichier en mémoire et reconstruit l'AST sans
+// analyse lexicale, syntaxique ni sémantique.
+//
+// Format (entiers en ordre natif, 32 bits sauf mention) :
+//   en-tête   "ALGOAST\0", version, nombre de nœuds, hachage du source
+//             et somme de contrôle de la suite du fichier (64 bits)
+//   types     un octet (ASTKind) par nœud ; le nœud 0 est la racine
+//   nœuds     pour chaque nœud : ligne, colonne, type annoté par l'analyse
+//             sémantique, puis ses champs (référence = indice + 1, 0 pour
+//             NULL ; liste = nombre puis références ; chaîne = longueur puis
+//             octets, ~0 pour NULL)
+//
+// La somme de contrôle écarte un fichier altéré : un type de nœud modifié
+// donnerait un AST bien formé mais incohérent pour les générateurs.
+//
+// CACHE_AST_VERSION change avec le format ou l'ordre des ASTKind.
+
+#define CACHE_AST_VERSION 3
+
+uint64_t cache_ast_hacher(const char* source, size_t longueur);
+
+// "prog.algo" -> "prog.algoast", sinon chemin + ".algoast" (à libérer)
+char* cache_ast_chemin(const char* chemin_source);
+
+// Écrit l'AST de prog (fichier temporaire puis renommage)
+bool cache_ast_ecrire(const char* chemin, uint64_t hachage, ASTNode* prog);
+
+// AST reconstruit dans arena, ou NULL si le fichier est absent, d'une
+// autre version, d'un autre source (hachage) ou invalide
+ASTNode* cache_ast_charger(const char* chemin, uint64_t hachage, ASTArena* arena);
+
+#endif
@@ -1,4 +1,6 @@
 #include "cgen.h"
+#include "semantique.h"
+#include "intern.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,14 +9,6 @@
 
 // Utilitaires de chaînes
 
-static char* cgen_strdup(const char* s) {
-    if (!s) return NULL;
-    size_t n = strlen(s) + 1;
-    char* p = (char*)malloc(n);
-    if (p) memcpy(p, s, n);
-    return p;
-}
-
 typedef struct {
     char* data;
     size_t len;
@@ -58,7 +52,7 @@ typedef enum { CT_UNKNOWN, CT_INT, CT_REAL, CT_BOOL, CT_CHAR, CT_STRING, CT_STRU
 
 typedef struct CType {
     CTypeKind kind;
-    char* struct_name;
+    const char* struct_name;   // interné
     struct CType* elem;
     int dims;
 } CType;
@@ -69,58 +63,18 @@ static CType* ct_new(CTypeKind k) {
     return t;
 }
 
-static CType* ct_clone(const CType* src) {
-    if (!src) return ct_new(CT_UNKNOWN);
-    CType* t = ct_new(src->kind);
-    if (src->struct_name) t->struct_name = cgen_strdup(src->struct_name);
-    if (src->elem) t->elem = ct_clone(src->elem);
-    t->dims = src->dims;
-    return t;
-}
-
 static void ct_free(CType* t) {
     if (!t) return;
-    free(t->struct_name);
     ct_free(t->elem);
     free(t);
 }
 
-// Tables des Symboles
-
-typedef struct { char* name; CType* type; } Sym;
-typedef struct { Sym* items; int count; int cap; } SymTab;
-
-static void symtab_add(SymTab* st, const char* name, CType* type) {
-    if (st->count >= st->cap) {
-        st->cap = (st->cap == 0) ? 16 : st->cap * 2;
-        st->items = realloc(st->items, st->cap * sizeof(Sym));
-    }
-    st->items[st->count].name = cgen_strdup(name);
-    st->items[st->count].type = ct_clone(type);
-    st->count++;
-}
-
-static CType* symtab_lookup(SymTab* st, const char* name) {
-    for (int i = 0; i < st->count; i++) {
-        if (strcmp(st->items[i].name, name) == 0) return st->items[i].type;
-    }
-    return NULL;
-}
-
-static void symtab_free(SymTab* st) {
-    for (int i=0; i<st->count; i++) { free(st->items[i].name); ct_free(st->items[i].type); }
-    free(st->items);
-}
-
 typedef struct {
     Str out;
     int indent;
-    struct { char* name; SymTab fields; }* structs;
-    int struct_count;
-    struct { char* name; CType* ret; }* funcs;
-    int func_count;
-    SymTab* scopes;
-    int scope_count;
+    const char* nom_m;    // "m" interné
+    bool m_global;        // une globale s'appelle m
+    bool m_visible;       // m visible dans la définition en cours
 } CG;
 
 // Helpers
@@ -128,39 +82,19 @@ typedef struct {
 static void emit_indent(CG* cg) { for(int i=0; i<cg->indent; i++) str_append(&cg->out, "    "); }
 static void emit_ln(CG* cg, const char* s) { emit_indent(cg); str_append(&cg->out, s); str_append(&cg->out, "\n"); }
 
-static void push_scope(CG* cg) {
-    cg->scopes = realloc(cg->scopes, (cg->scope_count + 1) * sizeof(SymTab));
-    memset(&cg->scopes[cg->scope_count], 0, sizeof(SymTab));
-    cg->scope_count++;
-}
-
-static void pop_scope(CG* cg) {
-    cg->scope_count--;
-    symtab_free(&cg->scopes[cg->scope_count]);
-}
-
-static CType* lookup_var(CG* cg, const char* name) {
-    for (int i = cg->scope_count - 1; i >= 0; i--) {
-        CType* t = symtab_lookup(&cg->scopes[i], name);
-        if (t) return ct_clone(t);
-    }
-    return NULL;
-}
-
-static CType* lookup_func_ret(CG* cg, const char* name) {
-    for (int i=0; i<cg->func_count; i++) {
-        if (strcmp(cg->funcs[i].name, name) == 0) return ct_clone(cg->funcs[i].ret);
-    }
-    return NULL;
-}
-
-static CType* lookup_struct_field(CG* cg, const char* struct_name, const char* field) {
-    for (int i=0; i<cg->struct_count; i++) {
-        if (strcmp(cg->structs[i].name, struct_name) == 0) {
-            return ct_clone(symtab_lookup(&cg->structs[i].fields, field));
-        }
+// Les déclarations ne se trouvent qu'en tête de définition (globales,
+// paramètres, Objets locaux) : un nom visible l'est pour toute la
+// définition.
+static bool declare_nom(const ASTList* l, const char* nom) {
+    for (int i = 0; i < l->count; i++) {
+        ASTNode* d = l->items[i];
+        const char* n = (d->kind == AST_DECL_VAR) ? d->as.decl_var.name :
+                        (d->kind == AST_DECL_CONST) ? d->as.decl_const.name :
+                        (d->kind == AST_DECL_ARRAY) ? d->as.decl_array.name :
+                        (d->kind == AST_PARAM) ? d->as.param.name : NULL;
+        if (n == nom) return true;
     }
-    return NULL;
+    return false;
 }
 
 static CType* ast_to_ctype(ASTNode* t) {
@@ -177,7 +111,7 @@ static CType* ast_to_ctype(ASTNode* t) {
     }
     if (t->kind == AST_TYPE_NAMED) {
         CType* c = ct_new(CT_STRUCT);
-        c->struct_name = cgen_strdup(t->as.type_named.name);
+        c->struct_name = t->as.type_named.name;
         return c;
     }
     if (t->kind == AST_TYPE_ARRAY) {
@@ -203,59 +137,29 @@ static void emit_type_str(Str* out, CType* t) {
     }
 }
 
-// Type Inference
-
-static CType* infer_expr(CG* cg, ASTNode* e) {
-    if (!e) return ct_new(CT_UNKNOWN);
-    switch (e->kind) {
-        case AST_LITERAL_INT: return ct_new(CT_INT);
-        case AST_LITERAL_REAL: return ct_new(CT_REAL);
-        case AST_LITERAL_BOOL: return ct_new(CT_BOOL);
-        case AST_LITERAL_STRING: return ct_new(CT_STRING);
-        case AST_IDENT: return lookup_var(cg, e->as.ident.name);
-        case AST_BINARY: {
-            CType* l = infer_expr(cg, e->as.binary.lhs);
-            CType* r = infer_expr(cg, e->as.binary.rhs);
-            TokenType op = e->as.binary.op;
-            
-            if ((op >= TOK_INFERIEUR && op <= TOK_DIFFERENT) || op == TOK_ET || op == TOK_OU || op == TOK_NON) {
-                ct_free(l); ct_free(r); return ct_new(CT_BOOL);
-            }
-            if (op == TOK_DIVISE) { ct_free(l); ct_free(r); return ct_new(CT_REAL); }
-            
-            if (l->kind == CT_REAL || r->kind == CT_REAL) { ct_free(l); ct_free(r); return ct_new(CT_REAL); }
-            ct_free(l); ct_free(r); return ct_new(CT_INT);
-        }
-        case AST_UNARY: return (e->as.unary.op == TOK_NON) ? ct_new(CT_BOOL) : infer_expr(cg, e->as.unary.expr);
-        case AST_CALL:
-            if (e->as.call.callee->kind == AST_IDENT) return lookup_func_ret(cg, e->as.call.callee->as.ident.name);
-            return ct_new(CT_UNKNOWN);
-        case AST_FIELD_ACCESS: {
-            CType* base = infer_expr(cg, e->as.field_access.base);
-            if (base && base->kind == CT_STRUCT) {
-                CType* ret = lookup_struct_field(cg, base->struct_name, e->as.field_access.field);
-                ct_free(base); return ret ? ret : ct_new(CT_UNKNOWN);
-            }
-            ct_free(base); return ct_new(CT_UNKNOWN);
-        }
-        case AST_INDEX: {
-            CType* base = infer_expr(cg, e->as.index.base);
-            if (base && base->kind == CT_ARRAY) {
-                if (base->dims > 1) {
-                    CType* next = ct_clone(base);
-                    next->dims--;
-                    ct_free(base); return next;
-                } else {
-                    CType* elem = ct_clone(base->elem);
-                    ct_free(base); return elem;
-                }
-            }
-            ct_free(base); return ct_new(CT_UNKNOWN);
-        }
-        default: return ct_new(CT_UNKNOWN);
+// Types des expressions : annotations de l'analyse sémantique
+
+static CTypeKind kind_expr(ASTNode* e) {
+    if (!e || !e->type) return CT_UNKNOWN;
+    // '/' est émise en division réelle (cast en double)
+    if (e->kind == AST_BINARY && e->as.binary.op == TOK_DIVISE) return CT_REAL;
+    switch (e->type->kind) {
+        case TY_INT: return CT_INT;
+        case TY_REAL: return CT_REAL;
+        case TY_BOOL: return CT_BOOL;
+        case TY_CHAR: return CT_CHAR;
+        case TY_STRING: return CT_STRING;
+        case TY_STRUCT: return CT_STRUCT;
+        case TY_ARRAY: return CT_ARRAY;
+        default: return CT_UNKNOWN;
     }
 }
 
+// Tableau à plusieurs dimensions (passé en int* aux fonctions)
+static bool est_tableau_multi(ASTNode* e) {
+    return e && e->type && e->type->kind == TY_ARRAY && e->type->as.array.dims > 1;
+}
+
 // Émission de Code
 
 static void emit_expr(CG* cg, ASTNode* e);
@@ -283,20 +187,13 @@ static void emit_op(CG* cg, TokenType op) {
 static bool try_emit_flat_index(CG* cg, ASTNode* idx) {
     if (idx->kind != AST_INDEX) return false;
     ASTNode* base = idx->as.index.base;
-    if (base->kind == AST_INDEX && base->as.index.base->kind == AST_IDENT) {
-        CType* t = lookup_var(cg, base->as.index.base->as.ident.name);
-        if (t && t->kind == CT_ARRAY && t->dims > 1) {
-            CType* tm = lookup_var(cg, "m"); 
-            if (tm) {
-                str_append(&cg->out, base->as.index.base->as.ident.name);
-                str_append(&cg->out, "[("); emit_expr(cg, base->as.index.index);
-                str_append(&cg->out, ") * m + ("); emit_expr(cg, idx->as.index.index);
-                str_append(&cg->out, ")]");
-                ct_free(tm); ct_free(t); return true;
-            }
-            if (tm) ct_free(tm);
-        }
-        if (t) ct_free(t);
+    if (base->kind == AST_INDEX && base->as.index.base->kind == AST_IDENT &&
+        est_tableau_multi(base->as.index.base) && cg->m_visible) {
+        str_append(&cg->out, base->as.index.base->as.ident.name);
+        str_append(&cg->out, "[("); emit_expr(cg, base->as.index.index);
+        str_append(&cg->out, ") * m + ("); emit_expr(cg, idx->as.index.index);
+        str_append(&cg->out, ")]");
+        return true;
     }
     return false;
 }
@@ -324,6 +221,13 @@ static void emit_expr(CG* cg, ASTNode* e) {
                 str_append(&cg->out, ")) / (");
                 emit_expr(cg, e->as.binary.rhs);
                 str_append(&cg->out, ")");
+            } else if (e->as.binary.op == TOK_PUISSANCE) {
+                // '^' entre entiers : entier, comme le type de l'analyse
+                str_append(&cg->out, (kind_expr(e) == CT_INT) ? "((int)pow(" : "pow(");
+                emit_expr(cg, e->as.binary.lhs);
+                str_append(&cg->out, ", ");
+                emit_expr(cg, e->as.binary.rhs);
+                str_append(&cg->out, (kind_expr(e) == CT_INT) ? "))" : ")");
             } else {
                 str_append(&cg->out, "("); emit_expr(cg, e->as.binary.lhs);
                 emit_op(cg, e->as.binary.op); emit_expr(cg, e->as.binary.rhs); str_append(&cg->out, ")");
@@ -339,11 +243,7 @@ static void emit_expr(CG* cg, ASTNode* e) {
             for (int i=0; i<e->as.call.args.count; i++) {
                 if (i>0) str_append(&cg->out, ", ");
                 ASTNode* arg = e->as.call.args.items[i];
-                if (arg->kind == AST_IDENT) {
-                    CType* t = lookup_var(cg, arg->as.ident.name);
-                    if (t && t->kind == CT_ARRAY && t->dims > 1) str_append(&cg->out, "(int*)");
-                    if (t) ct_free(t);
-                }
+                if (arg->kind == AST_IDENT && est_tableau_multi(arg)) str_append(&cg->out, "(int*)");
                 emit_expr(cg, arg);
             }
             str_append(&cg->out, ")");
@@ -378,7 +278,6 @@ static void emit_decl(CG* cg, ASTNode* d, bool is_global) {
     if (d->kind == AST_DECL_ARRAY) {
         CType* arr = ct_new(CT_ARRAY); arr->elem = ct; arr->dims = d->as.decl_array.dims.count; ct = arr;
     }
-    symtab_add(&cg->scopes[cg->scope_count-1], name, ct);
     if (is_global && d->kind == AST_DECL_CONST && ct->kind == CT_INT) { ct_free(ct); return; }
     
     emit_indent(cg);
@@ -440,12 +339,11 @@ static void emit_stmt(CG* cg, ASTNode* s) {
                 ASTNode* arg = s->as.write_stmt.args.items[i];
                 if (arg->kind == AST_LITERAL_STRING) str_append(&cg->out, arg->as.lit_string.text);
                 else {
-                    CType* t = infer_expr(cg, arg);
-                    if (t->kind == CT_INT || t->kind == CT_BOOL) str_append(&cg->out, "%d");
-                    else if (t->kind == CT_REAL) str_append(&cg->out, "%g");
-                    else if (t->kind == CT_CHAR) str_append(&cg->out, "%c");
+                    CTypeKind k = kind_expr(arg);
+                    if (k == CT_INT || k == CT_BOOL) str_append(&cg->out, "%d");
+                    else if (k == CT_REAL) str_append(&cg->out, "%g");
+                    else if (k == CT_CHAR) str_append(&cg->out, "%c");
                     else str_append(&cg->out, "%s");
-                    ct_free(t);
                 }
             }
             str_append(&cg->out, "\\n\"");
@@ -462,16 +360,15 @@ static void emit_stmt(CG* cg, ASTNode* s) {
         case AST_READ:
              for(int i=0; i<s->as.read_stmt.targets.count; i++) {
                 ASTNode* target = s->as.read_stmt.targets.items[i];
-                CType* t = infer_expr(cg, target);
+                CTypeKind k = kind_expr(target);
                 emit_indent(cg); 
-                if (t->kind == CT_STRING) { 
+                if (k == CT_STRING) { 
                     str_append(&cg->out, "{ "); emit_expr(cg, target); str_append(&cg->out, " = malloc(256); scanf(\"%s\", "); emit_expr(cg, target); str_append(&cg->out, "); }\n"); 
                 }
                 else {
-                    str_printf(&cg->out, "scanf(\"%s\", &", (t->kind == CT_REAL) ? "%lf" : (t->kind == CT_CHAR) ? " %c" : "%d");
+                    str_printf(&cg->out, "scanf(\"%s\", &", (k == CT_REAL) ? "%lf" : (k == CT_CHAR) ? " %c" : "%d");
                     emit_expr(cg, target); str_append(&cg->out, ");\n");
                 }
-                ct_free(t);
              }
              break;
         case AST_SWITCH:
@@ -494,7 +391,7 @@ static void emit_stmt(CG* cg, ASTNode* s) {
 
 static void emit_block(CG* cg, ASTNode* b) {
     if (!b) return;
-    str_append(&cg->out, "{\n"); cg->indent++; push_scope(cg);
+    str_append(&cg->out, "{\n"); cg->indent++;
     for(int i=0; i<b->as.block.stmts.count; i++) {
         ASTNode* s = b->as.block.stmts.items[i];
         if (s->kind == AST_DECL_VAR || s->kind == AST_DECL_CONST || s->kind == AST_DECL_ARRAY) emit_decl(cg, s, false);
@@ -503,12 +400,14 @@ static void emit_block(CG* cg, ASTNode* b) {
         ASTNode* s = b->as.block.stmts.items[i];
         if (s->kind != AST_DECL_VAR && s->kind != AST_DECL_CONST && s->kind != AST_DECL_ARRAY) emit_stmt(cg, s);
     }
-    pop_scope(cg); cg->indent--; emit_indent(cg); str_append(&cg->out, "}\n");
+    cg->indent--; emit_indent(cg); str_append(&cg->out, "}\n");
 }
 
 bool cgen_generate(ASTNode* program, const char* output_c_path) {
     if (!program) return false;
-    CG cg; memset(&cg, 0, sizeof(cg)); str_init(&cg.out); push_scope(&cg);
+    CG cg; memset(&cg, 0, sizeof(cg)); str_init(&cg.out);
+    cg.nom_m = intern("m");
+    cg.m_global = declare_nom(&program->as.program.decls, cg.nom_m);
     
     // Headers standards UNIQUEMENT
     emit_ln(&cg, "#include <stdio.h>");
@@ -518,9 +417,6 @@ bool cgen_generate(ASTNode* program, const char* output_c_path) {
     emit_ln(&cg, "#include <math.h>");
     emit_ln(&cg, "");
 
-    cg.structs = calloc(program->as.program.defs.count, sizeof(*cg.structs));
-    cg.funcs = calloc(program->as.program.defs.count, sizeof(*cg.funcs));
-    
     bool has_structs = false;
     for (int i=0; i<program->as.program.defs.count; i++) {
         if (program->as.program.defs.items[i]->kind == AST_DEF_STRUCT) { has_structs = true; break; }
@@ -531,21 +427,14 @@ bool cgen_generate(ASTNode* program, const char* output_c_path) {
     for (int i=0; i<program->as.program.defs.count; i++) {
         ASTNode* def = program->as.program.defs.items[i];
         if (def->kind == AST_DEF_STRUCT) {
-            int idx = cg.struct_count++; cg.structs[idx].name = cgen_strdup(def->as.def_struct.name);
-            for(int j=0; j<def->as.def_struct.fields.count; j++) {
-                ASTNode* f = def->as.def_struct.fields.items[j];
-                symtab_add(&cg.structs[idx].fields, f->as.field.name, ast_to_ctype(f->as.field.type));
-            }
             str_printf(&cg.out, "typedef struct %s {\n", def->as.def_struct.name); cg.indent++;
             for(int j=0; j<def->as.def_struct.fields.count; j++) {
                 ASTNode* f = def->as.def_struct.fields.items[j];
-                emit_indent(&cg); emit_type_str(&cg.out, ast_to_ctype(f->as.field.type)); str_printf(&cg.out, " %s;\n", f->as.field.name);
+                CType* ft = ast_to_ctype(f->as.field.type);
+                emit_indent(&cg); emit_type_str(&cg.out, ft); str_printf(&cg.out, " %s;\n", f->as.field.name);
+                ct_free(ft);
             }
             cg.indent--; str_printf(&cg.out, "} %s;\n\n", def->as.def_struct.name);
-        } else if (def->kind == AST_DEF_FUNC || def->kind == AST_DEF_PROC) {
-            int idx = cg.func_count++;
-            cg.funcs[idx].name = cgen_strdup(def->kind == AST_DEF_FUNC ? def->as.def_func.name : def->as.def_proc.name);
-            cg.funcs[idx].ret = (def->kind == AST_DEF_FUNC) ? ast_to_ctype(def->as.def_func.return_type) : ct_new(CT_UNKNOWN);
         }
     }
 
@@ -590,26 +479,28 @@ bool cgen_generate(ASTNode* program, const char* output_c_path) {
             CType* ret = isFunc ? ast_to_ctype(def->as.def_func.return_type) : NULL;
             emit_type_str(&cg.out, ret);
             str_printf(&cg.out, " %s(", isFunc ? def->as.def_func.name : def->as.def_proc.name);
-            push_scope(&cg);
             ASTList* params = isFunc ? &def->as.def_func.params : &def->as.def_proc.params;
+            ASTNode* body = isFunc ? def->as.def_func.body : def->as.def_proc.body;
+            cg.m_visible = cg.m_global || declare_nom(params, cg.nom_m) ||
+                           (body && declare_nom(&body->as.block.stmts, cg.nom_m));
             for(int p=0; p<params->count; p++) {
                 if (p>0) str_append(&cg.out, ", ");
                 ASTNode* pm = params->items[p]; CType* pt = ast_to_ctype(pm->as.param.type);
-                symtab_add(&cg.scopes[cg.scope_count-1], pm->as.param.name, pt);
                 emit_type_str(&cg.out, pt);
                 if (pt->kind == CT_ARRAY) str_printf(&cg.out, " %s[]", pm->as.param.name);
                 else str_printf(&cg.out, " %s", pm->as.param.name);
                 ct_free(pt);
             }
             str_append(&cg.out, ") ");
-            emit_block(&cg, isFunc ? def->as.def_func.body : def->as.def_proc.body);
-            pop_scope(&cg); ct_free(ret); emit_ln(&cg, "");
+            emit_block(&cg, body);
+            ct_free(ret); emit_ln(&cg, "");
         }
     }
 
     emit_ln(&cg, "// Main");
-    emit_ln(&cg, "int main(void) {"); cg.indent++; push_scope(&cg);
+    emit_ln(&cg, "int main(void) {"); cg.indent++;
     ASTNode* mb = program->as.program.main_block;
+    cg.m_visible = cg.m_global || (mb && declare_nom(&mb->as.block.stmts, cg.nom_m));
     if (mb) {
         for(int i=0; i<mb->as.block.stmts.count; i++) {
             ASTNode* s = mb->as.block.stmts.items[i];
@@ -620,14 +511,10 @@ bool cgen_generate(ASTNode* program, const char* output_c_path) {
             if (s->kind != AST_DECL_VAR && s->kind != AST_DECL_CONST && s->kind != AST_DECL_ARRAY) emit_stmt(&cg, s);
         }
     }
-    pop_scope(&cg); emit_ln(&cg, "return 0;"); cg.indent--; emit_ln(&cg, "}");
+    emit_ln(&cg, "return 0;"); cg.indent--; emit_ln(&cg, "}");
 
     FILE* f = fopen(output_c_path, "w");
     if (f) { fputs(cg.out.data, f); fclose(f); }
-    str_free(&cg.out); free(cg.structs); free(cg.funcs);
-    while(cg.scope_count > 0) {
-        pop_scope(&cg); 
-    }
-    free(cg.scopes);
+    str_free(&cg.out);
     return true;
 }
\ No newline at end of file
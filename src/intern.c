@@ -0,0 +1,137 @@
+#include "intern.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Table ouverte (sondage linéaire) d'entrées { chaîne, hachage, longueur },
+// agrandie à 50 % de remplissage. Les chaînes sont copiées dans des pages
+// chaînées qui ne bougent jamais : les pointeurs rendus restent stables.
+
+#define INTERN_PAGE (64 * 1024)
+
+typedef struct {
+    const char* chaine;     // NULL : case libre
+    uint32_t hachage;
+    uint32_t longueur;
+} EntreeIntern;
+
+typedef struct PageIntern {
+    struct PageIntern* suivante;
+} PageIntern;
+
+static pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER;
+
+static EntreeIntern* entrees;
+static uint32_t capacite;    // puissance de 2
+static int nb;
+
+static PageIntern* pages;
+static char* courant;
+static size_t restant;
+
+// FNV-1a
+static uint32_t hacher(const char* s, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static char* copier(const char* s, size_t n) {
+    if (restant < n + 1) {
+        size_t taille = (n + 1 > INTERN_PAGE) ? n + 1 : INTERN_PAGE;
+        PageIntern* p = (PageIntern*)malloc(sizeof(PageIntern) + taille);
+        if (!p) return NULL;
+        p->suivante = pages;
+        pages = p;
+        courant = (char*)(p + 1);
+        restant = taille;
+    }
+    char* r = courant;
+    memcpy(r, s, n);
+    r[n] = '\0';
+    courant += n + 1;
+    restant -= n + 1;
+    return r;
+}
+
+static bool agrandir(void) {
+    uint32_t ncap = (capacite == 0) ? 1024 : capacite * 2;
+    EntreeIntern* n = (EntreeIntern*)calloc(ncap, sizeof(EntreeIntern));
+    if (!n) return false;
+
+    for (uint32_t i = 0; i < capacite; i++) {
+        if (!entrees[i].chaine) continue;
+        uint32_t j = entrees[i].hachage & (ncap - 1);
+        while (n[j].chaine) j = (j + 1) & (ncap - 1);
+        n[j] = entrees[i];
+    }
+    free(entrees);
+    entrees = n;
+    capacite = ncap;
+    return true;
+}
+
+const char* intern_n(const char* s, size_t n) {
+    if (!s) return NULL;
+    uint32_t h = hacher(s, n);
+
+    pthread_mutex_lock(&verrou);
+
+    const char* r = NULL;
+    if ((uint32_t)(nb + 1) * 2 > capacite && !agrandir()) goto fin;
+
+    uint32_t i = h & (capacite - 1);
+    while (entrees[i].chaine) {
+        EntreeIntern* e = &entrees[i];
+        if (e->hachage == h && e->longueur == n && memcmp(e->chaine, s, n) == 0) {
+            r = e->chaine;
+            goto fin;
+        }
+        i = (i + 1) & (capacite - 1);
+    }
+
+    r = copier(s, n);
+    if (r) {
+        entrees[i].chaine = r;
+        entrees[i].hachage = h;
+        entrees[i].longueur = (uint32_t)n;
+        nb++;
+    }
+
+fin:
+    pthread_mutex_unlock(&verrou);
+    return r;
+}
+
+const char* intern(const char* s) {
+    if (!s) return NULL;
+    return intern_n(s, strlen(s));
+}
+
+int intern_nb(void) {
+    pthread_mutex_lock(&verrou);
+    int n = nb;
+    pthread_mutex_unlock(&verrou);
+    return n;
+}
+
+void intern_liberer(void) {
+    pthread_mutex_lock(&verrou);
+    while (pages) {
+        PageIntern* suivante = pages->suivante;
+        free(pages);
+        pages = suivante;
+    }
+    free(entrees);
+    entrees = NULL;
+    capacite = 0;
+    nb = 0;
+    courant = NULL;
+    restant = 0;
+    pthread_mutex_unlock(&verrou);
+}
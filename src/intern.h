@@ -0,0 +1,26 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+
+// Table des identificateurs du processus.
+//
+// Chaque nom (variable, fonction, structure, champ...) n'y existe qu'en un
+// exemplaire : deux noms internés sont égaux si et seulement si leurs
+// pointeurs le sont. Le parser interne les noms en construisant l'AST ;
+// l'analyse sémantique et les générateurs comparent et hachent ensuite des
+// pointeurs, sans strcmp ni hachage de chaîne.
+//
+// Les chaînes restent valides jusqu'à intern_liberer(). La table est
+// protégée par un verrou : utilisable depuis plusieurs threads.
+
+// Nom interné pour les n octets de s (pas forcément terminés par '\0')
+const char* intern_n(const char* s, size_t n);
+const char* intern(const char* s);
+
+// Nombre de noms distincts (statistiques)
+int intern_nb(void);
+
+void intern_liberer(void);
+
+#endif
@@ -1,5 +1,6 @@
 #include "jgen.h"
 #include "token.h"
+#include "semantique.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,14 +9,6 @@
 
 /* Utilitaires chaînes */
 
-static char* dupstr(const char* s) {
-    if (!s) return NULL;
-    size_t n = strlen(s) + 1;
-    char* p = (char*)malloc(n);
-    if (p) memcpy(p, s, n);
-    return p;
-}
-
 typedef struct {
     char* data;
     size_t len;
@@ -53,13 +46,13 @@ static void str_printf(Str* s, const char* fmt, ...) {
 
 static void str_free(Str* s) { free(s->data); s->data = NULL; s->len = s->cap = 0; }
 
-/* Types Java + symboles */
+/* Types Java */
 
 typedef enum { JT_UNKNOWN, JT_INT, JT_DOUBLE, JT_BOOL, JT_CHAR, JT_STRING, JT_STRUCT, JT_ARRAY } JTypeKind;
 
 typedef struct JType {
     JTypeKind kind;
-    char* struct_name;
+    const char* struct_name;   /* interné */
     struct JType* elem;
     int dims;
 } JType;
@@ -70,70 +63,18 @@ static JType* jt_new(JTypeKind k) {
     return t;
 }
 
-static JType* jt_clone(const JType* src) {
-    if (!src) return jt_new(JT_UNKNOWN);
-    JType* t = jt_new(src->kind);
-    if (src->struct_name) t->struct_name = dupstr(src->struct_name);
-    if (src->elem) t->elem = jt_clone(src->elem);
-    t->dims = src->dims;
-    return t;
-}
-
 static void jt_free(JType* t) {
     if (!t) return;
-    free(t->struct_name);
     jt_free(t->elem);
     free(t);
 }
 
-typedef struct { char* name; JType* type; } Sym;
-typedef struct { Sym* items; int count; int cap; } SymTab;
-
-static void symtab_add(SymTab* st, const char* name, JType* type) {
-    if (!st || !name || !type) return;
-    if (st->count >= st->cap) {
-        st->cap = (st->cap == 0) ? 16 : st->cap * 2;
-        st->items = (Sym*)realloc(st->items, (size_t)st->cap * sizeof(Sym));
-    }
-    st->items[st->count].name = dupstr(name);
-    st->items[st->count].type = jt_clone(type);
-    st->count++;
-}
-
-static JType* symtab_lookup(SymTab* st, const char* name) {
-    if (!st || !name) return NULL;
-    for (int i = 0; i < st->count; i++) {
-        if (strcmp(st->items[i].name, name) == 0) return st->items[i].type;
-    }
-    return NULL;
-}
-
-static void symtab_free(SymTab* st) {
-    if (!st) return;
-    for (int i = 0; i < st->count; i++) {
-        free(st->items[i].name);
-        jt_free(st->items[i].type);
-    }
-    free(st->items);
-    st->items = NULL;
-    st->count = st->cap = 0;
-}
-
 /* Générateur Java */
 
 typedef struct {
     Str out;
     int indent;
 
-    struct { char* name; SymTab fields; }* structs;
-    int struct_count;
-
-    struct { char* name; JType* ret; }* funcs;
-    int func_count;
-
-    SymTab* scopes;
-    int scope_count;
-
     const char* class_name;
 
     /* Compteur pour noms temporaires uniques (Java interdit le shadowing) */
@@ -141,8 +82,8 @@ typedef struct {
 
     /* Liste des tableaux globaux de structs à initialiser dans static { } */
     struct {
-        char* name;
-        char* struct_name;
+        const char* name;
+        const char* struct_name;
         ASTNode** dims;
         int dim_count;
     } *g_arr_inits;
@@ -151,47 +92,11 @@ typedef struct {
 
 } JG;
 
-/* Helpers indentation / scopes */
+/* Helpers indentation */
 
 static void emit_indent(JG* jg) { for (int i = 0; i < jg->indent; i++) str_append(&jg->out, "    "); }
 static void emit_ln(JG* jg, const char* s) { emit_indent(jg); str_append(&jg->out, s); str_append(&jg->out, "\n"); }
 
-static void push_scope(JG* jg) {
-    jg->scopes = (SymTab*)realloc(jg->scopes, (size_t)(jg->scope_count + 1) * sizeof(SymTab));
-    memset(&jg->scopes[jg->scope_count], 0, sizeof(SymTab));
-    jg->scope_count++;
-}
-static void pop_scope(JG* jg) {
-    if (jg->scope_count <= 0) return;
-    jg->scope_count--;
-    symtab_free(&jg->scopes[jg->scope_count]);
-}
-
-static JType* lookup_var(JG* jg, const char* name) {
-    for (int i = jg->scope_count - 1; i >= 0; i--) {
-        JType* t = symtab_lookup(&jg->scopes[i], name);
-        if (t) return jt_clone(t);
-    }
-    return NULL;
-}
-
-static JType* lookup_func_ret(JG* jg, const char* name) {
-    for (int i = 0; i < jg->func_count; i++) {
-        if (strcmp(jg->funcs[i].name, name) == 0) return jt_clone(jg->funcs[i].ret);
-    }
-    return NULL;
-}
-
-static JType* lookup_struct_field(JG* jg, const char* struct_name, const char* field) {
-    for (int i = 0; i < jg->struct_count; i++) {
-        if (strcmp(jg->structs[i].name, struct_name) == 0) {
-            JType* t = symtab_lookup(&jg->structs[i].fields, field);
-            return t ? jt_clone(t) : NULL;
-        }
-    }
-    return NULL;
-}
-
 /* Génère un nom temporaire unique */
 static void tmp_name(JG* jg, const char* prefix, char* buf, size_t n) {
     snprintf(buf, n, "%s%d", prefix, jg->tmp_id++);
@@ -215,7 +120,7 @@ static JType* ast_to_jtype(ASTNode* t) {
 
     if (t->kind == AST_TYPE_NAMED) {
         JType* j = jt_new(JT_STRUCT);
-        j->struct_name = dupstr(t->as.type_named.name);
+        j->struct_name = t->as.type_named.name;
         return j;
     }
 
@@ -246,67 +151,21 @@ static void emit_type_java(Str* out, JType* t) {
     }
 }
 
-/* Inférence expr (Lire/Ecrire) */
-
-static JType* infer_expr(JG* jg, ASTNode* e) {
-    if (!e) return jt_new(JT_UNKNOWN);
+/* Types des expressions : annotations de l'analyse sémantique */
 
-    switch (e->kind) {
-        case AST_LITERAL_INT: return jt_new(JT_INT);
-        case AST_LITERAL_REAL: return jt_new(JT_DOUBLE);
-        case AST_LITERAL_BOOL: return jt_new(JT_BOOL);
-        case AST_LITERAL_STRING: return jt_new(JT_STRING);
-        case AST_IDENT: {
-            JType* t = lookup_var(jg, e->as.ident.name);
-            return t ? t : jt_new(JT_UNKNOWN);
-        }
-        case AST_UNARY:
-            if (e->as.unary.op == TOK_NON) return jt_new(JT_BOOL);
-            return infer_expr(jg, e->as.unary.expr);
-        case AST_BINARY: {
-            TokenType op = e->as.binary.op;
-            if ((op >= TOK_INFERIEUR && op <= TOK_DIFFERENT) || op == TOK_ET || op == TOK_OU) return jt_new(JT_BOOL);
-            JType* l = infer_expr(jg, e->as.binary.lhs);
-            JType* r = infer_expr(jg, e->as.binary.rhs);
-            if (l->kind == JT_DOUBLE || r->kind == JT_DOUBLE || op == TOK_DIVISE) { jt_free(l); jt_free(r); return jt_new(JT_DOUBLE); }
-            jt_free(l); jt_free(r);
-            return jt_new(JT_INT);
-        }
-        case AST_CALL:
-            if (e->as.call.callee && e->as.call.callee->kind == AST_IDENT) {
-                JType* t = lookup_func_ret(jg, e->as.call.callee->as.ident.name);
-                return t ? t : jt_new(JT_UNKNOWN);
-            }
-            return jt_new(JT_UNKNOWN);
-        case AST_FIELD_ACCESS: {
-            JType* b = infer_expr(jg, e->as.field_access.base);
-            if (b && b->kind == JT_STRUCT && b->struct_name) {
-                JType* f = lookup_struct_field(jg, b->struct_name, e->as.field_access.field);
-                jt_free(b);
-                return f ? f : jt_new(JT_UNKNOWN);
-            }
-            jt_free(b);
-            return jt_new(JT_UNKNOWN);
-        }
-        case AST_INDEX: {
-            JType* b = infer_expr(jg, e->as.index.base);
-            if (b && b->kind == JT_ARRAY && b->elem) {
-                if (b->dims > 1) {
-                    JType* n = jt_clone(b);
-                    n->dims--;
-                    jt_free(b);
-                    return n;
-                } else {
-                    JType* el = jt_clone(b->elem);
-                    jt_free(b);
-                    return el;
-                }
-            }
-            jt_free(b);
-            return jt_new(JT_UNKNOWN);
-        }
-        default:
-            return jt_new(JT_UNKNOWN);
+static JTypeKind kind_expr(ASTNode* e) {
+    if (!e || !e->type) return JT_UNKNOWN;
+    /* '/' donne toujours un double */
+    if (e->kind == AST_BINARY && e->as.binary.op == TOK_DIVISE) return JT_DOUBLE;
+    switch (e->type->kind) {
+        case TY_INT: return JT_INT;
+        case TY_REAL: return JT_DOUBLE;
+        case TY_BOOL: return JT_BOOL;
+        case TY_CHAR: return JT_CHAR;
+        case TY_STRING: return JT_STRING;
+        case TY_STRUCT: return JT_STRUCT;
+        case TY_ARRAY: return JT_ARRAY;
+        default: return JT_UNKNOWN;
     }
 }
 
@@ -367,11 +226,12 @@ static void emit_expr(JG* jg, ASTNode* e) {
 
         case AST_BINARY:
             if (e->as.binary.op == TOK_PUISSANCE) {
-                str_append(&jg->out, "Math.pow(");
+                /* '^' entre entiers : int, comme le type de l'analyse */
+                str_append(&jg->out, (kind_expr(e) == JT_INT) ? "((int)Math.pow(" : "Math.pow(");
                 emit_expr(jg, e->as.binary.lhs);
                 str_append(&jg->out, ", ");
                 emit_expr(jg, e->as.binary.rhs);
-                str_append(&jg->out, ")");
+                str_append(&jg->out, (kind_expr(e) == JT_INT) ? "))" : ")");
             } else {
                 str_append(&jg->out, "(");
                 emit_expr(jg, e->as.binary.lhs);
@@ -470,8 +330,8 @@ static void record_global_struct_array_init(JG* jg, const char* name, const char
     }
 
     int i = jg->g_arr_init_count++;
-    jg->g_arr_inits[i].name = dupstr(name);
-    jg->g_arr_inits[i].struct_name = dupstr(struct_name);
+    jg->g_arr_inits[i].name = name;
+    jg->g_arr_inits[i].struct_name = struct_name;
     jg->g_arr_inits[i].dim_count = dims->count;
 
     jg->g_arr_inits[i].dims = calloc((size_t)dims->count, sizeof(ASTNode*));
@@ -498,8 +358,6 @@ static void emit_decl(JG* jg, ASTNode* d, bool is_global) {
         t = arr;
     }
 
-    symtab_add(&jg->scopes[jg->scope_count - 1], name, t);
-
     emit_indent(jg);
     if (is_global) str_append(&jg->out, "static ");
     if (is_const) str_append(&jg->out, "final ");
@@ -582,20 +440,19 @@ static void emit_write(JG* jg, ASTNode* s) {
 }
 
 static void emit_read_one(JG* jg, ASTNode* target) {
-    JType* t = infer_expr(jg, target);
+    JTypeKind k = kind_expr(target);
 
     emit_indent(jg);
     emit_expr(jg, target);
     str_append(&jg->out, " = ");
 
-    if (t->kind == JT_INT) str_append(&jg->out, "_sc.nextInt()");
-    else if (t->kind == JT_DOUBLE) str_append(&jg->out, "_sc.nextDouble()");
-    else if (t->kind == JT_BOOL) str_append(&jg->out, "_sc.nextBoolean()"); /* sans _readBool */
-    else if (t->kind == JT_CHAR) str_append(&jg->out, "_sc.next().charAt(0)");
+    if (k == JT_INT) str_append(&jg->out, "_sc.nextInt()");
+    else if (k == JT_DOUBLE) str_append(&jg->out, "_sc.nextDouble()");
+    else if (k == JT_BOOL) str_append(&jg->out, "_sc.nextBoolean()"); /* sans _readBool */
+    else if (k == JT_CHAR) str_append(&jg->out, "_sc.next().charAt(0)");
     else str_append(&jg->out, "_sc.next()");
 
     str_append(&jg->out, ";\n");
-    jt_free(t);
 }
 
 static void emit_stmt(JG* jg, ASTNode* s) {
@@ -765,7 +622,6 @@ static void emit_stmt(JG* jg, ASTNode* s) {
 static void emit_block(JG* jg, ASTNode* b) {
     str_append(&jg->out, "{\n");
     jg->indent++;
-    push_scope(jg);
 
     if (b) {
         for (int i = 0; i < b->as.block.stmts.count; i++) {
@@ -781,7 +637,6 @@ static void emit_block(JG* jg, ASTNode* b) {
         }
     }
 
-    pop_scope(jg);
     jg->indent--;
     emit_indent(jg);
     str_append(&jg->out, "}\n");
@@ -789,26 +644,6 @@ static void emit_block(JG* jg, ASTNode* b) {
 
 /* Structs / funcs / programme */
 
-static void predeclare(JG* jg, ASTNode* program) {
-    jg->funcs = calloc((size_t)program->as.program.defs.count, sizeof(*jg->funcs));
-    jg->structs = calloc((size_t)program->as.program.defs.count, sizeof(*jg->structs));
-
-    for (int i = 0; i < program->as.program.defs.count; i++) {
-        ASTNode* d = program->as.program.defs.items[i];
-        if (!d) continue;
-
-        if (d->kind == AST_DEF_FUNC) {
-            int k = jg->func_count++;
-            jg->funcs[k].name = dupstr(d->as.def_func.name);
-            jg->funcs[k].ret = ast_to_jtype(d->as.def_func.return_type);
-        } else if (d->kind == AST_DEF_PROC) {
-            int k = jg->func_count++;
-            jg->funcs[k].name = dupstr(d->as.def_proc.name);
-            jg->funcs[k].ret = jt_new(JT_UNKNOWN);
-        }
-    }
-}
-
 static void emit_structs(JG* jg, ASTNode* program) {
     bool has_structs = false;
     for (int i = 0; i < program->as.program.defs.count; i++) {
@@ -822,9 +657,6 @@ static void emit_structs(JG* jg, ASTNode* program) {
         ASTNode* d = program->as.program.defs.items[i];
         if (!d || d->kind != AST_DEF_STRUCT) continue;
 
-        int idx = jg->struct_count++;
-        jg->structs[idx].name = dupstr(d->as.def_struct.name);
-
         emit_indent(jg);
         str_printf(&jg->out, "static class %s {\n", d->as.def_struct.name);
         jg->indent++;
@@ -834,7 +666,6 @@ static void emit_structs(JG* jg, ASTNode* program) {
             if (!f || f->kind != AST_FIELD) continue;
 
             JType* ft = ast_to_jtype(f->as.field.type);
-            symtab_add(&jg->structs[idx].fields, f->as.field.name, ft);
 
             emit_indent(jg);
             emit_type_java(&jg->out, ft);
@@ -898,13 +729,10 @@ static void emit_funcproc(JG* jg, ASTNode* def) {
 
     str_printf(&jg->out, " %s(", name);
 
-    push_scope(jg);
-
     for (int i = 0; i < params->count; i++) {
         if (i > 0) str_append(&jg->out, ", ");
         ASTNode* p = params->items[i];
         JType* pt = ast_to_jtype(p->as.param.type);
-        symtab_add(&jg->scopes[jg->scope_count - 1], p->as.param.name, pt);
         emit_type_java(&jg->out, pt);
         str_printf(&jg->out, " %s", p->as.param.name);
         jt_free(pt);
@@ -912,8 +740,6 @@ static void emit_funcproc(JG* jg, ASTNode* def) {
 
     str_append(&jg->out, ") ");
     emit_block(jg, body);
-
-    pop_scope(jg);
     emit_ln(jg, "");
 }
 
@@ -948,9 +774,6 @@ bool jgen_generate(ASTNode* program, const char* out_path) {
     jg.class_name = "Main";
     jg.tmp_id = 0;
 
-    push_scope(&jg);
-    predeclare(&jg, program);
-
     emit_ln(&jg, "import java.util.*;");
     emit_ln(&jg, "");
     str_printf(&jg.out, "public class %s {\n", jg.class_name);
@@ -982,7 +805,6 @@ bool jgen_generate(ASTNode* program, const char* out_path) {
 
     emit_ln(&jg, "public static void main(String[] args) {");
     jg.indent++;
-    push_scope(&jg);
 
     jg.tmp_id = 0;
 
@@ -1001,7 +823,6 @@ bool jgen_generate(ASTNode* program, const char* out_path) {
         }
     }
 
-    pop_scope(&jg);
     jg.indent--;
     emit_ln(&jg, "}");
 
@@ -1015,26 +836,10 @@ bool jgen_generate(ASTNode* program, const char* out_path) {
 
     str_free(&jg.out);
 
-    for (int i = 0; i < jg.struct_count; i++) {
-        free(jg.structs[i].name);
-        symtab_free(&jg.structs[i].fields);
-    }
-    for (int i = 0; i < jg.func_count; i++) {
-        free(jg.funcs[i].name);
-        jt_free(jg.funcs[i].ret);
-    }
-    free(jg.structs);
-    free(jg.funcs);
-
     for (int i = 0; i < jg.g_arr_init_count; i++) {
-        free(jg.g_arr_inits[i].name);
-        free(jg.g_arr_inits[i].struct_name);
         free(jg.g_arr_inits[i].dims);
     }
     free(jg.g_arr_inits);
 
-    while (jg.scope_count > 0) pop_scope(&jg);
-    free(jg.scopes);
-
     return true;
 }
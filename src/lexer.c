@@ -1,4 +1,6 @@
 #include "lexer.h"
+#include "lexer_simd.h"
+#include "lexer_par.h"
 #include "token.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,6 +10,8 @@
 
 // PROTOTYPES DES FONCTIONS STATIQUES
 
+static char* copier_chaine(const char* s);
+
 static bool est_fin_source(Lexer* lexer);
 static char caractere_courant(Lexer* lexer);
 static char caractere_suivant(Lexer* lexer, int offset);
@@ -18,15 +22,16 @@ static bool est_blanc(char c);
 static bool est_chiffre(char c);
 static bool est_lettre(char c);
 
-static void ajouter_token(Lexer* lexer, TokenType type, const char* valeur);
+static void ajouter_token(Lexer* lexer, TokenType type, const char* debut, int longueur);
+static void ajouter_symbole(Lexer* lexer, TokenType type, int n);
 static void ajouter_message_erreur(Lexer* lexer, const char* message);
 static void ajouter_erreur_lexicale(Lexer* lexer, TokenType type_erreur,
-                                   const char* valeur, const char* message);
+                                   const char* debut, int longueur, const char* message);
 
 static void ignorer_espaces(Lexer* lexer);
 static void ignorer_espaces_sans_nl(Lexer* lexer);
 
-static TokenType trouver_mot_cle(const char* mot, TokenType* type_erreur);
+static TokenType trouver_mot_cle(const char* mot, int len, TokenType* type_erreur);
 
 static void lire_identifiant(Lexer* lexer);
 static void lire_nombre(Lexer* lexer);
@@ -41,37 +46,47 @@ static bool doit_generer_fin_instr(Lexer* lexer);
 
 // FONCTIONS STATIQUES AUXILIAIRES
 
+// strdup n'est pas C99 : copie locale, comme sdup() dans semantique.c
+static char* copier_chaine(const char* s) {
+    if (!s) s = "";
+    size_t n = strlen(s);
+    char* r = (char*)malloc(n + 1);
+    if (!r) return NULL;
+    memcpy(r, s, n + 1);
+    return r;
+}
+
 static bool est_fin_source(Lexer* lexer) {
-    return lexer->position >= (int)strlen(lexer->source);
+    return lexer->courant >= lexer->fin;
 }
 
 static char caractere_courant(Lexer* lexer) {
-    if (est_fin_source(lexer)) return '\0';
-    return lexer->source[lexer->position];
+    if (lexer->courant >= lexer->fin) return '\0';
+    return *lexer->courant;
 }
 
 static char caractere_suivant(Lexer* lexer, int offset) {
-    int pos = lexer->position + offset;
-    if (pos >= (int)strlen(lexer->source)) return '\0';
-    return lexer->source[pos];
+    if (lexer->fin - lexer->courant <= offset) return '\0';
+    return lexer->courant[offset];
 }
 
 static char caractere_precedent(Lexer* lexer) {
-    int pos = lexer->position - 1;
-    if (pos < 0) return '\0';
-    return lexer->source[pos];
+    if (lexer->courant <= lexer->source) return '\0';
+    return lexer->courant[-1];
 }
 
+// Avance de n octets. Les lignes ne sont pas comptées ici : la position
+// d'un token est retrouvée à partir de son offset (lignes.c).
 static void avancer(Lexer* lexer, int n) {
-    for (int i = 0; i < n; i++) {
-        if (caractere_courant(lexer) == '\n') {
-            lexer->ligne++;
-            lexer->colonne = 1;
-        } else {
-            lexer->colonne++;
-        }
-        lexer->position++;
-    }
+    if (n > lexer->fin - lexer->courant) n = (int)(lexer->fin - lexer->courant);
+    lexer->courant += n;
+}
+
+// Longueur du plus long préfixe de [p, fin) dont les octets vérifient le prédicat
+static int longueur_tant_que(const char* p, const char* fin, bool (*pred)(char)) {
+    const char* q = p;
+    while (q < fin && pred(*q)) q++;
+    return (int)(q - p);
 }
 
 static bool est_blanc(char c) {
@@ -99,7 +114,25 @@ static bool est_lettre(char c) {
     return false;
 }
 
+static bool est_car_identifiant(char c) {
+    return est_lettre(c) || est_chiffre(c) || c == '\'' || c == '-';
+}
+
+static bool est_car_mot(char c) {
+    return est_lettre(c) || c == '\'' || c == '-';
+}
+
+static bool est_blanc_sans_nl(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
 // MOTS-CLES
+//
+// Une seule entrée par mot-clé, sous forme "repliée" : minuscules ASCII,
+// accents latins retirés ("Début", "debut", "DÉBUT" -> "debut").
+// La reconnaissance replie le lexème puis consulte une table de hachage
+// parfaite (construite au premier appel à partir de MOTS_CLES) : au plus
+// un memcmp par identifiant.
 
 typedef struct {
     const char* mot;
@@ -109,310 +142,377 @@ typedef struct {
 
 static const MotCle MOTS_CLES[] = {
     // 1. Structure
-    {"Algorithme", TOK_ALGORITHME, TOK_ALGORITHME_ERR},
     {"algorithme", TOK_ALGORITHME, TOK_ALGORITHME_ERR},
-    {"Début", TOK_DEBUT, TOK_DEBUT_ERR},
     {"debut", TOK_DEBUT, TOK_DEBUT_ERR},
-    {"Fin", TOK_FIN, TOK_FIN_ERR},
     {"fin", TOK_FIN, TOK_FIN_ERR},
 
     // 2. Déclarations / types
-    {"Objets", TOK_OBJETS, TOK_OBJETS_ERR},
     {"objets", TOK_OBJETS, TOK_OBJETS_ERR},
-    {"Variable", TOK_VARIABLE, TOK_VARIABLE_ERR},
     {"variable", TOK_VARIABLE, TOK_VARIABLE_ERR},
-    {"Constante", TOK_CONSTANTE, TOK_CONSTANTE_ERR},
     {"constante", TOK_CONSTANTE, TOK_CONSTANTE_ERR},
 
     {"entier", TOK_ENTIER, TOK_ENTIER_ERR},
-    {"réel", TOK_REEL, TOK_REEL_ERR},
     {"reel", TOK_REEL, TOK_REEL_ERR},
-    {"caractère", TOK_CARACTERE, TOK_CARACTERE_ERR},
     {"caractere", TOK_CARACTERE, TOK_CARACTERE_ERR},
     {"chaine", TOK_CHAINE, TOK_CHAINE_ERR},
-    {"chaîne", TOK_CHAINE, TOK_CHAINE_ERR},
-    {"booléen", TOK_BOOLEEN, TOK_BOOLEEN_ERR},
     {"booleen", TOK_BOOLEEN, TOK_BOOLEEN_ERR},
     {"tableau", TOK_TABLEAU, TOK_TABLEAU_ERR},
-    {"Tableau", TOK_TABLEAU, TOK_TABLEAU_ERR},
 
     {"de", TOK_DE, TOK_DE_ERR},
 
-    {"Structure", TOK_STRUCTURE, TOK_STRUCTURE_ERR},
     {"structure", TOK_STRUCTURE, TOK_STRUCTURE_ERR},
-    {"Fin-struct", TOK_FIN_STRUCT, TOK_FIN_STRUCT_ERR},
     {"fin-struct", TOK_FIN_STRUCT, TOK_FIN_STRUCT_ERR},
     {"finstruct", TOK_FIN_STRUCT, TOK_FIN_STRUCT_ERR},
 
     // 3. IO
-    {"Ecrire", TOK_ECRIRE, TOK_ECRIRE_ERR},
     {"ecrire", TOK_ECRIRE, TOK_ECRIRE_ERR},
-    {"Lire", TOK_LIRE, TOK_LIRE_ERR},
     {"lire", TOK_LIRE, TOK_LIRE_ERR},
-    {"Retour", TOK_RETOUR, TOK_RETOUR_ERR},
     {"retour", TOK_RETOUR, TOK_RETOUR_ERR},
 
     // 4. Logique
-    {"Vrai", TOK_VRAI, TOK_VRAI_ERR},
     {"vrai", TOK_VRAI, TOK_VRAI_ERR},
-    {"Faux", TOK_FAUX, TOK_FAUX_ERR},
     {"faux", TOK_FAUX, TOK_FAUX_ERR},
-    {"Et", TOK_ET, TOK_ET_ERR},
     {"et", TOK_ET, TOK_ET_ERR},
-    {"Ou", TOK_OU, TOK_OU_ERR},
     {"ou", TOK_OU, TOK_OU_ERR},
-    {"Non", TOK_NON, TOK_NON_ERR},
     {"non", TOK_NON, TOK_NON_ERR},
 
     // 7. Op arithm mots
-    {"Div", TOK_DIV_ENTIER, TOK_DIV_ENTIER_ERR},
     {"div", TOK_DIV_ENTIER, TOK_DIV_ENTIER_ERR},
-    {"Mod", TOK_MODULO, TOK_MODULO_ERR},
     {"mod", TOK_MODULO, TOK_MODULO_ERR},
 
     // 8. Contrôle
-    {"Si", TOK_SI, TOK_SI_ERR},
     {"si", TOK_SI, TOK_SI_ERR},
-    {"SinonSi", TOK_SINONSI, TOK_SINONSI_ERR},
     {"sinonsi", TOK_SINONSI, TOK_SINONSI_ERR},
     {"sinon-si", TOK_SINONSI, TOK_SINONSI_ERR},
-    {"Sinon", TOK_SINON, TOK_SINON_ERR},
     {"sinon", TOK_SINON, TOK_SINON_ERR},
-    {"Alors", TOK_ALORS, TOK_ALORS_ERR},
     {"alors", TOK_ALORS, TOK_ALORS_ERR},
-    {"FinSi", TOK_FIN_SI, TOK_FIN_SI_ERR},
     {"finsi", TOK_FIN_SI, TOK_FIN_SI_ERR},
 
-    {"Selon", TOK_SELON, TOK_SELON_ERR},
     {"selon", TOK_SELON, TOK_SELON_ERR},
-    {"Cas", TOK_CAS, TOK_CAS_ERR},
     {"cas", TOK_CAS, TOK_CAS_ERR},
-
-    {"Défaut", TOK_DEFAUT, TOK_DEFAUT_ERR},
-    {"défaut", TOK_DEFAUT, TOK_DEFAUT_ERR},
     {"defaut", TOK_DEFAUT, TOK_DEFAUT_ERR},
-    {"Defaut", TOK_DEFAUT, TOK_DEFAUT_ERR},
-
-    {"FinSelon", TOK_FIN_SELON, TOK_FIN_SELON_ERR},
     {"finselon", TOK_FIN_SELON, TOK_FIN_SELON_ERR},
 
-    {"Sortir", TOK_SORTIR, TOK_SORTIR_ERR},
     {"sortir", TOK_SORTIR, TOK_SORTIR_ERR},
 
-    {"Pour", TOK_POUR, TOK_POUR_ERR},
     {"pour", TOK_POUR, TOK_POUR_ERR},
 
-    {"jusqu'à", TOK_JUSQUA, TOK_JUSQUA_ERR},
+    {"jusqu'a", TOK_JUSQUA, TOK_JUSQUA_ERR},
     {"jusqua", TOK_JUSQUA, TOK_JUSQUA_ERR},
-    {"Jusqua", TOK_JUSQUA, TOK_JUSQUA_ERR},
-    {"JusquA", TOK_JUSQUA, TOK_JUSQUA_ERR},
-    {"JUSQUA", TOK_JUSQUA, TOK_JUSQUA_ERR},
 
-    {"Répéter", TOK_REPETER, TOK_REPETER_ERR},
     {"repeter", TOK_REPETER, TOK_REPETER_ERR},
-    {"répéter", TOK_REPETER, TOK_REPETER_ERR},
 
     {"pas", TOK_PAS, TOK_PAS_ERR},
 
-    {"FinPour", TOK_FIN_POUR, TOK_FIN_POUR_ERR},
     {"finpour", TOK_FIN_POUR, TOK_FIN_POUR_ERR},
 
-    {"Quitter", TOK_QUITTER_POUR, TOK_QUITTER_POUR_ERR},
     {"quitter", TOK_QUITTER_POUR, TOK_QUITTER_POUR_ERR},
 
-    {"TantQue", TOK_TANTQUE, TOK_TANTQUE_ERR},
     {"tantque", TOK_TANTQUE, TOK_TANTQUE_ERR},
-    {"FinTantQue", TOK_FINTANTQUE, TOK_FINTANTQUE_ERR},
     {"fintantque", TOK_FINTANTQUE, TOK_FINTANTQUE_ERR},
 
     // 9. Proc / fct
-    {"Procédure", TOK_PROCEDURE, TOK_PROCEDURE_ERR},
     {"procedure", TOK_PROCEDURE, TOK_PROCEDURE_ERR},
-    {"FinProc", TOK_FIN_PROC, TOK_FIN_PROC_ERR},
     {"finproc", TOK_FIN_PROC, TOK_FIN_PROC_ERR},
-    {"Fonction", TOK_FONCTION, TOK_FONCTION_ERR},
     {"fonction", TOK_FONCTION, TOK_FONCTION_ERR},
-    {"FinFonct", TOK_FIN_FONCT, TOK_FIN_FONCT_ERR},
     {"finfonct", TOK_FIN_FONCT, TOK_FIN_FONCT_ERR},
-    {"Retourner", TOK_RETOURNER, TOK_RETOURNER_ERR},
     {"retourner", TOK_RETOURNER, TOK_RETOURNER_ERR},
 
     {NULL, TOK_ID, TOK_ID_ERR}
 };
 
+#define MOT_CLE_LONGUEUR_MAX 16
+#define MOT_CLE_TAILLE_TABLE 128
+
+// Hachage sur (longueur, 2 premiers octets, dernier octet) de la forme
+// repliée. Constantes choisies pour être sans collision sur MOTS_CLES ;
+// vérifié par initialiser_mots_cles().
+static unsigned hacher_mot_cle(const char* mot, int len) {
+    return (2u * (unsigned)len
+            + (unsigned char)mot[0]
+            + 15u * (unsigned char)mot[1]
+            + 17u * (unsigned char)mot[len - 1]) & (MOT_CLE_TAILLE_TABLE - 1);
+}
+
+static signed char TABLE_MOTS_CLES[MOT_CLE_TAILLE_TABLE];
+static unsigned char LONGUEURS_MOTS_CLES[sizeof(MOTS_CLES) / sizeof(MOTS_CLES[0])];
+static bool mots_cles_initialises = false;
+
+static void initialiser_mots_cles(void) {
+    if (mots_cles_initialises) return;
+
+    memset(TABLE_MOTS_CLES, -1, sizeof(TABLE_MOTS_CLES));
+    for (int i = 0; MOTS_CLES[i].mot != NULL; i++) {
+        int len = (int)strlen(MOTS_CLES[i].mot);
+        unsigned h = hacher_mot_cle(MOTS_CLES[i].mot, len);
+        if (TABLE_MOTS_CLES[h] >= 0 || len > MOT_CLE_LONGUEUR_MAX) {
+            fprintf(stderr, "Erreur interne : collision de hachage pour le mot-clé '%s'\n",
+                    MOTS_CLES[i].mot);
+            abort();
+        }
+        TABLE_MOTS_CLES[h] = (signed char)i;
+        LONGUEURS_MOTS_CLES[i] = (unsigned char)len;
+    }
+    mots_cles_initialises = true;
+}
+
+// Repli d'un octet de continuation UTF-8 après 0xC3 (Latin-1 : À..ÿ).
+// 0 = lettre sans équivalent ASCII (le mot ne peut pas être un mot-clé).
+static char replier_latin1(unsigned char c) {
+    switch (c) {
+        case 0x80: case 0x82: case 0x84: case 0xA0: case 0xA2: case 0xA4: return 'a';
+        case 0x87: case 0xA7: return 'c';
+        case 0x88: case 0x89: case 0x8A: case 0x8B:
+        case 0xA8: case 0xA9: case 0xAA: case 0xAB: return 'e';
+        case 0x8E: case 0x8F: case 0xAE: case 0xAF: return 'i';
+        case 0x94: case 0x96: case 0xB4: case 0xB6: return 'o';
+        case 0x99: case 0x9B: case 0x9C: case 0xB9: case 0xBB: case 0xBC: return 'u';
+        default: return 0;
+    }
+}
+
+// Écrit dans dest la forme repliée de [mot, mot+len). Retourne sa longueur,
+// ou -1 si le mot ne peut pas être un mot-clé.
+static int replier_mot(const char* mot, int len, char* dest) {
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)mot[i];
+        if (n >= MOT_CLE_LONGUEUR_MAX) return -1;
+
+        if (c >= 'A' && c <= 'Z') {
+            dest[n++] = (char)(c - 'A' + 'a');
+        } else if (c < 0x80) {
+            dest[n++] = (char)c;
+        } else if (c == 0xC3 && i + 1 < len) {
+            char r = replier_latin1((unsigned char)mot[++i]);
+            if (!r) return -1;
+            dest[n++] = r;
+        } else {
+            return -1;
+        }
+    }
+    return n;
+}
+
 // AJOUT TOKEN / ERREUR
+//
+// Un token ne copie pas son texte : il référence [debut, debut + longueur)
+// dans la source. Aucune allocation par token hors agrandissement des
+// tableaux ; 9 octets par token (type, offset, longueur).
+
+bool lexer_reserver_tokens(Lexer* lexer, int nb) {
+    if (nb <= lexer->capacite_tokens) return true;
+
+    int ncap = lexer->capacite_tokens * 2;
+    if (ncap < nb) ncap = nb;
+
+    uint8_t* types = realloc(lexer->types, (size_t)ncap * sizeof(uint8_t));
+    if (!types) return false;
+    lexer->types = types;
+
+    uint32_t* debuts = realloc(lexer->debuts, (size_t)ncap * sizeof(uint32_t));
+    if (!debuts) return false;
+    lexer->debuts = debuts;
+
+    uint32_t* longueurs = realloc(lexer->longueurs, (size_t)ncap * sizeof(uint32_t));
+    if (!longueurs) return false;
+    lexer->longueurs = longueurs;
+
+    lexer->capacite_tokens = ncap;
+    return true;
+}
+
+static void ajouter_token(Lexer* lexer, TokenType type, const char* debut, int longueur) {
+    if (lexer->mode_flux) {
+        // Fenêtre circulaire : lexer_peek() garantit qu'il reste une place
+        int i = (lexer->fenetre_debut + lexer->fenetre_nb) % LEXER_TAILLE_FENETRE;
+        Token* token = &lexer->fenetre[i];
+        lexer->fenetre_nb++;
+
+        token->type = type;
+        token->debut = (int)(debut - lexer->source);
+        token->longueur = longueur;
+        token->ligne = 0;
+        token->colonne = 0;
+    } else {
+        if (!lexer_reserver_tokens(lexer, lexer->nb_tokens + 1)) return;
 
-static void ajouter_token(Lexer* lexer, TokenType type, const char* valeur) {
-    if (lexer->nb_tokens >= lexer->capacite_tokens) {
-        lexer->capacite_tokens *= 2;
-        Token* tmp = realloc(lexer->tokens, lexer->capacite_tokens * sizeof(Token));
-        if (!tmp) return;
-        lexer->tokens = tmp;
+        int i = lexer->nb_tokens++;
+        lexer->types[i] = (uint8_t)type;
+        lexer->debuts[i] = (uint32_t)(debut - lexer->source);
+        lexer->longueurs[i] = (uint32_t)longueur;
     }
 
-    Token* token = &lexer->tokens[lexer->nb_tokens++];
-    token->type = type;
-    token->valeur = strdup(valeur ? valeur : "");
-    token->ligne = lexer->ligne;
-    token->colonne = lexer->colonne - (int)strlen(valeur ? valeur : "");
-    if (token->colonne < 1) token->colonne = 1;
+    lexer->nb_emis++;
+    lexer->dernier_type = type;
+}
+
+// Symbole de n octets à la position courante : on avance puis on l'ajoute
+static void ajouter_symbole(Lexer* lexer, TokenType type, int n) {
+    avancer(lexer, n);
+    ajouter_token(lexer, type, lexer->courant - n, n);
+}
+
+bool lexer_reserver_erreurs(Lexer* lexer, int nb) {
+    if (nb <= lexer->capacite_erreurs) return true;
+
+    int ncap = lexer->capacite_erreurs * 2;
+    if (ncap < nb) ncap = nb;
+
+    char** textes = realloc(lexer->textes_erreur, (size_t)ncap * sizeof(char*));
+    if (!textes) return false;
+    lexer->textes_erreur = textes;
+
+    char** messages = realloc(lexer->messages_erreur, (size_t)ncap * sizeof(char*));
+    if (!messages) return false;
+    lexer->messages_erreur = messages;
+
+    uint32_t* offsets = realloc(lexer->offsets_erreur, (size_t)ncap * sizeof(uint32_t));
+    if (!offsets) return false;
+    lexer->offsets_erreur = offsets;
+
+    lexer->capacite_erreurs = ncap;
+    return true;
 }
 
+// Le message est gardé tel quel avec l'offset courant ; la position
+// est ajoutée par formater_erreurs() au moment de l'affichage.
 static void ajouter_message_erreur(Lexer* lexer, const char* message) {
-    if (lexer->nb_erreurs >= lexer->capacite_erreurs) {
-        lexer->capacite_erreurs *= 2;
-        char** tmp = realloc(lexer->messages_erreur, lexer->capacite_erreurs * sizeof(char*));
-        if (!tmp) return;
-        lexer->messages_erreur = tmp;
-    }
+    if (!lexer_reserver_erreurs(lexer, lexer->nb_erreurs + 1)) return;
+
+    int i = lexer->nb_erreurs++;
+    lexer->offsets_erreur[i] = (uint32_t)(lexer->courant - lexer->source);
+    lexer->textes_erreur[i] = copier_chaine(message);
+    lexer->messages_erreur[i] = NULL;
+}
+
+static void formater_erreurs(Lexer* lexer) {
+    for (; lexer->nb_erreurs_formatees < lexer->nb_erreurs; lexer->nb_erreurs_formatees++) {
+        int i = lexer->nb_erreurs_formatees;
+        int ligne, colonne;
+        lignes_position(&lexer->lignes, lexer->offsets_erreur[i], &ligne, &colonne);
 
-    char buffer[512];
-    snprintf(buffer, sizeof(buffer), "%s:%d:%d: %s",
-             lexer->nom_fichier, lexer->ligne, lexer->colonne, message);
+        char buffer[512];
+        snprintf(buffer, sizeof(buffer), "%s:%d:%d: %s",
+                 lexer->nom_fichier, ligne, colonne, lexer->textes_erreur[i]);
+
+        lexer->messages_erreur[i] = copier_chaine(buffer);
+        if (!lexer->messages_erreur[i]) return;
+    }
+}
 
-    lexer->messages_erreur[lexer->nb_erreurs++] = strdup(buffer);
+// Les positions changent après une modification du texte
+static void oublier_messages_formates(Lexer* lexer) {
+    for (int i = 0; i < lexer->nb_erreurs_formatees; i++) {
+        free(lexer->messages_erreur[i]);
+        lexer->messages_erreur[i] = NULL;
+    }
+    lexer->nb_erreurs_formatees = 0;
 }
 
 static void ajouter_erreur_lexicale(Lexer* lexer, TokenType type_erreur,
-                                   const char* valeur, const char* message) {
-    ajouter_token(lexer, type_erreur, valeur ? valeur : "");
+                                   const char* debut, int longueur, const char* message) {
+    ajouter_token(lexer, type_erreur, debut, longueur);
     ajouter_message_erreur(lexer, message ? message : "Erreur lexicale");
-    (void)lexer;
 }
 
 // ESPACES / FIN INSTRUCTION
 
 static bool doit_generer_fin_instr(Lexer* lexer) {
-    if (lexer->nb_tokens == 0) return false;
+    // Tranche : la règle est appliquée au recollage
+    if (lexer->tranche) return true;
+
+    if (lexer->nb_emis == 0) return false;
 
     // Pas de FIN_INSTR à l'intérieur de () ou []
     if (lexer->paren_depth > 0 || lexer->bracket_depth > 0) return false;
 
-    Token* dernier = &lexer->tokens[lexer->nb_tokens - 1];
-    if (dernier->type == TOK_FIN_INSTR) return false;
+    if (lexer->dernier_type == TOK_FIN_INSTR) return false;
 
     return true;
 }
 
 static void ignorer_espaces(Lexer* lexer) {
-    while (!est_fin_source(lexer) && est_blanc(caractere_courant(lexer))) {
-        if (caractere_courant(lexer) == '\n') {
-            if (doit_generer_fin_instr(lexer)) {
-                ajouter_token(lexer, TOK_FIN_INSTR, "");
-            }
+    const char* fin_blancs = lexer->noyaux->sauter_blancs(lexer->courant, lexer->fin);
+    const char* nl = lexer->noyaux->chercher_nl(lexer->courant, fin_blancs);
+
+    // Au plus un FIN_INSTR par suite de blancs, sur le premier \n : une fois
+    // ajouté, le dernier token est FIN_INSTR ; sinon les conditions de
+    // doit_generer_fin_instr() ne changent pas jusqu'au prochain token.
+    if (nl < fin_blancs) {
+        avancer(lexer, (int)(nl - lexer->courant));
+        if (doit_generer_fin_instr(lexer)) {
+            ajouter_token(lexer, TOK_FIN_INSTR, lexer->courant, 0);
         }
-        avancer(lexer, 1);
     }
+    avancer(lexer, (int)(fin_blancs - lexer->courant));
 }
 
 // Utile pour "Quitter Pour" : on ne saute pas les \n
 static void ignorer_espaces_sans_nl(Lexer* lexer) {
-    while (!est_fin_source(lexer)) {
-        char c = caractere_courant(lexer);
-        if (c == ' ' || c == '\t' || c == '\r') {
-            avancer(lexer, 1);
-        } else {
-            break;
-        }
-    }
+    avancer(lexer, longueur_tant_que(lexer->courant, lexer->fin, est_blanc_sans_nl));
 }
 
 // MOTS-CLES
 
-static TokenType trouver_mot_cle(const char* mot, TokenType* type_erreur) {
-    for (int i = 0; MOTS_CLES[i].mot != NULL; i++) {
-        if (strcmp(MOTS_CLES[i].mot, mot) == 0) {
-            if (type_erreur) *type_erreur = MOTS_CLES[i].type_erreur;
-            return MOTS_CLES[i].type_normal;
-        }
+static TokenType trouver_mot_cle(const char* mot, int len, TokenType* type_erreur) {
+    char replie[MOT_CLE_LONGUEUR_MAX];
+    int n = replier_mot(mot, len, replie);
+    if (n < 2) return TOK_ID;
+
+    int i = TABLE_MOTS_CLES[hacher_mot_cle(replie, n)];
+    if (i < 0 || LONGUEURS_MOTS_CLES[i] != n || memcmp(MOTS_CLES[i].mot, replie, (size_t)n) != 0) {
+        return TOK_ID;
     }
-    return TOK_ID;
+
+    if (type_erreur) *type_erreur = MOTS_CLES[i].type_erreur;
+    return MOTS_CLES[i].type_normal;
 }
 
 // LECTURE IDENTIFIANT
 
 static void lire_identifiant(Lexer* lexer) {
-    int start_pos = lexer->position;
-    int start_col = lexer->colonne;
-
-    while (!est_fin_source(lexer) &&
-           (est_lettre(caractere_courant(lexer)) ||
-            est_chiffre(caractere_courant(lexer)) ||
-            caractere_courant(lexer) == '_' ||
-            caractere_courant(lexer) == '\'' ||
-            caractere_courant(lexer) == '-')) {
-        avancer(lexer, 1);
-    }
-
-    int length = lexer->position - start_pos;
-    char* lexeme = (char*)malloc(length + 1);
-    strncpy(lexeme, &lexer->source[start_pos], length);
-    lexeme[length] = '\0';
+    const char* debut = lexer->courant;
+    int length = longueur_tant_que(debut, lexer->fin, est_car_identifiant);
+    avancer(lexer, length);
 
     TokenType type_erreur;
-    TokenType type = trouver_mot_cle(lexeme, &type_erreur);
+    TokenType type = trouver_mot_cle(debut, length, &type_erreur);
 
     // Traitement spécial "Quitter Pour"
     if (type == TOK_QUITTER_POUR) {
         ignorer_espaces_sans_nl(lexer);
 
-        int sauvegarde_pos = lexer->position;
-        int sauvegarde_ligne = lexer->ligne;
-        int sauvegarde_col = lexer->colonne;
+        const char* sauvegarde_pos = lexer->courant;
 
         // Lire le mot suivant
-        int wstart = lexer->position;
-        while (!est_fin_source(lexer) &&
-               (est_lettre(caractere_courant(lexer)) || caractere_courant(lexer) == '\'' || caractere_courant(lexer) == '-')) {
-            avancer(lexer, 1);
-        }
-        int wlen = lexer->position - wstart;
-
-        char* suivant = (char*)malloc(wlen + 1);
-        strncpy(suivant, &lexer->source[wstart], wlen);
-        suivant[wlen] = '\0';
-
-        if (strcmp(suivant, "Pour") == 0 || strcmp(suivant, "pour") == 0) {
-            char* combi = (char*)malloc(strlen(lexeme) + strlen(suivant) + 2);
-            sprintf(combi, "%s %s", lexeme, suivant);
-            ajouter_token(lexer, TOK_QUITTER_POUR, combi);
-            free(combi);
-            free(suivant);
-            free(lexeme);
+        const char* wstart = lexer->courant;
+        int wlen = longueur_tant_que(wstart, lexer->fin, est_car_mot);
+        avancer(lexer, wlen);
+
+        if (wlen == 4 && (memcmp(wstart, "Pour", 4) == 0 || memcmp(wstart, "pour", 4) == 0)) {
+            // Le lexème couvre "Quitter ... Pour" tel qu'écrit dans la source
+            ajouter_token(lexer, TOK_QUITTER_POUR, debut, (int)(lexer->courant - debut));
             return;
         }
 
         // Sinon : retour en arrière (on garde juste "Quitter")
-        lexer->position = sauvegarde_pos;
-        lexer->ligne = sauvegarde_ligne;
-        lexer->colonne = sauvegarde_col;
-
-        free(suivant);
+        lexer->courant = sauvegarde_pos;
         // Ici on laisse "Quitter" comme TOK_QUITTER_POUR (design actuel).
     }
 
-    if (type != TOK_ID) {
-        ajouter_token(lexer, type, lexeme);
-    } else {
-        ajouter_token(lexer, TOK_ID, lexeme);
-    }
-
-    free(lexeme);
-
-    (void)start_col;
+    ajouter_token(lexer, type, debut, length);
 }
 
 // LECTURE NOMBRE : 1,5 ET 1.5
 
 static void lire_nombre(Lexer* lexer) {
-    int start_pos = lexer->position;
+    const char* debut = lexer->courant;
     bool est_reel = false;
     bool erreur = false;
 
     // Partie entière
-    while (!est_fin_source(lexer) && est_chiffre(caractere_courant(lexer))) {
-        avancer(lexer, 1);
-    }
+    avancer(lexer, longueur_tant_que(lexer->courant, lexer->fin, est_chiffre));
 
     // Décimal: ',' ou '.' uniquement si suivi d'un chiffre
     char c = caractere_courant(lexer);
@@ -423,45 +523,29 @@ static void lire_nombre(Lexer* lexer) {
         avancer(lexer, 1);
 
         // Partie fractionnaire
-        while (!est_fin_source(lexer) && est_chiffre(caractere_courant(lexer))) {
-            avancer(lexer, 1);
-        }
+        avancer(lexer, longueur_tant_que(lexer->courant, lexer->fin, est_chiffre));
     }
 
-    int length = lexer->position - start_pos;
-    char* nombre = (char*)malloc((size_t)length + 1);
-    strncpy(nombre, &lexer->source[start_pos], (size_t)length);
-    nombre[length] = '\0';
+    int length = (int)(lexer->courant - debut);
 
     if (length == 0) erreur = true;
 
     if (erreur) {
-        if (est_reel) ajouter_erreur_lexicale(lexer, TOK_CONST_REEL_ERR, nombre, "Constante réelle invalide");
-        else ajouter_erreur_lexicale(lexer, TOK_CONST_ENTIERE_ERR, nombre, "Constante entière invalide");
+        if (est_reel) ajouter_erreur_lexicale(lexer, TOK_CONST_REEL_ERR, debut, length, "Constante réelle invalide");
+        else ajouter_erreur_lexicale(lexer, TOK_CONST_ENTIERE_ERR, debut, length, "Constante entière invalide");
     } else {
-        if (est_reel) ajouter_token(lexer, TOK_CONST_REEL, nombre);
-        else ajouter_token(lexer, TOK_CONST_ENTIERE, nombre);
+        if (est_reel) ajouter_token(lexer, TOK_CONST_REEL, debut, length);
+        else ajouter_token(lexer, TOK_CONST_ENTIERE, debut, length);
     }
-
-    free(nombre);
 }
 
 // Lecture d'un réel du type ".5"
 static void lire_nombre_commence_par_point(Lexer* lexer) {
-    int start_pos = lexer->position; // sur '.'
+    const char* debut = lexer->courant; // sur '.'
     avancer(lexer, 1);
+    avancer(lexer, longueur_tant_que(lexer->courant, lexer->fin, est_chiffre));
 
-    while (!est_fin_source(lexer) && est_chiffre(caractere_courant(lexer))) {
-        avancer(lexer, 1);
-    }
-
-    int length = lexer->position - start_pos;
-    char* nombre = (char*)malloc(length + 1);
-    strncpy(nombre, &lexer->source[start_pos], length);
-    nombre[length] = '\0';
-
-    ajouter_token(lexer, TOK_CONST_REEL, nombre);
-    free(nombre);
+    ajouter_token(lexer, TOK_CONST_REEL, debut, (int)(lexer->courant - debut));
 }
 
 // CHAÎNES / COMMENTAIRES
@@ -470,90 +554,56 @@ static void lire_chaine(Lexer* lexer) {
     char delimiteur = caractere_courant(lexer);
     avancer(lexer, 1);
 
-    int start_pos = lexer->position;
-    bool escape = false;
-
-    while (!est_fin_source(lexer)) {
-        if (escape) {
-            escape = false;
-            avancer(lexer, 1);
-            continue;
-        }
-
-        if (caractere_courant(lexer) == '\\') {
-            escape = true;
-            avancer(lexer, 1);
-            continue;
-        }
-
-        if (caractere_courant(lexer) == delimiteur) {
-            break;
-        }
-
-        if (caractere_courant(lexer) == '\n') {
-            break;
-        }
+    const char* debut = lexer->courant;
+    const char* p = debut;
 
-        avancer(lexer, 1);
+    // Un échappement consomme l'octet suivant, y compris un \n
+    while ((p = lexer->noyaux->chercher_chaine(p, lexer->fin, delimiteur)) < lexer->fin &&
+           *p == '\\') {
+        p += (p + 1 < lexer->fin) ? 2 : 1;
     }
+    avancer(lexer, (int)(p - debut));
 
-    int length = lexer->position - start_pos;
-    char* contenu = (char*)malloc(length + 1);
-    strncpy(contenu, &lexer->source[start_pos], length);
-    contenu[length] = '\0';
+    int length = (int)(p - debut);
 
     if (est_fin_source(lexer) || caractere_courant(lexer) != delimiteur) {
-        ajouter_erreur_lexicale(lexer, TOK_CONST_CHAINE_ERR, contenu, "Chaîne non fermée");
-        free(contenu);
+        ajouter_erreur_lexicale(lexer, TOK_CONST_CHAINE_ERR, debut, length, "Chaîne non fermée");
         return;
     }
 
-    ajouter_token(lexer, TOK_CONST_CHAINE, contenu);
-    free(contenu);
+    ajouter_token(lexer, TOK_CONST_CHAINE, debut, length);
 
     avancer(lexer, 1);
 }
 
+// Le token d'un commentaire commence à "//" ou "/*" : sa position est
+// celle du commentaire dans la source
+
 static void lire_commentaire_ligne(Lexer* lexer) {
+    const char* debut = lexer->courant;
     avancer(lexer, 2); // "//"
-    int start_pos = lexer->position;
 
-    while (!est_fin_source(lexer) && caractere_courant(lexer) != '\n') {
-        avancer(lexer, 1);
-    }
+    int length = (int)(lexer->noyaux->chercher_nl(lexer->courant, lexer->fin) - debut);
+    avancer(lexer, length - 2);
 
-    int length = lexer->position - start_pos;
-    char* commentaire = (char*)malloc(length + 1);
-    strncpy(commentaire, &lexer->source[start_pos], length);
-    commentaire[length] = '\0';
-    ajouter_token(lexer, TOK_COMMENTAIRE, commentaire);
-    free(commentaire);
+    ajouter_token(lexer, TOK_COMMENTAIRE, debut, length);
 }
 
 static void lire_commentaire_bloc(Lexer* lexer) {
+    const char* debut = lexer->courant;
     avancer(lexer, 2); // "/*"
-    int start_pos = lexer->position;
 
-    while (!est_fin_source(lexer)) {
-        if (caractere_courant(lexer) == '*' && caractere_suivant(lexer, 1) == '/') {
-            break;
-        }
-        avancer(lexer, 1);
-    }
+    const char* etoile = lexer->noyaux->chercher_fin_commentaire(lexer->courant, lexer->fin);
 
-    if (est_fin_source(lexer)) {
-        ajouter_erreur_lexicale(lexer, TOK_COMMENTAIRES_ERR, "", "Commentaire bloc non fermé");
+    if (etoile >= lexer->fin) {
+        avancer(lexer, (int)(lexer->fin - lexer->courant));
+        ajouter_erreur_lexicale(lexer, TOK_COMMENTAIRES_ERR, lexer->courant, 0, "Commentaire bloc non fermé");
         return;
     }
 
-    int length = lexer->position - start_pos;
-    char* commentaire = (char*)malloc(length + 1);
-    strncpy(commentaire, &lexer->source[start_pos], length);
-    commentaire[length] = '\0';
-    ajouter_token(lexer, TOK_COMMENTAIRES, commentaire);
-    free(commentaire);
+    avancer(lexer, (int)(etoile - lexer->courant) + 2); // "*/" compris
 
-    avancer(lexer, 2); // "*/"
+    ajouter_token(lexer, TOK_COMMENTAIRES, debut, (int)(lexer->courant - debut));
 }
 
 // OPÉRATEURS / SYMBOLES
@@ -571,48 +621,38 @@ static void traiter_operateurs(Lexer* lexer) {
     switch (courant) {
         case '<':
             if (suivant == '-') {
-                avancer(lexer, 2);
-                ajouter_token(lexer, TOK_AFFECTATION, "<-");
+                ajouter_symbole(lexer, TOK_AFFECTATION, 2);
             } else if (suivant == '=') {
-                avancer(lexer, 2);
-                ajouter_token(lexer, TOK_INFERIEUR_EGAL, "<=");
+                ajouter_symbole(lexer, TOK_INFERIEUR_EGAL, 2);
             } else if (suivant == '>') {
-                avancer(lexer, 2);
-                ajouter_token(lexer, TOK_DIFFERENT, "<>");
+                ajouter_symbole(lexer, TOK_DIFFERENT, 2);
             } else {
-                avancer(lexer, 1);
-                ajouter_token(lexer, TOK_INFERIEUR, "<");
+                ajouter_symbole(lexer, TOK_INFERIEUR, 1);
             }
             break;
 
         case '>':
             if (suivant == '=') {
-                avancer(lexer, 2);
-                ajouter_token(lexer, TOK_SUPERIEUR_EGAL, ">=");
+                ajouter_symbole(lexer, TOK_SUPERIEUR_EGAL, 2);
             } else {
-                avancer(lexer, 1);
-                ajouter_token(lexer, TOK_SUPERIEUR, ">");
+                ajouter_symbole(lexer, TOK_SUPERIEUR, 1);
             }
             break;
 
         case '=':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_EGAL, "=");
+            ajouter_symbole(lexer, TOK_EGAL, 1);
             break;
 
         case '+':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_PLUS, "+");
+            ajouter_symbole(lexer, TOK_PLUS, 1);
             break;
 
         case '-':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_MOINS, "-");
+            ajouter_symbole(lexer, TOK_MOINS, 1);
             break;
 
         case '*':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_FOIS, "*");
+            ajouter_symbole(lexer, TOK_FOIS, 1);
             break;
 
         case '/':
@@ -621,48 +661,40 @@ static void traiter_operateurs(Lexer* lexer) {
             } else if (suivant == '*') {
                 lire_commentaire_bloc(lexer);
             } else {
-                avancer(lexer, 1);
-                ajouter_token(lexer, TOK_DIVISE, "/");
+                ajouter_symbole(lexer, TOK_DIVISE, 1);
             }
             break;
 
         case '^':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_PUISSANCE, "^");
+            ajouter_symbole(lexer, TOK_PUISSANCE, 1);
             break;
 
         case ':':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_DEUX_POINTS, ":");
+            ajouter_symbole(lexer, TOK_DEUX_POINTS, 1);
             break;
 
         case ',':
-            avancer(lexer, 1);
-            ajouter_token(lexer, TOK_VIRGULE, ",");
+            ajouter_symbole(lexer, TOK_VIRGULE, 1);
             break;
 
         case '(':
-            avancer(lexer, 1);
             lexer->paren_depth++;
-            ajouter_token(lexer, TOK_PAREN_OUVRANTE, "(");
+            ajouter_symbole(lexer, TOK_PAREN_OUVRANTE, 1);
             break;
 
         case ')':
-            avancer(lexer, 1);
             if (lexer->paren_depth > 0) lexer->paren_depth--;
-            ajouter_token(lexer, TOK_PAREN_FERMANTE, ")");
+            ajouter_symbole(lexer, TOK_PAREN_FERMANTE, 1);
             break;
 
         case '[':
-            avancer(lexer, 1);
             lexer->bracket_depth++;
-            ajouter_token(lexer, TOK_CROCHET_OUVRANT, "[");
+            ajouter_symbole(lexer, TOK_CROCHET_OUVRANT, 1);
             break;
 
         case ']':
-            avancer(lexer, 1);
             if (lexer->bracket_depth > 0) lexer->bracket_depth--;
-            ajouter_token(lexer, TOK_CROCHET_FERMANT, "]");
+            ajouter_symbole(lexer, TOK_CROCHET_FERMANT, 1);
             break;
 
         case '.':
@@ -670,8 +702,7 @@ static void traiter_operateurs(Lexer* lexer) {
             if (est_chiffre(suivant) && !est_chiffre(caractere_precedent(lexer))) {
                 lire_nombre_commence_par_point(lexer);
             } else {
-                avancer(lexer, 1);
-                ajouter_token(lexer, TOK_POINT, ".");
+                ajouter_symbole(lexer, TOK_POINT, 1);
             }
             break;
 
@@ -681,8 +712,7 @@ static void traiter_operateurs(Lexer* lexer) {
                      "Caractère inconnu: '%c' (0x%02x)",
                      courant, (unsigned char)courant);
 
-            char tmp[2] = {courant, '\0'};
-            ajouter_erreur_lexicale(lexer, TOK_ID_ERR, tmp, msg);
+            ajouter_erreur_lexicale(lexer, TOK_ID_ERR, lexer->courant, 1, msg);
             avancer(lexer, 1);
             break;
         }
@@ -691,103 +721,436 @@ static void traiter_operateurs(Lexer* lexer) {
 
 // API PUBLIQUE
 
-Lexer* creer_lexer(const char* source, const char* nom_fichier) {
+Lexer* creer_lexer(const char* source, size_t longueur, const char* nom_fichier) {
+    if (longueur > INT32_MAX) return NULL;
+
     Lexer* lexer = (Lexer*)malloc(sizeof(Lexer));
     if (!lexer) return NULL;
 
+    initialiser_mots_cles();
+    lexer->noyaux = simd_noyaux();
+
     lexer->source = source;
-    lexer->position = 0;
-    lexer->ligne = 1;
-    lexer->colonne = 1;
+    lexer->source_possedee = NULL;
+    lexer->longueur = source ? longueur : 0;
+    lexer->courant = lexer->source;
+    lexer->fin = lexer->source + lexer->longueur;
 
     lexer->nb_tokens = 0;
     lexer->capacite_tokens = 256;
-    lexer->tokens = (Token*)malloc(lexer->capacite_tokens * sizeof(Token));
+    lexer->types = (uint8_t*)malloc(lexer->capacite_tokens * sizeof(uint8_t));
+    lexer->debuts = (uint32_t*)malloc(lexer->capacite_tokens * sizeof(uint32_t));
+    lexer->longueurs = (uint32_t*)malloc(lexer->capacite_tokens * sizeof(uint32_t));
+
+    lignes_init(&lexer->lignes, lexer->source, lexer->longueur, lexer->noyaux);
 
     lexer->nb_erreurs = 0;
+    lexer->nb_erreurs_formatees = 0;
     lexer->capacite_erreurs = 16;
+    lexer->textes_erreur = (char**)malloc(lexer->capacite_erreurs * sizeof(char*));
     lexer->messages_erreur = (char**)malloc(lexer->capacite_erreurs * sizeof(char*));
+    lexer->offsets_erreur = (uint32_t*)malloc(lexer->capacite_erreurs * sizeof(uint32_t));
 
-    lexer->nom_fichier = strdup(nom_fichier ? nom_fichier : "stdin");
+    lexer->nom_fichier = copier_chaine(nom_fichier ? nom_fichier : "stdin");
     lexer->mode_strict = false;
 
     lexer->paren_depth = 0;
     lexer->bracket_depth = 0;
 
+    lexer->nb_emis = 0;
+    lexer->dernier_type = TOK_EOF;
+    lexer->termine = false;
+
+    lexer->mode_flux = false;
+    lexer->fenetre_debut = 0;
+    lexer->fenetre_nb = 0;
+
+    lexer->tranche = false;
+
     return lexer;
 }
 
 void detruire_lexer(Lexer* lexer) {
     if (!lexer) return;
 
-    for (int i = 0; i < lexer->nb_tokens; i++) {
-        free(lexer->tokens[i].valeur);
-    }
-    free(lexer->tokens);
+    free(lexer->types);
+    free(lexer->debuts);
+    free(lexer->longueurs);
+    lignes_liberer(&lexer->lignes);
 
+    oublier_messages_formates(lexer);
     for (int i = 0; i < lexer->nb_erreurs; i++) {
-        free(lexer->messages_erreur[i]);
+        free(lexer->textes_erreur[i]);
     }
+    free(lexer->textes_erreur);
     free(lexer->messages_erreur);
+    free(lexer->offsets_erreur);
 
+    free(lexer->source_possedee);
     free(lexer->nom_fichier);
     free(lexer);
 }
 
+// Une étape d'analyse : produit au plus un token (EOF compris)
+static void analyser_etape(Lexer* lexer) {
+    if (est_fin_source(lexer)) {
+        if (!lexer->termine) {
+            if (lexer->fin == lexer->source + lexer->longueur) {
+                ajouter_token(lexer, TOK_EOF, lexer->courant, 0);
+            }
+            lexer->termine = true;
+        }
+        return;
+    }
+
+    char courant = caractere_courant(lexer);
+
+    if (est_blanc(courant)) {
+        ignorer_espaces(lexer);
+    } else if (est_chiffre(courant)) {
+        lire_nombre(lexer);
+    } else if (est_lettre(courant)) {
+        lire_identifiant(lexer);
+    } else {
+        traiter_operateurs(lexer);
+    }
+}
+
 bool analyser_lexicalement(Lexer* lexer) {
-    if (!lexer || !lexer->source) return false;
+    if (!lexer || !lexer->source || lexer->mode_flux) return false;
+
+    if (!lexer->tranche && lexer->nb_emis == 0) {
+        int nb_threads = lexer_par_nb_threads(lexer->longueur);
+        if (nb_threads > 1 && analyser_en_parallele(lexer, nb_threads)) {
+            return lexer->nb_erreurs == 0;
+        }
+    }
+
+    while (!lexer->termine) {
+        analyser_etape(lexer);
+    }
+    return lexer->nb_erreurs == 0;
+}
+
+// PRÉ-BALAYAGE POUR L'ANALYSE PARALLÈLE
+//
+// Ne suit que ce qui peut traverser un '\n' ou en masquer un : commentaires
+// et chaînes (un échappement peut consommer un '\n'). Le noyau
+// chercher_special saute tout le reste.
+//
+// Une apostrophe ne commence une chaîne qu'en début de token : dans un
+// identifiant ("jusqu'a"), elle en fait partie. C'est rare : on relit
+// alors la zone depuis le dernier début de token sûr (début de ligne, fin
+// de chaîne ou de commentaire) en reconnaissant les identifiants, y
+// compris "Quitter Pour" qui s'arrête après "Pour" ("Quitter Pour1'x'"
+// est suivi d'un nombre puis d'une chaîne).
+
+static bool est_dans_identifiant(const char* zone, const char* p, const char* fin) {
+    const char* q = zone;
+    while (q < p) {
+        if (!est_lettre(*q)) { q++; continue; }
+
+        const char* ident = q;
+        q += longueur_tant_que(q, fin, est_car_identifiant);
+        if (q > p) return true;
+
+        // "quitter" replié : 7 à 14 octets
+        int len = (int)(q - ident);
+        if (len >= 7 && len <= 14 && trouver_mot_cle(ident, len, NULL) == TOK_QUITTER_POUR) {
+            const char* w = q + longueur_tant_que(q, fin, est_blanc_sans_nl);
+            int wlen = longueur_tant_que(w, fin, est_car_mot);
+            if (wlen == 4 && (memcmp(w, "Pour", 4) == 0 || memcmp(w, "pour", 4) == 0)) {
+                q = w + 4;
+            }
+        }
+    }
+    return false;
+}
+
+int lexer_choisir_coupures(const Lexer* lexer, int nb_tranches, size_t* coupures) {
+    const char* src = lexer->source;
+    const char* fin = lexer->fin;
+    size_t longueur = (size_t)(fin - src);
+
+    int n = 0;
+    coupures[n++] = 0;
+    size_t cible = longueur / (size_t)nb_tranches;
 
-    while (!est_fin_source(lexer)) {
-        char courant = caractere_courant(lexer);
+    const char* p = src;
+    const char* zone = src;     // début de token sûr
 
-        if (est_blanc(courant)) {
-            ignorer_espaces(lexer);
-            continue;
+    while (n < nb_tranches && (p = lexer->noyaux->chercher_special(p, fin)) < fin) {
+        char c = *p;
+
+        if (c == '\n') {
+            if ((size_t)(p - src) >= cible) {
+                coupures[n++] = (size_t)(p + 1 - src);
+                cible = longueur / (size_t)nb_tranches * (size_t)n;
+            }
+            zone = ++p;
+        } else if (c == '/') {
+            if (p + 1 < fin && p[1] == '/') {
+                p = lexer->noyaux->chercher_nl(p + 2, fin);
+            } else if (p + 1 < fin && p[1] == '*') {
+                const char* etoile = lexer->noyaux->chercher_fin_commentaire(p + 2, fin);
+                zone = p = (etoile >= fin) ? fin : etoile + 2;
+            } else {
+                p++;
+            }
+        } else if (c == '\'' && est_dans_identifiant(zone, p, fin)) {
+            p++;
+        } else {
+            // Comme lire_chaine() : arrêt sur le délimiteur ou un '\n' non échappé
+            const char* q = p + 1;
+            while ((q = lexer->noyaux->chercher_chaine(q, fin, c)) < fin && *q == '\\') {
+                q += (q + 1 < fin) ? 2 : 1;
+            }
+            zone = p = (q < fin && *q == c) ? q + 1 : q;
         }
+    }
 
-        if (est_chiffre(courant)) {
-            lire_nombre(lexer);
-            continue;
+    if (coupures[n - 1] < longueur) coupures[n++] = longueur;
+    return n - 1;
+}
+
+// RÉ-ANALYSE INCRÉMENTALE
+//
+// Reprise : le dernier FIN_INSTR placé avant la modification. Il n'est
+// produit que sur un '\n' hors commentaire et hors chaîne, en dehors de
+// () et [] : l'état du lexer y est connu (profondeurs nulles, dernier
+// token FIN_INSTR) et les tokens qui précèdent ne dépendent pas de la
+// suite. Aucun état n'a donc à être sauvegardé token par token.
+//
+// Resynchronisation : le premier FIN_INSTR produit dans le texte inchangé
+// qui correspond (offset décalé) à un FIN_INSTR de l'ancien tableau. Même
+// position, même état : tous les tokens suivants sont identiques, au
+// décalage près.
+
+// Premier token d'offset >= offset dans [debut, nb_tokens)
+static int premier_token_depuis(const Lexer* lexer, int debut, uint32_t offset) {
+    int bas = debut, haut = lexer->nb_tokens;
+    while (bas < haut) {
+        int milieu = bas + (haut - bas) / 2;
+        if (lexer->debuts[milieu] < offset) bas = milieu + 1;
+        else haut = milieu;
+    }
+    return bas;
+}
+
+// Premier message d'offset > offset (>= si inclus)
+static int premiere_erreur_apres(const Lexer* lexer, uint32_t offset, bool inclus) {
+    int i = 0;
+    while (i < lexer->nb_erreurs &&
+           (lexer->offsets_erreur[i] < offset || (!inclus && lexer->offsets_erreur[i] == offset))) {
+        i++;
+    }
+    return i;
+}
+
+bool lexer_modifier(Lexer* lexer, size_t offset, size_t nb_supprimes,
+                    const char* insere, size_t nb_inseres, PlageTokens* plage) {
+    if (!lexer || lexer->mode_flux || !lexer->termine) return false;
+    if (offset > lexer->longueur || nb_supprimes > lexer->longueur - offset) return false;
+    if (nb_inseres > 0 && !insere) return false;
+
+    size_t nouvelle_longueur = lexer->longueur - nb_supprimes + nb_inseres;
+    if (nouvelle_longueur > INT32_MAX) return false;
+    long long decalage = (long long)nb_inseres - (long long)nb_supprimes;
+
+    char* texte = (char*)malloc(nouvelle_longueur + 1);
+    if (!texte) return false;
+    memcpy(texte, lexer->source, offset);
+    if (nb_inseres > 0) memcpy(texte + offset, insere, nb_inseres);
+    memcpy(texte + offset + nb_inseres, lexer->source + offset + nb_supprimes,
+           lexer->longueur - offset - nb_supprimes);
+    texte[nouvelle_longueur] = '\0';
+
+    // Reprise : dernier FIN_INSTR strictement avant la modification
+    int reprise = premier_token_depuis(lexer, 0, (uint32_t)offset) - 1;
+    while (reprise >= 0 && lexer->types[reprise] != TOK_FIN_INSTR) reprise--;
+    uint32_t offset_reprise = (reprise >= 0) ? lexer->debuts[reprise] : 0;
+
+    Lexer* t = creer_lexer(texte, nouvelle_longueur, lexer->nom_fichier);
+    if (!t) { free(texte); return false; }
+    t->courant = texte + offset_reprise;
+    if (reprise >= 0) {
+        t->nb_emis = reprise + 1;
+        t->dernier_type = TOK_FIN_INSTR;
+    }
+
+    // Relecture jusqu'à la resynchronisation (ou la fin)
+    size_t fin_modif = offset + nb_inseres;
+    int resync = -1;
+    while (!t->termine) {
+        int avant = t->nb_tokens;
+        analyser_etape(t);
+
+        int dernier = t->nb_tokens - 1;
+        if (t->nb_tokens == avant || t->types[dernier] != TOK_FIN_INSTR) continue;
+        if (t->debuts[dernier] < fin_modif) continue;
+
+        uint32_t ancien = (uint32_t)((long long)t->debuts[dernier] - decalage);
+        int k = premier_token_depuis(lexer, reprise + 1, ancien);
+        if (k < lexer->nb_tokens && lexer->debuts[k] == ancien &&
+            lexer->types[k] == TOK_FIN_INSTR) {
+            resync = k;
+            t->nb_tokens--;
+            break;
         }
+    }
+
+    // Erreurs remplacées : après la reprise, jusqu'à la resynchronisation
+    int err_debut = (reprise >= 0) ? premiere_erreur_apres(lexer, offset_reprise, false) : 0;
+    int err_fin = (resync >= 0) ? premiere_erreur_apres(lexer, lexer->debuts[resync], false)
+                                : lexer->nb_erreurs;
+
+    int premier = reprise + 1;
+    int suite = (resync >= 0) ? lexer->nb_tokens - resync : 0;
+    int nb_total = premier + t->nb_tokens + suite;
+    int err_suite = lexer->nb_erreurs - err_fin;
+    int err_total = err_debut + t->nb_erreurs + err_suite;
+
+    if (!lexer_reserver_tokens(lexer, nb_total) || !lexer_reserver_erreurs(lexer, err_total)) {
+        detruire_lexer(t);
+        free(texte);
+        return false;
+    }
+
+    if (plage) {
+        plage->premier = premier;
+        plage->nb_retires = ((resync >= 0) ? resync : lexer->nb_tokens) - premier;
+        plage->nb_ajoutes = t->nb_tokens;
+    }
 
-        if (est_lettre(courant)) {
-            lire_identifiant(lexer);
-            continue;
+    // Tokens : la suite est déplacée et décalée, puis les nouveaux insérés
+    int dest = premier + t->nb_tokens;
+    if (suite > 0) {
+        memmove(lexer->types + dest, lexer->types + resync, (size_t)suite * sizeof(uint8_t));
+        memmove(lexer->debuts + dest, lexer->debuts + resync, (size_t)suite * sizeof(uint32_t));
+        memmove(lexer->longueurs + dest, lexer->longueurs + resync, (size_t)suite * sizeof(uint32_t));
+        for (int i = dest; i < dest + suite; i++) {
+            lexer->debuts[i] = (uint32_t)((long long)lexer->debuts[i] + decalage);
         }
+    }
+    memcpy(lexer->types + premier, t->types, (size_t)t->nb_tokens * sizeof(uint8_t));
+    memcpy(lexer->debuts + premier, t->debuts, (size_t)t->nb_tokens * sizeof(uint32_t));
+    memcpy(lexer->longueurs + premier, t->longueurs, (size_t)t->nb_tokens * sizeof(uint32_t));
+    lexer->nb_tokens = nb_total;
+
+    // Erreurs : même schéma, les textes changent de propriétaire
+    oublier_messages_formates(lexer);
+    for (int i = err_debut; i < err_fin; i++) free(lexer->textes_erreur[i]);
+    int err_dest = err_debut + t->nb_erreurs;
+    if (err_suite > 0) {
+        memmove(lexer->textes_erreur + err_dest, lexer->textes_erreur + err_fin,
+                (size_t)err_suite * sizeof(char*));
+        memmove(lexer->offsets_erreur + err_dest, lexer->offsets_erreur + err_fin,
+                (size_t)err_suite * sizeof(uint32_t));
+        for (int i = err_dest; i < err_dest + err_suite; i++) {
+            lexer->offsets_erreur[i] = (uint32_t)((long long)lexer->offsets_erreur[i] + decalage);
+        }
+    }
+    for (int i = 0; i < t->nb_erreurs; i++) {
+        lexer->textes_erreur[err_debut + i] = t->textes_erreur[i];
+        lexer->offsets_erreur[err_debut + i] = t->offsets_erreur[i];
+    }
+    t->nb_erreurs = 0;
+    lexer->nb_erreurs = err_total;
+
+    // État final : inchangé après une resynchronisation
+    if (resync < 0) {
+        lexer->paren_depth = t->paren_depth;
+        lexer->bracket_depth = t->bracket_depth;
+        lexer->dernier_type = t->dernier_type;
+    }
+    lexer->nb_emis = nb_total;
+    detruire_lexer(t);
+
+    // Nouveau texte
+    free(lexer->source_possedee);
+    lexer->source_possedee = texte;
+    lexer->source = texte;
+    lexer->longueur = nouvelle_longueur;
+    lexer->fin = texte + nouvelle_longueur;
+    lexer->courant = lexer->fin;
+    lignes_liberer(&lexer->lignes);
+    lignes_init(&lexer->lignes, lexer->source, lexer->longueur, lexer->noyaux);
 
-        traiter_operateurs(lexer);
+    return true;
+}
+
+// LECTURE EN FLUX
+
+void lexer_activer_flux(Lexer* lexer) {
+    if (lexer && lexer->nb_emis == 0) lexer->mode_flux = true;
+}
+
+const Token* lexer_peek(Lexer* lexer, int k) {
+    if (k < 0) k = 0;
+    if (k > LEXER_TAILLE_FENETRE - 1) k = LEXER_TAILLE_FENETRE - 1;
+
+    while (lexer->fenetre_nb <= k && !lexer->termine) {
+        analyser_etape(lexer);
     }
 
-    ajouter_token(lexer, TOK_EOF, "");
-    return lexer->nb_erreurs == 0;
+    // Au-delà de EOF, on renvoie EOF
+    if (lexer->fenetre_nb <= k) k = lexer->fenetre_nb - 1;
+    return &lexer->fenetre[(lexer->fenetre_debut + k) % LEXER_TAILLE_FENETRE];
 }
 
-Token* obtenir_tokens(Lexer* lexer, int* nb_tokens) {
+Token lexer_next_token(Lexer* lexer) {
+    Token t = *lexer_peek(lexer, 0);
+
+    // EOF reste dans la fenêtre : les appels suivants le renvoient encore
+    if (t.type != TOK_EOF) {
+        lexer->fenetre_debut = (lexer->fenetre_debut + 1) % LEXER_TAILLE_FENETRE;
+        lexer->fenetre_nb--;
+    }
+    return t;
+}
+
+const uint8_t* obtenir_types_tokens(Lexer* lexer, int* nb_tokens) {
     if (nb_tokens) *nb_tokens = lexer->nb_tokens;
-    return lexer->tokens;
+    return lexer->types;
+}
+
+Token lexer_token(Lexer* lexer, int i) {
+    Token t;
+    t.type = (TokenType)lexer->types[i];
+    t.debut = (int)lexer->debuts[i];
+    t.longueur = (int)lexer->longueurs[i];
+    lexer_positionner(lexer, &t);
+    return t;
+}
+
+void lexer_positionner(Lexer* lexer, Token* token) {
+    lignes_position(&lexer->lignes, (size_t)token->debut, &token->ligne, &token->colonne);
 }
 
 char** obtenir_messages_erreur(Lexer* lexer, int* nb_erreurs) {
+    formater_erreurs(lexer);
     if (nb_erreurs) *nb_erreurs = lexer->nb_erreurs;
     return lexer->messages_erreur;
 }
 
-void afficher_token(Token* token) {
+const char* texte_token(const Lexer* lexer, const Token* token) {
+    return lexer->source + token->debut;
+}
+
+void afficher_token(const Lexer* lexer, const Token* token) {
     if (!token) return;
 
-    printf("L%03d:C%03d %-20s '%s'\n",
+    printf("L%03d:C%03d %-20s '%.*s'\n",
            token->ligne,
            token->colonne,
            token_to_string(token->type),
-           token->valeur);
+           token->longueur, texte_token(lexer, token));
 }
 
 int compter_tokens_erreur(Lexer* lexer) {
     int count = 0;
     for (int i = 0; i < lexer->nb_tokens; i++) {
-        if (lexer->tokens[i].type % 2 == 1) {
-            count++;
-        }
+        count += lexer->types[i] & 1;
     }
     return count;
 }
@@ -805,8 +1168,9 @@ void afficher_tokens(Lexer* lexer) {
 
     printf("=== Tokens générés (%d) ===\n", lexer->nb_tokens);
     for (int i = 0; i < lexer->nb_tokens; i++) {
+        Token t = lexer_token(lexer, i);
         printf("%4d: ", i);
-        afficher_token(&lexer->tokens[i]);
+        afficher_token(lexer, &t);
     }
 
     int nb_err = compter_tokens_erreur(lexer);
@@ -823,6 +1187,8 @@ void afficher_erreurs(Lexer* lexer) {
         return;
     }
 
+    formater_erreurs(lexer);
+
     printf("=== Erreurs lexicales (%d) ===\n", lexer->nb_erreurs);
     for (int i = 0; i < lexer->nb_erreurs; i++) {
         printf("%s\n", lexer->messages_erreur[i]);
@@ -2,20 +2,47 @@
 #define LEXER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "token.h"
+#include "lexer_simd.h"
+#include "lignes.h"
 
+// Taille de la fenêtre de tokens en mode flux (lookahead max = taille - 1)
+#define LEXER_TAILLE_FENETRE 16
+
+// La source n'est pas copiée : les tokens en référencent des tranches
+// (offset, longueur). Elle appartient à l'appelant et doit rester valide
+// tant que le lexer ou ses tokens sont utilisés.
+//
+// Les tokens sont rangés en structure de tableaux : le parser ne lit que
+// types[] (1 octet par token) ; debuts[] et longueurs[] ne servent qu'à
+// extraire un texte. La ligne et la colonne ne sont pas stockées mais
+// retrouvées à partir de l'offset (voir lignes.h).
 typedef struct {
     const char* source;
-    int position;
-    int ligne;
-    int colonne;
+    char* source_possedee;  // texte issu de lexer_modifier(), libéré avec le lexer
+    size_t longueur;        // longueur de la source, calculée une seule fois
+    const char* courant;    // curseur de lecture
+    const char* fin;        // source + longueur : la fin est testée par pointeur
+    const NoyauxBalayage* noyaux;  // balayage SIMD choisi à l'exécution
 
-    Token* tokens;
+    uint8_t* types;         // TokenType (bit 0 = erreur)
+    uint32_t* debuts;       // offset du lexème dans la source
+    uint32_t* longueurs;
     int nb_tokens;
     int capacite_tokens;
 
+    TableLignes lignes;     // offset -> (ligne, colonne), à la demande
+
+    // Messages d'erreur : texte et offset ; messages_erreur[i] est formaté
+    // "fichier:ligne:colonne: message" au premier affichage, la position
+    // étant alors retrouvée dans lignes
+    char** textes_erreur;
     char** messages_erreur;
+    uint32_t* offsets_erreur;
     int nb_erreurs;
+    int nb_erreurs_formatees;
     int capacite_erreurs;
 
     char* nom_fichier;
@@ -24,22 +51,83 @@ typedef struct {
     // AJOUTS (pour gérer FIN_INSTR correctement)
     int paren_depth;    // profondeur des parenthèses ()
     int bracket_depth;  // profondeur des crochets []
+
+    // État indépendant du stockage des tokens (FIN_INSTR, fin d'analyse)
+    int nb_emis;
+    TokenType dernier_type;
+    bool termine;       // EOF émis
+
+    // Mode flux : les tokens ne sont pas accumulés dans types[]/debuts[]
+    // mais produits à la demande dans une fenêtre circulaire de taille fixe
+    bool mode_flux;
+    Token fenetre[LEXER_TAILLE_FENETRE];
+    int fenetre_debut;
+    int fenetre_nb;
+
+    // Tranche d'une analyse parallèle (lexer_par.c) : [courant, fin) est
+    // une partie de la source, FIN_INSTR est produit comme candidat à
+    // chaque premier '\n' d'une suite de blancs, EOF seulement en fin de
+    // source
+    bool tranche;
 } Lexer;
 
 // API
-Lexer* creer_lexer(const char* source, const char* nom_fichier);
+// source : longueur octets, sans '\0' final obligatoire (moins de 2 Go :
+// les offsets des tokens sont sur 32 bits)
+Lexer* creer_lexer(const char* source, size_t longueur, const char* nom_fichier);
 void detruire_lexer(Lexer* lexer);
 
 bool analyser_lexicalement(Lexer* lexer);
 
-Token* obtenir_tokens(Lexer* lexer, int* nb_tokens);
+// Mode flux (à activer avant toute analyse) : analyser_lexicalement() et
+// lexer_token() ne sont alors plus utilisables. La mémoire des tokens
+// est constante ; les messages d'erreur restent accumulés.
+// Les tokens rendus n'ont pas de position (ligne = colonne = 0) :
+// voir lexer_positionner().
+void lexer_activer_flux(Lexer* lexer);
+Token lexer_next_token(Lexer* lexer);
+// k-ième token à venir (0 = prochain), k < LEXER_TAILLE_FENETRE.
+// Le pointeur n'est valide que jusqu'au prochain lexer_next_token().
+const Token* lexer_peek(Lexer* lexer, int k);
+
+// Types des tokens (un octet par token)
+const uint8_t* obtenir_types_tokens(Lexer* lexer, int* nb_tokens);
+// i-ème token, position comprise
+Token lexer_token(Lexer* lexer, int i);
+// Renseigne token->ligne / token->colonne à partir de token->debut
+void lexer_positionner(Lexer* lexer, Token* token);
+
 char** obtenir_messages_erreur(Lexer* lexer, int* nb_erreurs);
 
-void afficher_token(Token* token);
+// Ré-analyse incrémentale (après analyser_lexicalement(), hors mode flux).
+// Le texte [offset, offset + nb_supprimes) est remplacé par insere : seule
+// la zone touchée est relue, de la dernière fin d'instruction avant la
+// modification jusqu'à ce que les tokens retrouvent ceux de l'ancien
+// tableau ; la suite est conservée avec ses offsets décalés. Le lexer
+// possède ensuite le nouveau texte (lexer->source) ; l'ancien reste à
+// l'appelant. Retourne false si la modification est invalide ou en cas
+// de mémoire insuffisante (le lexer est alors inchangé).
+typedef struct {
+    int premier;        // premier token remplacé
+    int nb_retires;     // tokens de l'ancien tableau remplacés
+    int nb_ajoutes;     // tokens nouveaux à leur place
+} PlageTokens;
+
+bool lexer_modifier(Lexer* lexer, size_t offset, size_t nb_supprimes,
+                    const char* insere, size_t nb_inseres, PlageTokens* plage);
+
+// Texte d'un token (non terminé par '\0' : utiliser token->longueur)
+const char* texte_token(const Lexer* lexer, const Token* token);
+
+void afficher_token(const Lexer* lexer, const Token* token);
 void afficher_tokens(Lexer* lexer);
 void afficher_erreurs(Lexer* lexer);
 int compter_tokens_erreur(Lexer* lexer);
 
 void set_mode_strict(Lexer* lexer, bool strict);
 
+// Capacité des tableaux de tokens et d'erreurs (lexer_par.c)
+bool lexer_reserver_tokens(Lexer* lexer, int nb);
+bool lexer_reserver_erreurs(Lexer* lexer, int nb);
+
 #endif
@@ -0,0 +1,143 @@
+#include "lexer_par.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+int lexer_par_nb_threads(size_t longueur) {
+    if (longueur < LEXER_SEUIL_PARALLELE) return 1;
+
+    // Pas de valeur par défaut tirée du nombre de processeurs : sans
+    // accélération mesurée (tests/lexer_par.sh), l'analyse reste
+    // séquentielle tant qu'ALGO_THREADS_LEXER ne la demande pas. Variable
+    // propre au lexer : ALGO_THREADS (parser, sémantique) ne l'active pas
+    const char* force = getenv("ALGO_THREADS_LEXER");
+    if (!force || !*force) return 1;
+    long n = strtol(force, NULL, 10);
+
+    long max = (long)(longueur / LEXER_TAILLE_MIN_TRANCHE);
+    if (n > max) n = max;
+    if (n > 64) n = 64;
+    return (n < 1) ? 1 : (int)n;
+}
+
+// TRANCHES
+
+static void* analyser_tranche(void* arg) {
+    analyser_lexicalement((Lexer*)arg);
+    return NULL;
+}
+
+static Lexer* creer_tranche(const Lexer* lexer, size_t debut, size_t fin) {
+    Lexer* t = creer_lexer(lexer->source, lexer->longueur, lexer->nom_fichier);
+    if (!t) return NULL;
+
+    t->courant = lexer->source + debut;
+    t->fin = lexer->source + fin;
+    t->tranche = true;
+    return t;
+}
+
+// RECOLLAGE
+//
+// Les tokens des tranches sont recopiés dans l'ordre. Un FIN_INSTR candidat
+// n'est gardé qu'aux conditions de doit_generer_fin_instr() : au moins un
+// token avant, hors () et [], pas juste après un autre FIN_INSTR.
+
+static bool recoller(Lexer* lexer, Lexer** tranches, int nb) {
+    int total = 0;
+    int total_erreurs = 0;
+    for (int i = 0; i < nb; i++) {
+        total += tranches[i]->nb_tokens;
+        total_erreurs += tranches[i]->nb_erreurs;
+    }
+
+    if (!lexer_reserver_tokens(lexer, total) || !lexer_reserver_erreurs(lexer, total_erreurs)) {
+        return false;
+    }
+
+    int n = 0;
+    TokenType dernier = TOK_EOF;
+    int paren_depth = 0;
+    int bracket_depth = 0;
+
+    for (int k = 0; k < nb; k++) {
+        Lexer* t = tranches[k];
+
+        for (int i = 0; i < t->nb_tokens; i++) {
+            TokenType type = (TokenType)t->types[i];
+
+            switch (type) {
+                case TOK_FIN_INSTR:
+                    if (n == 0 || paren_depth > 0 || bracket_depth > 0 ||
+                        dernier == TOK_FIN_INSTR) {
+                        continue;
+                    }
+                    break;
+                case TOK_PAREN_OUVRANTE: paren_depth++; break;
+                case TOK_PAREN_FERMANTE: if (paren_depth > 0) paren_depth--; break;
+                case TOK_CROCHET_OUVRANT: bracket_depth++; break;
+                case TOK_CROCHET_FERMANT: if (bracket_depth > 0) bracket_depth--; break;
+                default: break;
+            }
+
+            lexer->types[n] = t->types[i];
+            lexer->debuts[n] = t->debuts[i];
+            lexer->longueurs[n] = t->longueurs[i];
+            n++;
+            dernier = type;
+        }
+
+        // Les messages changent de propriétaire
+        for (int i = 0; i < t->nb_erreurs; i++) {
+            lexer->textes_erreur[lexer->nb_erreurs] = t->textes_erreur[i];
+            lexer->messages_erreur[lexer->nb_erreurs] = NULL;
+            lexer->offsets_erreur[lexer->nb_erreurs] = t->offsets_erreur[i];
+            lexer->nb_erreurs++;
+        }
+        t->nb_erreurs = 0;
+    }
+
+    lexer->nb_tokens = n;
+    lexer->nb_emis = n;
+    lexer->dernier_type = dernier;
+    lexer->paren_depth = paren_depth;
+    lexer->bracket_depth = bracket_depth;
+    lexer->courant = lexer->fin;
+    lexer->termine = true;
+    return true;
+}
+
+bool analyser_en_parallele(Lexer* lexer, int nb_threads) {
+    size_t* coupures = (size_t*)malloc((size_t)(nb_threads + 1) * sizeof(size_t));
+    Lexer** tranches = (Lexer**)calloc((size_t)nb_threads, sizeof(Lexer*));
+    pthread_t* threads = (pthread_t*)malloc((size_t)nb_threads * sizeof(pthread_t));
+    bool* lances = (bool*)calloc((size_t)nb_threads, sizeof(bool));
+    bool ok = coupures && tranches && threads && lances;
+
+    int nb = ok ? lexer_choisir_coupures(lexer, nb_threads, coupures) : 0;
+
+    for (int i = 0; ok && i < nb; i++) {
+        tranches[i] = creer_tranche(lexer, coupures[i], coupures[i + 1]);
+        if (!tranches[i]) ok = false;
+    }
+
+    // La première tranche est analysée par le thread appelant
+    for (int i = 1; ok && i < nb; i++) {
+        lances[i] = pthread_create(&threads[i], NULL, analyser_tranche, tranches[i]) == 0;
+        if (!lances[i]) analyser_tranche(tranches[i]);
+    }
+    if (ok && nb > 0) analyser_tranche(tranches[0]);
+    for (int i = 1; i < nb; i++) {
+        if (lances[i]) pthread_join(threads[i], NULL);
+    }
+
+    if (ok) ok = recoller(lexer, tranches, nb);
+
+    for (int i = 0; i < nb; i++) detruire_lexer(tranches[i]);
+    free(lances);
+    free(threads);
+    free(tranches);
+    free(coupures);
+
+    return ok;
+}
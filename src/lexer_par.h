@@ -0,0 +1,42 @@
+#ifndef LEXER_PAR_H
+#define LEXER_PAR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "lexer.h"
+
+// Analyse lexicale parallèle des grosses sources.
+//
+// La source est coupée sur des '\n' situés hors commentaire bloc et hors
+// chaîne (un pré-balayage ne suit que ces deux états), chaque tranche est
+// analysée par un thread, puis les tableaux de tokens sont recollés dans
+// l'ordre. Les offsets sont ceux de la source complète : il n'y a rien à
+// recaler, les positions étant calculées à partir des offsets.
+//
+// FIN_INSTR dépend de l'état global (profondeur de () et [], dernier
+// token) : les tranches produisent un candidat sur chaque premier '\n'
+// d'une suite de blancs, et le recollage applique la règle du lexer
+// séquentiel. Le résultat est identique à celui de l'analyse séquentielle.
+
+// Source en dessous de laquelle on reste séquentiel
+#define LEXER_SEUIL_PARALLELE (4u * 1024u * 1024u)
+// Taille minimale d'une tranche
+#define LEXER_TAILLE_MIN_TRANCHE (1u * 1024u * 1024u)
+
+// Nombre de threads pour une source de cette taille (1 = séquentiel).
+// Sur demande seulement : variable d'environnement ALGO_THREADS_LEXER=n
+// (distincte d'ALGO_THREADS, qui règle le parser et la sémantique).
+int lexer_par_nb_threads(size_t longueur);
+
+// Appelée par analyser_lexicalement() sur un lexer neuf. false si
+// l'analyse n'a pas pu être faite (mémoire) : le lexer est alors inchangé
+// et l'appelant poursuit en séquentiel.
+bool analyser_en_parallele(Lexer* lexer, int nb_threads);
+
+// Pré-balayage (lexer.c, mêmes classes de caractères que l'analyse) :
+// coupures[0] = 0, coupures[k] = juste après un '\n' hors commentaire
+// et hors chaîne, proche de k * longueur / nb_tranches,
+// coupures[n] = longueur. Retourne n (<= nb_tranches).
+int lexer_choisir_coupures(const Lexer* lexer, int nb_tranches, size_t* coupures);
+
+#endif
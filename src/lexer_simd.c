@@ -0,0 +1,262 @@
+#include "lexer_simd.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LEXER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// VARIANTE SCALAIRE (référence et repli)
+
+static const char* scalaire_chercher_nl(const char* p, const char* fin) {
+    while (p < fin && *p != '\n') p++;
+    return p;
+}
+
+static const char* scalaire_chercher_fin_commentaire(const char* p, const char* fin) {
+    while (p + 1 < fin) {
+        if (p[0] == '*' && p[1] == '/') return p;
+        p++;
+    }
+    return fin;
+}
+
+static const char* scalaire_chercher_chaine(const char* p, const char* fin, char delimiteur) {
+    while (p < fin && *p != delimiteur && *p != '\\' && *p != '\n') p++;
+    return p;
+}
+
+static const char* scalaire_sauter_blancs(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+static int scalaire_compter_lignes(const char* p, const char* fin, const char** dernier_nl) {
+    int n = 0;
+    for (; p < fin; p++) {
+        if (*p == '\n') {
+            n++;
+            *dernier_nl = p;
+        }
+    }
+    return n;
+}
+
+static const char* scalaire_chercher_special(const char* p, const char* fin) {
+    while (p < fin && *p != '\n' && *p != '/' && *p != '"' && *p != '\'') p++;
+    return p;
+}
+
+static const NoyauxBalayage NOYAUX_SCALAIRE = {
+    "scalaire",
+    scalaire_chercher_nl,
+    scalaire_chercher_fin_commentaire,
+    scalaire_chercher_chaine,
+    scalaire_sauter_blancs,
+    scalaire_compter_lignes,
+    scalaire_chercher_special
+};
+
+#ifdef LEXER_SIMD_X86
+
+// VARIANTE SSE2 : blocs de 16 octets, masque = _mm_movemask_epi8
+
+#define SSE2 __attribute__((target("sse2")))
+
+SSE2 static unsigned sse2_masque(const char* p, char c) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+}
+
+SSE2 static const char* sse2_chercher_nl(const char* p, const char* fin) {
+    for (; fin - p >= 16; p += 16) {
+        unsigned m = sse2_masque(p, '\n');
+        if (m) return p + __builtin_ctz(m);
+    }
+    return scalaire_chercher_nl(p, fin);
+}
+
+SSE2 static const char* sse2_chercher_fin_commentaire(const char* p, const char* fin) {
+    // '*' en p[i] et '/' en p[i + 1] : deux chargements décalés d'un octet
+    for (; fin - p >= 17; p += 16) {
+        unsigned m = sse2_masque(p, '*') & sse2_masque(p + 1, '/');
+        if (m) return p + __builtin_ctz(m);
+    }
+    return scalaire_chercher_fin_commentaire(p, fin);
+}
+
+SSE2 static const char* sse2_chercher_chaine(const char* p, const char* fin, char delimiteur) {
+    for (; fin - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i e = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(delimiteur)),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+        unsigned m = (unsigned)_mm_movemask_epi8(e);
+        if (m) return p + __builtin_ctz(m);
+    }
+    return scalaire_chercher_chaine(p, fin, delimiteur);
+}
+
+SSE2 static const char* sse2_sauter_blancs(const char* p, const char* fin) {
+    for (; fin - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i b = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+        unsigned m = ~(unsigned)_mm_movemask_epi8(b) & 0xFFFFu;
+        if (m) return p + __builtin_ctz(m);
+    }
+    return scalaire_sauter_blancs(p, fin);
+}
+
+SSE2 static int sse2_compter_lignes(const char* p, const char* fin, const char** dernier_nl) {
+    int n = 0;
+    for (; fin - p >= 16; p += 16) {
+        unsigned m = sse2_masque(p, '\n');
+        if (m) {
+            n += __builtin_popcount(m);
+            *dernier_nl = p + (31 - __builtin_clz(m));
+        }
+    }
+    return n + scalaire_compter_lignes(p, fin, dernier_nl);
+}
+
+SSE2 static const char* sse2_chercher_special(const char* p, const char* fin) {
+    for (; fin - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i e = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8('/'))),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))));
+        unsigned m = (unsigned)_mm_movemask_epi8(e);
+        if (m) return p + __builtin_ctz(m);
+    }
+    return scalaire_chercher_special(p, fin);
+}
+
+static const NoyauxBalayage NOYAUX_SSE2 = {
+    "sse2",
+    sse2_chercher_nl,
+    sse2_chercher_fin_commentaire,
+    sse2_chercher_chaine,
+    sse2_sauter_blancs,
+    sse2_compter_lignes,
+    sse2_chercher_special
+};
+
+// VARIANTE AVX2 : blocs de 32 octets
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static unsigned avx2_masque(const char* p, char c) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+}
+
+AVX2 static const char* avx2_chercher_nl(const char* p, const char* fin) {
+    for (; fin - p >= 32; p += 32) {
+        unsigned m = avx2_masque(p, '\n');
+        if (m) return p + __builtin_ctz(m);
+    }
+    return sse2_chercher_nl(p, fin);
+}
+
+AVX2 static const char* avx2_chercher_fin_commentaire(const char* p, const char* fin) {
+    for (; fin - p >= 33; p += 32) {
+        unsigned m = avx2_masque(p, '*') & avx2_masque(p + 1, '/');
+        if (m) return p + __builtin_ctz(m);
+    }
+    return sse2_chercher_fin_commentaire(p, fin);
+}
+
+AVX2 static const char* avx2_chercher_chaine(const char* p, const char* fin, char delimiteur) {
+    for (; fin - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i e = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(delimiteur)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')),
+                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+        unsigned m = (unsigned)_mm256_movemask_epi8(e);
+        if (m) return p + __builtin_ctz(m);
+    }
+    return sse2_chercher_chaine(p, fin, delimiteur);
+}
+
+AVX2 static const char* avx2_sauter_blancs(const char* p, const char* fin) {
+    for (; fin - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i b = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                                     _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+        unsigned m = ~(unsigned)_mm256_movemask_epi8(b);
+        if (m) return p + __builtin_ctz(m);
+    }
+    return sse2_sauter_blancs(p, fin);
+}
+
+AVX2 static int avx2_compter_lignes(const char* p, const char* fin, const char** dernier_nl) {
+    int n = 0;
+    for (; fin - p >= 32; p += 32) {
+        unsigned m = avx2_masque(p, '\n');
+        if (m) {
+            n += __builtin_popcount(m);
+            *dernier_nl = p + (31 - __builtin_clz(m));
+        }
+    }
+    return n + sse2_compter_lignes(p, fin, dernier_nl);
+}
+
+AVX2 static const char* avx2_chercher_special(const char* p, const char* fin) {
+    for (; fin - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i e = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'))),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\''))));
+        unsigned m = (unsigned)_mm256_movemask_epi8(e);
+        if (m) return p + __builtin_ctz(m);
+    }
+    return sse2_chercher_special(p, fin);
+}
+
+static const NoyauxBalayage NOYAUX_AVX2 = {
+    "avx2",
+    avx2_chercher_nl,
+    avx2_chercher_fin_commentaire,
+    avx2_chercher_chaine,
+    avx2_sauter_blancs,
+    avx2_compter_lignes,
+    avx2_chercher_special
+};
+
+#endif // LEXER_SIMD_X86
+
+// SÉLECTION À L'EXÉCUTION
+
+static const NoyauxBalayage* choisir_noyaux(void) {
+    const char* force = getenv("ALGO_SIMD");
+
+#ifdef LEXER_SIMD_X86
+    __builtin_cpu_init();
+    bool a_sse2 = __builtin_cpu_supports("sse2");
+    bool a_avx2 = __builtin_cpu_supports("avx2");
+
+    if (force && strcmp(force, "scalaire") == 0) return &NOYAUX_SCALAIRE;
+    if (force && strcmp(force, "sse2") == 0 && a_sse2) return &NOYAUX_SSE2;
+    if (a_avx2 && !(force && strcmp(force, "sse2") == 0)) return &NOYAUX_AVX2;
+    if (a_sse2) return &NOYAUX_SSE2;
+#else
+    (void)force;
+#endif
+
+    return &NOYAUX_SCALAIRE;
+}
+
+const NoyauxBalayage* simd_noyaux(void) {
+    static const NoyauxBalayage* noyaux = NULL;
+    if (!noyaux) noyaux = choisir_noyaux();
+    return noyaux;
+}
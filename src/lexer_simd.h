@@ -0,0 +1,40 @@
+#ifndef LEXER_SIMD_H
+#define LEXER_SIMD_H
+
+// Noyaux de balayage du lexer : recherche de '\n', de "*/", de fin de
+// chaîne, saut des blancs et comptage des lignes, 16 (SSE2) ou 32 (AVX2)
+// octets à la fois. La variante est choisie à l'exécution selon le CPU,
+// avec un repli scalaire.
+//
+// Toutes les fonctions travaillent sur [p, fin) et ne lisent jamais au-delà
+// de fin : la source n'a pas besoin d'être terminée par '\0' ni complétée.
+
+typedef struct {
+    const char* nom;
+
+    // Premier '\n' de [p, fin), ou fin
+    const char* (*chercher_nl)(const char* p, const char* fin);
+
+    // Premier '*' suivi de '/' dans [p, fin), ou fin
+    const char* (*chercher_fin_commentaire)(const char* p, const char* fin);
+
+    // Premier octet égal au délimiteur, à '\\' ou à '\n', ou fin
+    const char* (*chercher_chaine)(const char* p, const char* fin, char delimiteur);
+
+    // Premier octet qui n'est pas ' ', '\t', '\r' ou '\n', ou fin
+    const char* (*sauter_blancs)(const char* p, const char* fin);
+
+    // Nombre de '\n' dans [p, fin) ; *dernier_nl reçoit le dernier (si > 0)
+    int (*compter_lignes)(const char* p, const char* fin, const char** dernier_nl);
+
+    // Premier '\n', '/', '"' ou '\'' de [p, fin), ou fin (pré-balayage de
+    // l'analyse parallèle : seuls ces octets changent l'état hors token)
+    const char* (*chercher_special)(const char* p, const char* fin);
+} NoyauxBalayage;
+
+// Meilleure variante disponible, déterminée au premier appel.
+// La variable d'environnement ALGO_SIMD=scalaire|sse2|avx2 force un choix
+// (utile pour comparer les sorties des noyaux à celles du scalaire).
+const NoyauxBalayage* simd_noyaux(void);
+
+#endif
@@ -0,0 +1,93 @@
+#include "lignes.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+void lignes_init(TableLignes* t, const char* source, size_t longueur,
+                 const NoyauxBalayage* noyaux) {
+    t->source = source;
+    t->longueur = longueur;
+    t->noyaux = noyaux;
+
+    t->curseur = 0;
+    t->curseur_ligne = 1;
+    t->curseur_debut_ligne = 0;
+
+    t->debuts = NULL;
+    t->nb = 0;
+    t->indice = 0;
+}
+
+void lignes_liberer(TableLignes* t) {
+    free(t->debuts);
+    t->debuts = NULL;
+    t->nb = 0;
+}
+
+// Un passage pour compter les lignes, un second pour noter leurs débuts
+static bool construire_table(TableLignes* t) {
+    const char* fin = t->source + t->longueur;
+    const char* dernier_nl = NULL;
+    int nb_nl = t->noyaux->compter_lignes(t->source, fin, &dernier_nl);
+
+    t->debuts = (uint32_t*)malloc((size_t)(nb_nl + 1) * sizeof(uint32_t));
+    if (!t->debuts) return false;
+
+    int n = 0;
+    t->debuts[n++] = 0;
+    for (const char* p = t->source; (p = t->noyaux->chercher_nl(p, fin)) < fin; p++) {
+        t->debuts[n++] = (uint32_t)(p + 1 - t->source);
+    }
+    t->nb = n;
+    return true;
+}
+
+// Dernière ligne dont le début est <= offset
+static int chercher_ligne(TableLignes* t, size_t offset) {
+    int i = t->indice;
+    if (t->debuts[i] <= offset && (i + 1 == t->nb || t->debuts[i + 1] > offset)) {
+        return i;
+    }
+
+    int bas = 0, haut = t->nb - 1;
+    while (bas < haut) {
+        int milieu = bas + (haut - bas + 1) / 2;
+        if (t->debuts[milieu] <= offset) bas = milieu;
+        else haut = milieu - 1;
+    }
+    t->indice = bas;
+    return bas;
+}
+
+void lignes_position(TableLignes* t, size_t offset, int* ligne, int* colonne) {
+    if (offset > t->longueur) offset = t->longueur;
+
+    if (offset >= t->curseur) {
+        // Cas courant : on avance le curseur
+        const char* dernier_nl = NULL;
+        int nb_nl = t->noyaux->compter_lignes(t->source + t->curseur,
+                                              t->source + offset, &dernier_nl);
+        if (nb_nl > 0) {
+            t->curseur_ligne += nb_nl;
+            t->curseur_debut_ligne = (size_t)(dernier_nl + 1 - t->source);
+        }
+        t->curseur = offset;
+    } else if (offset < t->curseur_debut_ligne) {
+        // Retour sur une ligne précédente
+        if (t->debuts || construire_table(t)) {
+            int i = chercher_ligne(t, offset);
+            *ligne = i + 1;
+            *colonne = (int)(offset - t->debuts[i]) + 1;
+            return;
+        }
+        // Mémoire insuffisante : on recompte depuis le début
+        t->curseur = 0;
+        t->curseur_ligne = 1;
+        t->curseur_debut_ligne = 0;
+        lignes_position(t, offset, ligne, colonne);
+        return;
+    }
+
+    // offset dans la ligne du curseur
+    *ligne = t->curseur_ligne;
+    *colonne = (int)(offset - t->curseur_debut_ligne) + 1;
+}
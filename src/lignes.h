@@ -0,0 +1,40 @@
+#ifndef LIGNES_H
+#define LIGNES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lexer_simd.h"
+
+// Passage offset -> (ligne, colonne) dans une source.
+// Le lexer ne compte plus les lignes : un token ne garde que son offset,
+// et la position n'est calculée que lorsqu'on en a besoin (AST, messages).
+//
+// Les requêtes arrivent presque toujours dans l'ordre de la source : un
+// curseur avance en comptant les '\n' (noyau compter_lignes) sans rien
+// mémoriser. Un retour en arrière au-delà de la ligne du curseur construit
+// (une fois) la table des débuts de ligne, consultée par recherche
+// dichotomique.
+typedef struct {
+    const char* source;
+    size_t longueur;
+    const NoyauxBalayage* noyaux;
+
+    // Curseur : [0, curseur) compté, ligne courante et son début
+    size_t curseur;
+    int curseur_ligne;
+    size_t curseur_debut_ligne;
+
+    // Table des débuts de ligne, construite au premier retour en arrière
+    uint32_t* debuts;
+    int nb;
+    int indice;     // dernière ligne trouvée (essayée avant la dichotomie)
+} TableLignes;
+
+void lignes_init(TableLignes* t, const char* source, size_t longueur,
+                 const NoyauxBalayage* noyaux);
+void lignes_liberer(TableLignes* t);
+
+// Ligne et colonne (à partir de 1, colonne en octets) de l'offset
+void lignes_position(TableLignes* t, size_t offset, int* ligne, int* colonne);
+
+#endif
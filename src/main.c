@@ -1,36 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
+#include "source.h"
 #include "lexer.h"
 #include "token.h"
 #include "parser.h"
 #include "ast.h"
+#include "intern.h"
+#include "cache_ast.h"
 #include "semantique.h"
+#include "pliage.h"
 
 #include "cgen.h"
 #include "pygen.h"   // à créer
 #include "jgen.h"    // à créer
 
-// Lire tout le fichier dans une string (buffer)
-static char* lire_fichier_complet(const char* chemin) {
-    FILE* f = fopen(chemin, "rb");
-    if (!f) return NULL;
-
-    if (fseek(f, 0, SEEK_END) != 0) { fclose(f); return NULL; }
-    long taille = ftell(f);
-    if (taille < 0) { fclose(f); return NULL; }
-    if (fseek(f, 0, SEEK_SET) != 0) { fclose(f); return NULL; }
-
-    char* buf = (char*)malloc((size_t)taille + 1);
-    if (!buf) { fclose(f); return NULL; }
-
-    size_t lu = fread(buf, 1, (size_t)taille, f);
-    fclose(f);
-    buf[lu] = '\0';
-    return buf;
-}
-
 static void afficher_erreurs_parser(Parser* p) {
     if (!p || p->err_count == 0) {
         printf("Aucune erreur syntaxique.\n");
@@ -43,6 +29,14 @@ static void afficher_erreurs_parser(Parser* p) {
     }
 }
 
+// "c" / "java" / "python" (option --cible) -> numéro du menu, 0 si inconnu
+static int cible_depuis_nom(const char* nom) {
+    if (strcmp(nom, "c") == 0) return 1;
+    if (strcmp(nom, "java") == 0) return 2;
+    if (strcmp(nom, "python") == 0) return 3;
+    return 0;
+}
+
 static int demander_cible(void) {
     int choix = 0;
 
@@ -67,62 +61,166 @@ printf("  3) Python\n");
 int main(int argc, char** argv) {
     int code_retour = 0;
 
-    char* source = NULL;
+    SourceEntree src = {0};
+    const char* source = NULL;
     Lexer* lexer = NULL;
     Parser parser;
     bool parser_inited = false;
+    ASTArena arena;
     ASTNode* prog = NULL;
 
-    if (argc < 2) {
-        printf("Usage: %s <fichier.algo>\n", argv[0]);
-        return 1;
+    ast_arena_init(&arena);
+
+    // Options :
+    //   --flux          lexer et parser en une passe, sans tableau de tokens
+    //   --cible <nom>   c | java | python, sans question interactive
+    //                   (indispensable quand le programme arrive sur stdin)
+    //   --syntaxe       s'arrêter après l'analyse syntaxique, sans
+    //                   afficher l'AST (affichage quadratique en la
+    //                   profondeur à cause de l'indentation)
+    //   --semantique    s'arrêter après l'analyse sémantique, sans
+    //                   afficher l'AST ni générer de code
+    //   --stats         mémoire de l'arena AST après l'analyse syntaxique
+    //   --cache         réutiliser / écrire l'AST vérifié dans
+    //                   <fichier>.algoast (pas pour stdin)
+    //   --partage       un seul nœud par sous-expression identique dans
+    //                   une définition (positions : première occurrence)
+    //   --pliage        plier et propager les constantes avant la
+    //                   génération (voir pliage.h)
+    const char* chemin = NULL;
+    bool mode_flux = false;
+    bool syntaxe_seule = false;
+    bool semantique_seule = false;
+    bool stats = false;
+    bool cache = false;
+    bool pliage = false;
+    char* chemin_cache = NULL;
+    uint64_t hachage = 0;
+    int cible = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--flux") == 0) {
+            mode_flux = true;
+        } else if (strcmp(argv[i], "--syntaxe") == 0) {
+            syntaxe_seule = true;
+        } else if (strcmp(argv[i], "--semantique") == 0) {
+            semantique_seule = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            cache = true;
+        } else if (strcmp(argv[i], "--pliage") == 0) {
+            pliage = true;
+        } else if (strcmp(argv[i], "--partage") == 0) {
+            ast_arena_partager(&arena);
+        } else if (strcmp(argv[i], "--cible") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option --cible sans valeur (c, java ou python)\n");
+                chemin = NULL;
+                break;
+            }
+            cible = cible_depuis_nom(argv[++i]);
+            if (cible == 0) {
+                printf("Cible inconnue: %s (c, java ou python)\n", argv[i]);
+                code_retour = 1;
+                goto cleanup;
+            }
+        } else {
+            chemin = argv[i];
+        }
     }
 
-    const char* chemin = argv[1];
+    if (!chemin) {
+        printf("Usage: %s [--flux] [--syntaxe] [--semantique] [--stats] [--cache] [--partage] [--pliage] [--cible c|java|python] <fichier.algo | ->\n", argv[0]);
+        code_retour = 1;
+        goto cleanup;
+    }
 
-    // 1) Lire fichier
-    source = lire_fichier_complet(chemin);
-    if (!source) {
+    // 1) Lire fichier (projeté en mémoire) ou stdin ("-")
+    if (!source_ouvrir(&src, chemin)) {
         printf("Impossible de lire le fichier: %s\n", chemin);
-        return 1;
+        code_retour = 1;
+        goto cleanup;
+    }
+    source = src.donnees;
+
+    // AST déjà vérifié pour exactement ce texte : ni lexer, ni parser, ni
+    // sémantique
+    if (cache && !syntaxe_seule && strcmp(chemin, "-") != 0) {
+        hachage = cache_ast_hacher(source, src.longueur);
+        chemin_cache = cache_ast_chemin(chemin);
+        if (chemin_cache) prog = cache_ast_charger(chemin_cache, hachage, &arena);
+        if (prog) {
+            printf("AST chargé depuis le cache : %s\n", chemin_cache);
+            if (stats) {
+                printf("\n");
+                ast_arena_afficher_stats(&arena);
+                ast_afficher_forme(prog);
+                printf("Noms internés : %d\n", intern_nb());
+            }
+            // L'AST du cache a passé l'analyse sémantique
+            if (semantique_seule) {
+                printf("\nLexer + Parser + Sémantique OK.\n");
+                code_retour = 0;
+                goto cleanup;
+            }
+            goto generation;
+        }
     }
 
     // 2) Lexer
-    lexer = creer_lexer(source, chemin);
+    lexer = creer_lexer(source, src.longueur, strcmp(chemin, "-") == 0 ? "stdin" : chemin);
     if (!lexer) {
         printf("Erreur: creer_lexer() a échoué.\n");
-        free(source);
-        return 1;
+        code_retour = 1;
+        goto cleanup;
     }
 
-    bool ok_lex = analyser_lexicalement(lexer);
+    if (mode_flux) {
+        // 3-4) Le parser tire les tokens du lexer au fil de l'eau :
+        // les erreurs lexicales ne sont connues qu'à la fin du parsing
+        parser_init_flux(&parser, lexer, &arena);
+        parser_inited = true;
 
-    printf("\n===== TOKENS =====\n");
-    afficher_tokens(lexer);
+        prog = parse_program(&parser);
 
-    printf("\n===== ERREURS LEXER =====\n");
-    afficher_erreurs(lexer);
+        printf("\n===== ERREURS LEXER =====\n");
+        afficher_erreurs(lexer);
 
-    if (!ok_lex) {
-        printf("\nAnalyse lexicale échouée.\n");
-        code_retour = 2;
-        goto cleanup;
-    }
+        if (lexer->nb_erreurs > 0) {
+            printf("\nAnalyse lexicale échouée.\n");
+            code_retour = 2;
+            goto cleanup;
+        }
+    } else {
+        bool ok_lex = analyser_lexicalement(lexer);
 
-    // 3) Récupérer tokens
-    int nb_tokens = 0;
-    Token* tokens = obtenir_tokens(lexer, &nb_tokens);
-    if (!tokens || nb_tokens == 0) {
-        printf("Aucun token récupéré.\n");
-        code_retour = 2;
-        goto cleanup;
-    }
+        printf("\n===== TOKENS =====\n");
+        afficher_tokens(lexer);
+
+        printf("\n===== ERREURS LEXER =====\n");
+        afficher_erreurs(lexer);
+
+        if (!ok_lex) {
+            printf("\nAnalyse lexicale échouée.\n");
+            code_retour = 2;
+            goto cleanup;
+        }
+
+        // 3) Récupérer tokens
+        int nb_tokens = 0;
+        const uint8_t* types = obtenir_types_tokens(lexer, &nb_tokens);
+        if (!types || nb_tokens == 0) {
+            printf("Aucun token récupéré.\n");
+            code_retour = 2;
+            goto cleanup;
+        }
 
-    // 4) Parser
-    parser_init(&parser, tokens, nb_tokens);
-    parser_inited = true;
+        // 4) Parser
+        parser_init(&parser, lexer, &arena);
+        parser_inited = true;
 
-    prog = parse_program(&parser);
+        prog = parse_program(&parser);
+    }
 
     printf("\n===== ERREURS PARSER =====\n");
     afficher_erreurs_parser(&parser);
@@ -133,9 +231,24 @@ int main(int argc, char** argv) {
         goto cleanup;
     }
 
+    if (stats) {
+        printf("\n");
+        ast_arena_afficher_stats(&arena);
+        ast_afficher_forme(prog);
+        printf("Noms internés : %d\n", intern_nb());
+    }
+
+    if (syntaxe_seule) {
+        printf("\nAnalyse syntaxique OK.\n");
+        code_retour = 0;
+        goto cleanup;
+    }
+
     // 5) Afficher AST (si OK)
-    printf("\n===== AST (ARBRE SYNTAXIQUE) =====\n");
-    ast_print(prog);
+    if (!semantique_seule) {
+        printf("\n===== AST (ARBRE SYNTAXIQUE) =====\n");
+        ast_print(prog);
+    }
 
     // 6) Sémantique
     {
@@ -158,9 +271,29 @@ int main(int argc, char** argv) {
 
     printf("\nLexer + Parser + Sémantique OK.\n");
 
-    // 7) Choix de la cible + génération
+    if (chemin_cache) {
+        if (cache_ast_ecrire(chemin_cache, hachage, prog)) {
+            printf("Cache AST écrit : %s\n", chemin_cache);
+        } else {
+            printf("Cache AST non écrit : %s\n", chemin_cache);
+        }
+    }
+
+    if (semantique_seule) {
+        code_retour = 0;
+        goto cleanup;
+    }
+
+generation:
+    // 7) Pliage des constantes (sur l'AST vérifié, en cache non plié)
+    if (pliage) {
+        int nb = pliage_programme(prog, &arena);
+        if (stats) printf("Pliage : %d expressions remplacées par un littéral\n", nb);
+    }
+
+    // 8) Choix de la cible + génération
     {
-        int choix = demander_cible();
+        int choix = cible ? cible : demander_cible();
         bool ok_gen = false;
 
         switch (choix) {
@@ -202,10 +335,13 @@ int main(int argc, char** argv) {
     code_retour = 0;
 
 cleanup:
-    if (prog) ast_free(prog);
+    ast_arena_liberer(&arena);
+    intern_liberer();
+    sem_types_liberer();
     if (parser_inited) parser_free(&parser);
     if (lexer) detruire_lexer(lexer);
-    free(source);
+    source_fermer(&src);
+    free(chemin_cache);
 
     return code_retour;
 }
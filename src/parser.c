@@ -1,29 +1,130 @@
 // parser.c
+// sysconf : POSIX
+#define _POSIX_C_SOURCE 200809L
+
 #include "parser.h"
 #include "ast.h"
 #include "token.h"
+#include "intern.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+// Deux sources de tokens : le tableau complet du lexer, ou le lexer en
+// mode flux (p->flux).
+//
+// cur() / at() / match() ne lisent que le type du token (un octet par
+// token dans le tableau du lexer). Le token complet, position comprise,
+// n'est construit que pour l'AST et les messages : tok_courant() /
+// tok_precedent(), la ligne et la colonne étant retrouvées à partir de
+// l'offset.
+
+static TokenType cur(Parser* p) {
+    if (p->abandon) return TOK_EOF;
+    if (p->flux) return lexer_peek(p->flux, 0)->type;
+    if (p->pos >= p->count) return (TokenType)p->types[p->count - 1];
+    return (TokenType)p->types[p->pos];
+}
 
+// Token i du tableau du lexer, positionné avec la table du parser
+static Token tok_indice(Parser* p, int i) {
+    Token t;
+    t.type = (TokenType)p->types[i];
+    t.debut = (int)p->lexer->debuts[i];
+    t.longueur = (int)p->lexer->longueurs[i];
+    lignes_position(p->lignes, (size_t)t.debut, &t.ligne, &t.colonne);
+    return t;
+}
 
-static Token* cur(Parser* p) {
-    if (p->pos >= p->count) return &p->tokens[p->count - 1];
-    return &p->tokens[p->pos];
+static Token tok_courant(Parser* p) {
+    if (p->flux) {
+        Token t = *lexer_peek(p->flux, 0);
+        lexer_positionner(p->flux, &t);
+        return t;
+    }
+    return tok_indice(p, p->pos < p->count ? p->pos : p->count - 1);
 }
 
-static Token* prev(Parser* p) {
+static Token tok_precedent(Parser* p) {
+    if (p->flux) {
+        Token t = p->precedent;
+        lexer_positionner(p->flux, &t);
+        return t;
+    }
     int i = p->pos - 1;
     if (i < 0) i = 0;
-    return &p->tokens[i];
+    if (i >= p->count) i = p->count - 1;
+    return tok_indice(p, i);
+}
+
+static void consommer(Parser* p) {
+    if (p->abandon) return;
+    if (p->flux) p->precedent = lexer_next_token(p->flux);
+    p->pos++;
 }
 
 
-static bool at(Parser* p, TokenType t) { return cur(p)->type == t; }
+// Texte d'un token, terminé par '\0', dans un tampon du parser.
+// Valide jusqu'au prochain appel : les constructeurs AST copient la chaîne.
+static const char* tok_texte(Parser* p, const Token* t) {
+    if (t->longueur + 1 > p->texte_cap) {
+        int ncap = (p->texte_cap == 0) ? 64 : p->texte_cap;
+        while (ncap < t->longueur + 1) ncap *= 2;
+        char* n = (char*)realloc(p->texte, (size_t)ncap);
+        if (!n) return "";
+        p->texte = n;
+        p->texte_cap = ncap;
+    }
+    memcpy(p->texte, p->source + t->debut, (size_t)t->longueur);
+    p->texte[t->longueur] = '\0';
+    return p->texte;
+}
+
+// Nom interné (intern.h) d'un token, pris directement dans la source
+static const char* tok_nom(Parser* p, const Token* t) {
+    return intern_n(p->source + t->debut, (size_t)t->longueur);
+}
+
+static bool at(Parser* p, TokenType t) { return cur(p) == t; }
+
+// Agrandit une pile de l'analyse (capacité doublée). Elles ne grossissent
+// qu'avec la profondeur d'imbrication : un échec d'allocation est fatal,
+// comme l'était le débordement de la pile C pour la descente récursive.
+static void* pile_agrandir(void* tab, int* cap, size_t taille) {
+    int ncap = (*cap == 0) ? 16 : *cap * 2;
+    void* n = realloc(tab, (size_t)ncap * taille);
+    if (!n) {
+        fprintf(stderr, "Erreur d'allocation mémoire (analyse syntaxique)\n");
+        abort();
+    }
+    *cap = ncap;
+    return n;
+}
 static bool is_eof(Parser* p) { return at(p, TOK_EOF); }
 
+// REPRISE SUR ERREUR (mode panique)
+//
+// Après une erreur, les suivantes sont ignorées (ni formatées ni
+// conservées) jusqu'à la prochaine fin d'instruction consommée : une seule
+// erreur par instruction. Un token inattendu fait sauter jusqu'au prochain
+// point de reprise (synchroniser()) au lieu d'avancer token par token, et
+// un mot-clé de fin qui appartient à un bloc englobant ferme les blocs
+// ouverts (ferme_bloc_englobant()) : un FinSi manquant ne coûte qu'une
+// erreur. Au-delà de PARSER_ERREURS_MAX erreurs, l'analyse s'arrête.
+
 static void parser_add_error(Parser* p, const char* fmt, ...) {
+    if (p->panique || p->abandon) return;
+    p->panique = true;
+
+    if (p->err_count >= PARSER_ERREURS_MAX) {
+        fmt = "Trop d'erreurs de syntaxe, analyse interrompue";
+        p->abandon = true;
+    }
+
     if (p->err_count >= p->err_cap) {
         int ncap = (p->err_cap == 0) ? 16 : p->err_cap * 2;
         char** nerrs = (char**)realloc(p->errors, (size_t)ncap * sizeof(char*));
@@ -40,10 +141,10 @@ static void parser_add_error(Parser* p, const char* fmt, ...) {
 
     // attach position (use current token)
     char full[640];
-    Token* t = cur(p);
-    snprintf(full, sizeof(full), "L%d:C%d: %s (token=%s '%s')",
-             t->ligne, t->colonne, msg, token_to_string(t->type),
-             t->valeur ? t->valeur : "");
+    Token t = tok_courant(p);
+    snprintf(full, sizeof(full), "L%d:C%d: %s (token=%s '%.*s')",
+             t.ligne, t.colonne, msg, token_to_string(t.type),
+             t.longueur, p->source + t.debut);
 
     size_t n = strlen(full);
     char* s = (char*)malloc(n + 1);
@@ -53,7 +154,7 @@ static void parser_add_error(Parser* p, const char* fmt, ...) {
 }
 
 static bool match(Parser* p, TokenType t) {
-    if (at(p, t)) { p->pos++; return true; }
+    if (at(p, t)) { consommer(p); return true; }
     return false;
 }
 
@@ -65,32 +166,50 @@ static bool expect(Parser* p, TokenType t, const char* msg) {
 
 static void skip_fin_instr(Parser* p) {
     while (at(p, TOK_FIN_INSTR) || at(p, TOK_COMMENTAIRE) || at(p, TOK_COMMENTAIRES)) {
-        p->pos++;
+        if (at(p, TOK_FIN_INSTR)) p->panique = false;
+        consommer(p);
     }
 }
 
+// Fin d'instruction, mot-clé de fin de bloc, début de définition ou
+// mot-clé d'instruction (un ID peut être une suite d'expression)
+static bool est_point_reprise(TokenType t) {
+    return token_a_categorie(t, TC_FIN_BLOC | TC_DEBUT_DEF) || t == TOK_FIN_STRUCT ||
+           (token_a_categorie(t, TC_DEBUT_INSTR) && t != TOK_ID);
+}
+
+// Consomme le token fautif puis avance jusqu'au prochain point de reprise
+static void synchroniser(Parser* p) {
+    if (is_eof(p)) return;
+    consommer(p);
+    while (!est_point_reprise(cur(p))) consommer(p);
+}
+
+// Fin d'une définition ou du programme : aucun bloc d'instructions ne
+// contient ces tokens
+static bool est_fin_structure(TokenType t) {
+    return token_a_categorie(t, TC_DEBUT_DEF) || t == TOK_FIN || t == TOK_FIN_FONCT ||
+           t == TOK_FIN_PROC || t == TOK_FIN_STRUCT || t == TOK_EOF;
+}
+
 static bool is_start_of_def(Parser* p) {
-    return at(p, TOK_STRUCTURE) || at(p, TOK_FONCTION) || at(p, TOK_PROCEDURE);
+    return token_a_categorie(cur(p), TC_DEBUT_DEF);
 }
 
 static bool is_start_of_stmt(Parser* p) {
-    TokenType t = cur(p)->type;
-    return t == TOK_ID ||
-           t == TOK_SI || t == TOK_POUR || t == TOK_TANTQUE || t == TOK_REPETER ||
-           t == TOK_ECRIRE || t == TOK_LIRE ||
-           t == TOK_RETOUR || t == TOK_RETOURNER ||
-           t == TOK_SORTIR || t == TOK_QUITTER_POUR ||
-           t == TOK_SELON;
+    return token_a_categorie(cur(p), TC_DEBUT_INSTR);
+}
+
+// Si / TantQue / Pour / Répéter / Selon : instructions contenant des blocs
+static bool est_instr_composee(Parser* p) {
+    TokenType t = cur(p);
+    return t == TOK_SI || t == TOK_TANTQUE || t == TOK_POUR ||
+           t == TOK_REPETER || t == TOK_SELON;
 }
 
 // Retourner: on veut savoir si "pas d'expression" (retour vide) est acceptable
 static bool is_return_terminator(Parser* p) {
-    TokenType t = cur(p)->type;
-    return t == TOK_FIN_INSTR || t == TOK_FIN || t == TOK_FIN_PROC || t == TOK_FIN_FONCT ||
-           t == TOK_FIN_SI || t == TOK_SINON || t == TOK_SINONSI ||
-           t == TOK_FINTANTQUE || t == TOK_FIN_POUR || t == TOK_FIN_SELON ||
-           t == TOK_CAS || t == TOK_DEFAUT ||
-           t == TOK_EOF;
+    return token_a_categorie(cur(p), TC_FIN_BLOC);
 }
 
 
@@ -100,8 +219,10 @@ static ASTNode* parse_declaration(Parser* p);
 static ASTNode* parse_type(Parser* p);
 
 static void parse_optional_local_objets(Parser* p, ASTList* out_decls);
-static ASTNode* prepend_decls_to_block(ASTList* decls, ASTNode* body);
+static ASTNode* prepend_decls_to_block(Parser* p, ASTList* decls, ASTNode* body);
 
+static ASTNode* parse_definition(Parser* p);
+static void parse_definitions_en_parallele(Parser* p, ASTNode* prog);
 static ASTNode* parse_def_struct(Parser* p);
 static ASTNode* parse_def_func(Parser* p);
 static ASTNode* parse_def_proc(Parser* p);
@@ -111,14 +232,10 @@ static ASTNode* parse_block_until(Parser* p, TokenType stop1, TokenType stop2, T
 
 static ASTNode* parse_statement(Parser* p);
 
-static ASTNode* parse_stmt_if(Parser* p);
-static ASTNode* parse_stmt_while(Parser* p);
-static ASTNode* parse_stmt_for(Parser* p);
-static ASTNode* parse_stmt_repeat(Parser* p);
+static ASTNode* parse_stmt_compose(Parser* p);
 static ASTNode* parse_stmt_write(Parser* p);
 static ASTNode* parse_stmt_read(Parser* p);
 static ASTNode* parse_stmt_return(Parser* p);
-static ASTNode* parse_stmt_switch(Parser* p);
 
 // IMPORTANT: pour gérer RemplirMatrice() / f(x) en instruction
 static ASTNode* parse_stmt_starting_with_id(Parser* p);
@@ -126,27 +243,47 @@ static ASTNode* parse_stmt_starting_with_id(Parser* p);
 static ASTNode* parse_lvalue(Parser* p);
 static ASTNode* parse_expression(Parser* p);
 
-// precedence levels
-static ASTNode* parse_expr_or(Parser* p);
-static ASTNode* parse_expr_and(Parser* p);
-static ASTNode* parse_expr_cmp(Parser* p);
-static ASTNode* parse_expr_add(Parser* p);
-static ASTNode* parse_expr_mul(Parser* p);
-static ASTNode* parse_expr_pow(Parser* p);
-static ASTNode* parse_expr_unary(Parser* p);
-static ASTNode* parse_expr_postfix(Parser* p);
+static ASTNode* parse_expr_iter(Parser* p, bool postfixe_seul);
 static ASTNode* parse_expr_primary(Parser* p);
 
 
 // Parser API
 
-void parser_init(Parser* p, Token* tokens, int count) {
-    p->tokens = tokens;
-    p->count = count;
+void parser_init(Parser* p, Lexer* lexer, ASTArena* arena) {
+    p->lexer = lexer;
+    p->arena = arena;
+    p->types = obtenir_types_tokens(lexer, &p->count);
     p->pos = 0;
+    p->lignes = &lexer->lignes;
+    p->source = lexer->source;
+    p->texte = NULL;
+    p->texte_cap = 0;
+    p->flux = NULL;
     p->errors = NULL;
     p->err_count = 0;
     p->err_cap = 0;
+    p->panique = false;
+    p->abandon = false;
+
+    p->operandes = NULL;
+    p->nb_operandes = 0;
+    p->cap_operandes = 0;
+    p->operateurs = NULL;
+    p->nb_operateurs = 0;
+    p->cap_operateurs = 0;
+    p->cadres_expr = NULL;
+    p->nb_cadres_expr = 0;
+    p->cap_cadres_expr = 0;
+    p->cadres_instr = NULL;
+    p->nb_cadres_instr = 0;
+    p->cap_cadres_instr = 0;
+}
+
+void parser_init_flux(Parser* p, Lexer* lexer, ASTArena* arena) {
+    lexer_activer_flux(lexer);
+    parser_init(p, lexer, arena);
+    p->flux = lexer;
+    p->precedent = *lexer_peek(lexer, 0);
 }
 
 void parser_free(Parser* p) {
@@ -155,6 +292,20 @@ void parser_free(Parser* p) {
     p->errors = NULL;
     p->err_count = 0;
     p->err_cap = 0;
+    free(p->texte);
+    p->texte = NULL;
+    p->texte_cap = 0;
+
+    free(p->operandes);
+    free(p->operateurs);
+    free(p->cadres_expr);
+    free(p->cadres_instr);
+    p->operandes = NULL;
+    p->operateurs = NULL;
+    p->cadres_expr = NULL;
+    p->cadres_instr = NULL;
+    p->cap_operandes = p->cap_operateurs = p->cap_cadres_expr = p->cap_cadres_instr = 0;
+    p->nb_operandes = p->nb_operateurs = p->nb_cadres_expr = p->nb_cadres_instr = 0;
 }
 
 
@@ -164,10 +315,10 @@ ASTNode* parse_program(Parser* p) {
     // Algorithme ID
     if (!expect(p, TOK_ALGORITHME, "Mot-clé 'Algorithme' attendu")) return NULL;
 
-    Token* nameTok = cur(p);
+    Token nameTok = tok_courant(p);
     if (!expect(p, TOK_ID, "Nom d'algorithme (ID) attendu")) return NULL;
 
-    ASTNode* prog = ast_new_program(nameTok->valeur, nameTok->ligne, nameTok->colonne);
+    ASTNode* prog = ast_new_program(p->arena, tok_nom(p, &nameTok), nameTok.ligne, nameTok.colonne);
     skip_fin_instr(p);
 
     // Optional Objets:
@@ -180,7 +331,8 @@ ASTNode* parse_program(Parser* p) {
             if (at(p, TOK_DEBUT) || is_eof(p)) break;
 
             ASTNode* d = parse_declaration(p);
-            if (d) ast_program_add_decl(prog, d);
+            if (d) ast_program_add_decl(p->arena, prog, d);
+            else if (!at(p, TOK_FIN_INSTR)) synchroniser(p);
 
             skip_fin_instr(p);
         }
@@ -189,31 +341,31 @@ ASTNode* parse_program(Parser* p) {
     expect(p, TOK_DEBUT, "'Début' attendu");
     skip_fin_instr(p);
 
-    // defs after Début
+    // defs after Début (en parallèle pour les gros programmes, puis
+    // séquentiellement pour ce qui reste)
+    parse_definitions_en_parallele(p, prog);
     while (!is_eof(p) && is_start_of_def(p)) {
-        ASTNode* def = NULL;
-        if (at(p, TOK_STRUCTURE)) def = parse_def_struct(p);
-        else if (at(p, TOK_FONCTION)) def = parse_def_func(p);
-        else if (at(p, TOK_PROCEDURE)) def = parse_def_proc(p);
-
-        if (def) ast_program_add_def(prog, def);
+        ASTNode* def = parse_definition(p);
+        if (def) ast_program_add_def(p->arena, prog, def);
         skip_fin_instr(p);
     }
 
     // main block until FIN
-    ASTNode* mainb = ast_new_block(cur(p)->ligne, cur(p)->colonne);
+    ast_partage_nouvelle_portee(p->arena);
+    Token debut_main = tok_courant(p);
+    ASTNode* mainb = ast_new_block(p->arena, debut_main.ligne, debut_main.colonne);
     while (!is_eof(p) && !at(p, TOK_FIN)) {
         skip_fin_instr(p);
         if (at(p, TOK_FIN) || is_eof(p)) break;
 
         if (!is_start_of_stmt(p)) {
             parser_add_error(p, "Instruction attendue");
-            p->pos++; // advance
+            synchroniser(p);
             continue;
         }
 
         ASTNode* st = parse_statement(p);
-        if (st) ast_block_add(mainb, st);
+        if (st) ast_block_add(p->arena, mainb, st);
         skip_fin_instr(p);
     }
     prog->as.program.main_block = mainb;
@@ -229,35 +381,35 @@ ASTNode* parse_program(Parser* p) {
 
 static ASTNode* parse_declaration(Parser* p) {
     // name ':' (Variable Type | Constante Type '=' expr | Tableau Type dims)
-    Token* nameTok = cur(p);
+    Token nameTok = tok_courant(p);
     if (!expect(p, TOK_ID, "Nom (ID) attendu dans déclaration")) return NULL;
 
     if (!expect(p, TOK_DEUX_POINTS, "':' attendu après le nom de déclaration")) return NULL;
 
-    int line = nameTok->ligne, col = nameTok->colonne;
+    int line = nameTok.ligne, col = nameTok.colonne;
 
     if (match(p, TOK_VARIABLE)) {
         ASTNode* t = parse_type(p);
-        return ast_new_decl_var(nameTok->valeur, t, line, col);
+        return ast_new_decl_var(p->arena, tok_nom(p, &nameTok), t, line, col);
     }
 
     if (match(p, TOK_CONSTANTE)) {
         ASTNode* t = parse_type(p);
         expect(p, TOK_EGAL, "'=' attendu dans déclaration de constante");
         ASTNode* v = parse_expression(p);
-        return ast_new_decl_const(nameTok->valeur, t, v, line, col);
+        return ast_new_decl_const(p->arena, tok_nom(p, &nameTok), t, v, line, col);
     }
 
     if (match(p, TOK_TABLEAU)) {
         ASTNode* elem = parse_type(p);
-        ASTNode* arr = ast_new_decl_array(nameTok->valeur, elem, line, col);
+        ASTNode* arr = ast_new_decl_array(p->arena, tok_nom(p, &nameTok), elem, line, col);
 
         // dims: [expr]+
         int dims = 0;
         while (match(p, TOK_CROCHET_OUVRANT)) {
             ASTNode* dim = parse_expression(p);
             expect(p, TOK_CROCHET_FERMANT, "']' attendu");
-            ast_list_push(&arr->as.decl_array.dims, dim);
+            ast_list_push(p->arena, &arr->as.decl_array.dims, dim);
             dims++;
         }
         if (dims == 0) {
@@ -271,8 +423,13 @@ static ASTNode* parse_declaration(Parser* p) {
 }
 
 //  Objets: optionnel dans les fonctions/procédures (avant Début)
+//
+// Une déclaration locale peut masquer une globale ou un paramètre : un
+// même nom ne désigne plus le même symbole avant et après elle, d'où une
+// nouvelle portée de partage après les paramètres et après chacune.
 static void parse_optional_local_objets(Parser* p, ASTList* out_decls) {
     ast_list_init(out_decls);
+    ast_partage_nouvelle_portee(p->arena);
 
     if (!match(p, TOK_OBJETS)) return;
 
@@ -284,65 +441,61 @@ static void parse_optional_local_objets(Parser* p, ASTList* out_decls) {
         if (at(p, TOK_DEBUT) || is_eof(p)) break;
 
         ASTNode* d = parse_declaration(p);
-        if (d) ast_list_push(out_decls, d);
+        if (d) ast_list_push(p->arena, out_decls, d);
+        else if (!at(p, TOK_FIN_INSTR)) synchroniser(p);
+        ast_partage_nouvelle_portee(p->arena);
 
         skip_fin_instr(p);
     }
 }
 
-static ASTNode* prepend_decls_to_block(ASTList* decls, ASTNode* body) {
+static ASTNode* prepend_decls_to_block(Parser* p, ASTList* decls, ASTNode* body) {
     if (!body || body->kind != AST_BLOCK || !decls || decls->count == 0) return body;
 
-    ASTNode* merged = ast_new_block(body->line, body->col);
+    ASTNode* merged = ast_new_block(p->arena, body->line, body->col);
 
     // 1) déclarations d’abord
     for (int i = 0; i < decls->count; i++) {
-        ast_block_add(merged, decls->items[i]);
+        ast_block_add(p->arena, merged, decls->items[i]);
     }
 
     // 2) puis les instructions du body
     for (int i = 0; i < body->as.block.stmts.count; i++) {
-        ast_block_add(merged, body->as.block.stmts.items[i]);
+        ast_block_add(p->arena, merged, body->as.block.stmts.items[i]);
     }
 
-    // libérer uniquement le conteneur de l'ancien bloc
-    free(body->as.block.stmts.items);
-    body->as.block.stmts.items = NULL;
-    body->as.block.stmts.count = 0;
-    body->as.block.stmts.cap = 0;
-    free(body);
-
+    // l'ancien bloc reste dans l'arena, détaché de l'arbre
     return merged;
 }
 
 //  parse_type() accepte maintenant "Tableau entier[]" comme type paramètre
 static ASTNode* parse_type(Parser* p) {
-    Token* t = cur(p);
-    int line = t->ligne, col = t->colonne;
+    Token t = tok_courant(p);
+    int line = t.ligne, col = t.colonne;
 
-    if (match(p, TOK_ENTIER))    return ast_new_type_primitive(TYPE_ENTIER, line, col);
-    if (match(p, TOK_REEL))      return ast_new_type_primitive(TYPE_REEL, line, col);
-    if (match(p, TOK_CARACTERE)) return ast_new_type_primitive(TYPE_CARACTERE, line, col);
-    if (match(p, TOK_CHAINE))    return ast_new_type_primitive(TYPE_CHAINE, line, col);
-    if (match(p, TOK_BOOLEEN))   return ast_new_type_primitive(TYPE_BOOLEEN, line, col);
+    if (match(p, TOK_ENTIER))    return ast_new_type_primitive(p->arena, TYPE_ENTIER, line, col);
+    if (match(p, TOK_REEL))      return ast_new_type_primitive(p->arena, TYPE_REEL, line, col);
+    if (match(p, TOK_CARACTERE)) return ast_new_type_primitive(p->arena, TYPE_CARACTERE, line, col);
+    if (match(p, TOK_CHAINE))    return ast_new_type_primitive(p->arena, TYPE_CHAINE, line, col);
+    if (match(p, TOK_BOOLEEN))   return ast_new_type_primitive(p->arena, TYPE_BOOLEEN, line, col);
 
     //  Type tableau
     if (match(p, TOK_TABLEAU)) {
-        Token* kw = prev(p);
+        Token kw = tok_precedent(p);
         ASTNode* elem = parse_type(p);
-        ASTNode* arrT = ast_new_type_array(elem, kw->ligne, kw->colonne);
+        ASTNode* arrT = ast_new_type_array(p->arena, elem, kw.ligne, kw.colonne);
 
         int dims = 0;
         while (match(p, TOK_CROCHET_OUVRANT)) {
             // "[]" => dimension non fixée (paramètre)
             if (match(p, TOK_CROCHET_FERMANT)) {
-                ast_list_push(&arrT->as.type_array.dims, NULL);
+                ast_list_push(p->arena, &arrT->as.type_array.dims, NULL);
                 dims++;
                 continue;
             }
             ASTNode* dim = parse_expression(p);
             expect(p, TOK_CROCHET_FERMANT, "']' attendu");
-            ast_list_push(&arrT->as.type_array.dims, dim);
+            ast_list_push(p->arena, &arrT->as.type_array.dims, dim);
             dims++;
         }
 
@@ -353,22 +506,201 @@ static ASTNode* parse_type(Parser* p) {
     }
 
     // named type
-    if (match(p, TOK_ID)) return ast_new_type_named(t->valeur, line, col);
+    if (match(p, TOK_ID)) return ast_new_type_named(p->arena, tok_nom(p, &t), line, col);
 
     parser_add_error(p, "Type attendu (entier/réel/caractère/chaine/booléen ou ID)");
-    return ast_new_type_named("<?>", line, col);
+    return ast_new_type_named(p->arena, "<?>", line, col);
 }
 
 // Definitions
 
+static ASTNode* parse_definition(Parser* p) {
+    // Les expressions ne sont partagées qu'à l'intérieur d'une définition
+    ast_partage_nouvelle_portee(p->arena);
+    if (at(p, TOK_STRUCTURE)) return parse_def_struct(p);
+    if (at(p, TOK_FONCTION)) return parse_def_func(p);
+    if (at(p, TOK_PROCEDURE)) return parse_def_proc(p);
+    return NULL;
+}
+
+// DÉFINITIONS EN PARALLÈLE
+//
+// Un pré-balayage de types[] repère les définitions bien délimitées qui
+// se suivent : Fonction ... FinFonct, Procédure ... FinProc, Structure
+// ... Fin-struct, sans autre mot-clé de définition ou de fin de
+// définition entre les deux. Elles sont réparties en groupes contigus,
+// chaque groupe analysé par un thread avec son propre Parser (erreurs,
+// piles), sa propre arena et sa propre table des lignes.
+//
+// Un groupe est analysé comme s'il commençait hors mode panique. Les
+// résultats sont repris dans l'ordre des sources tant que l'hypothèse
+// tient (pas de panique en début de groupe, budget d'erreurs non atteint,
+// positions de fin identiques au pré-balayage) ; à la première exception,
+// le reste est repris séquentiellement. Arbre et messages sont donc ceux
+// de l'analyse séquentielle.
+
+typedef struct {
+    Parser parser;
+    ASTArena arena;
+    TableLignes lignes;
+    ASTList defs;
+    const int* debuts;      // débuts des définitions du groupe
+    int nb_defs;
+    int fin;                // position attendue après le groupe
+    bool ok;
+} GroupeDefs;
+
+static int nb_threads_definitions(int nb_tokens, int nb_defs) {
+    if (nb_tokens < PARSER_SEUIL_PARALLELE) return 1;
+
+    long n;
+    const char* force = getenv("ALGO_THREADS");
+    if (force && *force) n = strtol(force, NULL, 10);
+    else n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    long max = nb_defs / PARSER_DEFS_MIN_GROUPE;
+    if (n > max) n = max;
+    if (n > 64) n = 64;
+    return (n < 1) ? 1 : (int)n;
+}
+
+// Définitions bien délimitées à partir de p->pos : leurs débuts dans
+// debuts (à libérer), la position qui suit la dernière dans *fin
+static int reperer_definitions(Parser* p, int** debuts, int* fin) {
+    int nb = 0, cap = 0;
+    int i = p->pos;
+    *debuts = NULL;
+
+    while (i < p->count && token_a_categorie((TokenType)p->types[i], TC_DEBUT_DEF)) {
+        TokenType attendu = TOK_FIN_STRUCT;
+        if (p->types[i] == TOK_FONCTION) attendu = TOK_FIN_FONCT;
+        else if (p->types[i] == TOK_PROCEDURE) attendu = TOK_FIN_PROC;
+
+        int j = i + 1;
+        while (j < p->count && !est_fin_structure((TokenType)p->types[j])) j++;
+        if (j >= p->count || p->types[j] != attendu) break;
+
+        if (nb >= cap) *debuts = (int*)pile_agrandir(*debuts, &cap, sizeof(int));
+        (*debuts)[nb++] = i;
+
+        i = j + 1;
+        while (i < p->count && (p->types[i] == TOK_FIN_INSTR || p->types[i] == TOK_COMMENTAIRE ||
+                                p->types[i] == TOK_COMMENTAIRES)) {
+            i++;
+        }
+    }
+    *fin = i;
+    return nb;
+}
+
+static void* analyser_groupe(void* arg) {
+    GroupeDefs* g = (GroupeDefs*)arg;
+    Parser* w = &g->parser;
+
+    w->pos = g->debuts[0];
+    g->ok = true;
+    for (int k = 0; k < g->nb_defs; k++) {
+        if (w->pos != g->debuts[k]) { g->ok = false; break; }
+        ASTNode* def = parse_definition(w);
+        if (def) ast_list_push(&g->arena, &g->defs, def);
+        skip_fin_instr(w);
+    }
+    if (w->pos != g->fin || w->abandon) g->ok = false;
+    return NULL;
+}
+
+static void parse_definitions_en_parallele(Parser* p, ASTNode* prog) {
+    if (p->flux || p->count - p->pos < PARSER_SEUIL_PARALLELE) return;
+
+    int* debuts = NULL;
+    int fin = 0;
+    int nb_defs = reperer_definitions(p, &debuts, &fin);
+    int nb = nb_threads_definitions(fin - p->pos, nb_defs);
+    if (nb < 2) { free(debuts); return; }
+
+    GroupeDefs* groupes = (GroupeDefs*)calloc((size_t)nb, sizeof(GroupeDefs));
+    pthread_t* threads = (pthread_t*)malloc((size_t)nb * sizeof(pthread_t));
+    bool* lances = (bool*)calloc((size_t)nb, sizeof(bool));
+    if (!groupes || !threads || !lances) {
+        free(groupes); free(threads); free(lances); free(debuts);
+        return;
+    }
+
+    // Groupes contigus d'environ autant de tokens
+    int d = 0;
+    for (int g = 0; g < nb; g++) {
+        GroupeDefs* gr = &groupes[g];
+        int cible = p->pos + (int)((long long)(fin - p->pos) * (g + 1) / nb);
+        int premier = d;
+        do d++; while (d < nb_defs && (g == nb - 1 || debuts[d] < cible));
+
+        ast_arena_init(&gr->arena);
+        if (p->arena->partage) ast_arena_partager(&gr->arena);
+        parser_init(&gr->parser, p->lexer, &gr->arena);
+        lignes_init(&gr->lignes, p->lexer->source, p->lexer->longueur, p->lexer->noyaux);
+        gr->parser.lignes = &gr->lignes;
+        ast_list_init(&gr->defs);
+        gr->debuts = debuts + premier;
+        gr->nb_defs = d - premier;
+        gr->fin = (d < nb_defs) ? debuts[d] : fin;
+
+        if (d >= nb_defs) { nb = g + 1; break; }
+    }
+
+    // Le premier groupe est analysé par le thread appelant
+    for (int g = 1; g < nb; g++) {
+        lances[g] = pthread_create(&threads[g], NULL, analyser_groupe, &groupes[g]) == 0;
+        if (!lances[g]) analyser_groupe(&groupes[g]);
+    }
+    analyser_groupe(&groupes[0]);
+    for (int g = 1; g < nb; g++) {
+        if (lances[g]) pthread_join(threads[g], NULL);
+    }
+
+    // Reprise dans l'ordre, tant que le résultat est celui de l'analyse
+    // séquentielle
+    bool repris = true;
+    for (int g = 0; g < nb; g++) {
+        GroupeDefs* gr = &groupes[g];
+        Parser* w = &gr->parser;
+
+        repris = repris && gr->ok && !p->panique && !p->abandon &&
+                 p->err_count + w->err_count <= PARSER_ERREURS_MAX;
+        if (repris) {
+            for (int k = 0; k < gr->defs.count; k++) {
+                ast_program_add_def(p->arena, prog, gr->defs.items[k]);
+            }
+            for (int k = 0; k < w->err_count; k++) {
+                if (p->err_count >= p->err_cap) {
+                    p->errors = (char**)pile_agrandir(p->errors, &p->err_cap, sizeof(char*));
+                }
+                p->errors[p->err_count++] = w->errors[k];
+            }
+            w->err_count = 0;
+            p->pos = w->pos;
+            p->panique = w->panique;
+            ast_arena_absorber(p->arena, &gr->arena);
+        }
+
+        parser_free(w);
+        lignes_liberer(&gr->lignes);
+        ast_arena_liberer(&gr->arena);
+    }
+
+    free(lances);
+    free(threads);
+    free(groupes);
+    free(debuts);
+}
+
 static ASTNode* parse_def_struct(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
     expect(p, TOK_STRUCTURE, "'Structure' attendu");
 
-    Token* name = cur(p);
+    Token name = tok_courant(p);
     expect(p, TOK_ID, "Nom de structure (ID) attendu");
 
-    ASTNode* st = ast_new_def_struct(name->valeur, kw->ligne, kw->colonne);
+    ASTNode* st = ast_new_def_struct(p->arena, tok_nom(p, &name), kw.ligne, kw.colonne);
     skip_fin_instr(p);
 
     // fields: ID ':' Type FIN_INSTR*
@@ -376,14 +708,20 @@ static ASTNode* parse_def_struct(Parser* p) {
         skip_fin_instr(p);
         if (at(p, TOK_FIN_STRUCT) || is_eof(p)) break;
 
-        Token* fname = cur(p);
-        if (!expect(p, TOK_ID, "Nom de champ (ID) attendu")) break;
+        Token fname = tok_courant(p);
+        if (!at(p, TOK_ID)) {
+            if (est_fin_structure(cur(p))) break;
+            parser_add_error(p, "Nom de champ (ID) attendu");
+            synchroniser(p);
+            continue;
+        }
+        consommer(p);
 
         expect(p, TOK_DEUX_POINTS, "':' attendu après champ");
         ASTNode* ftype = parse_type(p);
 
-        ASTNode* field = ast_new_field(fname->valeur, ftype, fname->ligne, fname->colonne);
-        ast_list_push(&st->as.def_struct.fields, field);
+        ASTNode* field = ast_new_field(p->arena, tok_nom(p, &fname), ftype, fname.ligne, fname.colonne);
+        ast_list_push(p->arena, &st->as.def_struct.fields, field);
 
         skip_fin_instr(p);
     }
@@ -393,30 +731,30 @@ static ASTNode* parse_def_struct(Parser* p) {
 }
 
 static ASTNode* parse_param(Parser* p) {
-    Token* n = cur(p);
+    Token n = tok_courant(p);
     expect(p, TOK_ID, "Nom paramètre (ID) attendu");
     expect(p, TOK_DEUX_POINTS, "':' attendu dans paramètre");
     ASTNode* t = parse_type(p);
-    return ast_new_param(n->valeur, t, n->ligne, n->colonne);
+    return ast_new_param(p->arena, tok_nom(p, &n), t, n.ligne, n.colonne);
 }
 
 static ASTNode* parse_def_func(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
     expect(p, TOK_FONCTION, "'Fonction' attendu");
 
-    Token* name = cur(p);
+    Token name = tok_courant(p);
     expect(p, TOK_ID, "Nom de fonction (ID) attendu");
 
-    ASTNode* fn = ast_new_def_func(name->valeur, NULL, kw->ligne, kw->colonne);
+    ASTNode* fn = ast_new_def_func(p->arena, tok_nom(p, &name), NULL, kw.ligne, kw.colonne);
 
     // params
     expect(p, TOK_PAREN_OUVRANTE, "'(' attendu après nom de fonction");
     if (!at(p, TOK_PAREN_FERMANTE)) {
         ASTNode* pa = parse_param(p);
-        ast_list_push(&fn->as.def_func.params, pa);
+        ast_list_push(p->arena, &fn->as.def_func.params, pa);
         while (match(p, TOK_VIRGULE)) {
             ASTNode* pb = parse_param(p);
-            ast_list_push(&fn->as.def_func.params, pb);
+            ast_list_push(p->arena, &fn->as.def_func.params, pb);
         }
     }
     expect(p, TOK_PAREN_FERMANTE, "')' attendu");
@@ -435,9 +773,7 @@ static ASTNode* parse_def_func(Parser* p) {
     skip_fin_instr(p);
 
     ASTNode* body = parse_block_until(p, TOK_FIN_FONCT, TOK_EOF, TOK_EOF);
-    body = prepend_decls_to_block(&localDecls, body);
-
-    ast_list_free_shallow(&localDecls);
+    body = prepend_decls_to_block(p, &localDecls, body);
 
     fn->as.def_func.body = body;
 
@@ -446,22 +782,22 @@ static ASTNode* parse_def_func(Parser* p) {
 }
 
 static ASTNode* parse_def_proc(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
     expect(p, TOK_PROCEDURE, "'Procédure' attendu");
 
-    Token* name = cur(p);
+    Token name = tok_courant(p);
     expect(p, TOK_ID, "Nom de procédure (ID) attendu");
 
-    ASTNode* pr = ast_new_def_proc(name->valeur, kw->ligne, kw->colonne);
+    ASTNode* pr = ast_new_def_proc(p->arena, tok_nom(p, &name), kw.ligne, kw.colonne);
 
     // params
     expect(p, TOK_PAREN_OUVRANTE, "'(' attendu après nom de procédure");
     if (!at(p, TOK_PAREN_FERMANTE)) {
         ASTNode* pa = parse_param(p);
-        ast_list_push(&pr->as.def_proc.params, pa);
+        ast_list_push(p->arena, &pr->as.def_proc.params, pa);
         while (match(p, TOK_VIRGULE)) {
             ASTNode* pb = parse_param(p);
-            ast_list_push(&pr->as.def_proc.params, pb);
+            ast_list_push(p->arena, &pr->as.def_proc.params, pb);
         }
     }
     expect(p, TOK_PAREN_FERMANTE, "')' attendu");
@@ -476,9 +812,7 @@ static ASTNode* parse_def_proc(Parser* p) {
     skip_fin_instr(p);
 
     ASTNode* body = parse_block_until(p, TOK_FIN_PROC, TOK_EOF, TOK_EOF);
-    body = prepend_decls_to_block(&localDecls, body);
-
-    ast_list_free_shallow(&localDecls);
+    body = prepend_decls_to_block(p, &localDecls, body);
 
     pr->as.def_proc.body = body;
 
@@ -488,20 +822,23 @@ static ASTNode* parse_def_proc(Parser* p) {
 
 // Parse a block until a stop token (stop2/stop3 optional)
 static ASTNode* parse_block_until(Parser* p, TokenType stop1, TokenType stop2, TokenType stop3) {
-    ASTNode* b = ast_new_block(cur(p)->ligne, cur(p)->colonne);
+    Token debut_bloc = tok_courant(p);
+    ASTNode* b = ast_new_block(p->arena, debut_bloc.ligne, debut_bloc.colonne);
 
     while (!is_eof(p) && !at(p, stop1) && !at(p, stop2) && !at(p, stop3)) {
         skip_fin_instr(p);
         if (at(p, stop1) || at(p, stop2) || at(p, stop3) || is_eof(p)) break;
 
         if (!is_start_of_stmt(p)) {
+            // FinFonct / FinProc manquant : la définition s'arrête là
+            if (est_fin_structure(cur(p))) break;
             parser_add_error(p, "Instruction attendue dans bloc");
-            p->pos++;
+            synchroniser(p);
             continue;
         }
 
         ASTNode* st = parse_statement(p);
-        if (st) ast_block_add(b, st);
+        if (st) ast_block_add(p->arena, b, st);
         skip_fin_instr(p);
     }
     return b;
@@ -510,18 +847,14 @@ static ASTNode* parse_block_until(Parser* p, TokenType stop1, TokenType stop2, T
 // Statements
 
 static ASTNode* parse_statement(Parser* p) {
-    Token* t = cur(p);
+    Token t = tok_courant(p);
 
-    if (at(p, TOK_SI)) return parse_stmt_if(p);
-    if (at(p, TOK_TANTQUE)) return parse_stmt_while(p);
-    if (at(p, TOK_POUR)) return parse_stmt_for(p);
-    if (at(p, TOK_REPETER)) return parse_stmt_repeat(p);
+    if (est_instr_composee(p)) return parse_stmt_compose(p);
     if (at(p, TOK_ECRIRE)) return parse_stmt_write(p);
     if (at(p, TOK_LIRE)) return parse_stmt_read(p);
     if (at(p, TOK_RETOUR) || at(p, TOK_RETOURNER)) return parse_stmt_return(p);
-    if (at(p, TOK_SORTIR)) { match(p, TOK_SORTIR); return ast_new_break(t->ligne, t->colonne); }
-    if (at(p, TOK_QUITTER_POUR)) { match(p, TOK_QUITTER_POUR); return ast_new_quit_for(t->ligne, t->colonne); }
-    if (at(p, TOK_SELON)) return parse_stmt_switch(p);
+    if (at(p, TOK_SORTIR)) { match(p, TOK_SORTIR); return ast_new_break(p->arena, t.ligne, t.colonne); }
+    if (at(p, TOK_QUITTER_POUR)) { match(p, TOK_QUITTER_POUR); return ast_new_quit_for(p->arena, t.ligne, t.colonne); }
 
     // ID: assignment or call-statement (or invalid)
     if (at(p, TOK_ID)) {
@@ -529,18 +862,18 @@ static ASTNode* parse_statement(Parser* p) {
     }
 
     parser_add_error(p, "Instruction inconnue");
-    p->pos++;
+    synchroniser(p);
     return NULL;
 }
 
 // ---- IMPORTANT FIX HERE ----
 static ASTNode* parse_stmt_starting_with_id(Parser* p) {
-    Token* first = cur(p);   // TOK_ID
-    int line = first->ligne;
-    int col  = first->colonne;
+    Token first = tok_courant(p);   // TOK_ID
+    int line = first.ligne;
+    int col  = first.colonne;
 
     // Parse ID + postfix: .  []  ()
-    ASTNode* expr = parse_expr_postfix(p);
+    ASTNode* expr = parse_expr_iter(p, true);
 
     // 1) Affectation
     if (match(p, TOK_AFFECTATION)) {
@@ -551,12 +884,12 @@ static ASTNode* parse_stmt_starting_with_id(Parser* p) {
             parser_add_error(p, "Cible d'affectation invalide");
         }
         ASTNode* value = parse_expression(p);
-        return ast_new_assign(expr, value, line, col);
+        return ast_new_assign(p->arena, expr, value, line, col);
     }
 
     // 2) Appel => instruction
     if (expr && expr->kind == AST_CALL) {
-        return ast_new_call_stmt(expr, line, col);
+        return ast_new_call_stmt(p->arena, expr, line, col);
     }
 
     // 3) Sinon invalide
@@ -565,17 +898,17 @@ static ASTNode* parse_stmt_starting_with_id(Parser* p) {
 }
 
 static ASTNode* parse_stmt_write(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
     match(p, TOK_ECRIRE);
-    ASTNode* w = ast_new_write(kw->ligne, kw->colonne);
+    ASTNode* w = ast_new_write(p->arena, kw.ligne, kw.colonne);
 
     expect(p, TOK_PAREN_OUVRANTE, "'(' attendu après Ecrire");
     if (!at(p, TOK_PAREN_FERMANTE)) {
         ASTNode* e = parse_expression(p);
-        ast_list_push(&w->as.write_stmt.args, e);
+        ast_list_push(p->arena, &w->as.write_stmt.args, e);
         while (match(p, TOK_VIRGULE)) {
             ASTNode* e2 = parse_expression(p);
-            ast_list_push(&w->as.write_stmt.args, e2);
+            ast_list_push(p->arena, &w->as.write_stmt.args, e2);
         }
     }
     expect(p, TOK_PAREN_FERMANTE, "')' attendu après Ecrire(...)");
@@ -583,17 +916,17 @@ static ASTNode* parse_stmt_write(Parser* p) {
 }
 
 static ASTNode* parse_stmt_read(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
     match(p, TOK_LIRE);
-    ASTNode* r = ast_new_read(kw->ligne, kw->colonne);
+    ASTNode* r = ast_new_read(p->arena, kw.ligne, kw.colonne);
 
     expect(p, TOK_PAREN_OUVRANTE, "'(' attendu après Lire");
     if (!at(p, TOK_PAREN_FERMANTE)) {
         ASTNode* lv = parse_lvalue(p);
-        ast_list_push(&r->as.read_stmt.targets, lv);
+        ast_list_push(p->arena, &r->as.read_stmt.targets, lv);
         while (match(p, TOK_VIRGULE)) {
             ASTNode* lv2 = parse_lvalue(p);
-            ast_list_push(&r->as.read_stmt.targets, lv2);
+            ast_list_push(p->arena, &r->as.read_stmt.targets, lv2);
         }
     }
     expect(p, TOK_PAREN_FERMANTE, "')' attendu après Lire(...)");
@@ -601,183 +934,334 @@ static ASTNode* parse_stmt_read(Parser* p) {
 }
 
 static ASTNode* parse_stmt_return(Parser* p) {
-    Token* kw = cur(p);
+    Token kw = tok_courant(p);
 
     if (match(p, TOK_RETOURNER)) {
         ASTNode* v = parse_expression(p);
-        return ast_new_return(v, kw->ligne, kw->colonne);
+        return ast_new_return(p->arena, v, kw.ligne, kw.colonne);
     }
 
     if (match(p, TOK_RETOUR)) {
         if (is_return_terminator(p)) {
-            return ast_new_return(NULL, kw->ligne, kw->colonne);
+            return ast_new_return(p->arena, NULL, kw.ligne, kw.colonne);
         }
         ASTNode* v = parse_expression(p);
-        return ast_new_return(v, kw->ligne, kw->colonne);
+        return ast_new_return(p->arena, v, kw.ligne, kw.colonne);
     }
 
     return NULL;
 }
 
-static ASTNode* parse_stmt_if(Parser* p) {
-    Token* kw = cur(p);
-    match(p, TOK_SI);
+// INSTRUCTIONS COMPOSÉES (sans récursion)
+//
+// Les blocs de Si / TantQue / Pour / Répéter / Selon peuvent contenir
+// d'autres instructions composées. Au lieu de la chaîne récursive
+// parse_statement -> parse_stmt_si -> parse_block_until -> ..., une
+// instruction composée est ouverte (en-tête lu, cadre empilé pour son
+// bloc) et c'est toujours le bloc du cadre au sommet qui est rempli. À la
+// fin d'un bloc, l'instruction reprend : autre bloc (SinonSi, Sinon, Cas,
+// Défaut) ou mot-clé de fin ; complète, elle rejoint le bloc du cadre
+// parent. Les messages d'erreur et l'ordre de lecture des tokens sont
+// ceux de la descente récursive.
+
+typedef enum {
+    BLOC_SI_ALORS,
+    BLOC_SI_SINONSI,
+    BLOC_SI_SINON,
+    BLOC_TANTQUE,
+    BLOC_POUR,
+    BLOC_REPETER,
+    BLOC_SELON_CAS,
+    BLOC_SELON_DEFAUT
+} RoleBloc;
+
+typedef struct CadreInstr {
+    RoleBloc role;
+    ASTNode* instr;     // instruction composée propriétaire du bloc
+    ASTNode* cas;       // BLOC_SELON_CAS : Cas en cours
+    ASTNode* bloc;      // bloc en cours de lecture
+    TokenType arrets[3];
+    bool cas_vu;        // Selon : au moins un Cas ou Défaut
+} CadreInstr;
+
+static void ouvrir_bloc(Parser* p, RoleBloc role, ASTNode* instr, ASTNode* cas,
+                        TokenType stop1, TokenType stop2, TokenType stop3, bool cas_vu) {
+    if (p->nb_cadres_instr >= p->cap_cadres_instr) {
+        p->cadres_instr = (CadreInstr*)pile_agrandir(p->cadres_instr, &p->cap_cadres_instr,
+                                                     sizeof(CadreInstr));
+    }
+    Token debut_bloc = tok_courant(p);
+    CadreInstr* c = &p->cadres_instr[p->nb_cadres_instr++];
+    c->role = role;
+    c->instr = instr;
+    c->cas = cas;
+    c->bloc = ast_new_block(p->arena, debut_bloc.ligne, debut_bloc.colonne);
+    c->arrets[0] = stop1;
+    c->arrets[1] = stop2;
+    c->arrets[2] = stop3;
+    c->cas_vu = cas_vu;
+}
 
-    ASTNode* cond = parse_expression(p);
-    expect(p, TOK_ALORS, "'Alors' attendu");
-    skip_fin_instr(p);
+static bool at_arret(Parser* p, const CadreInstr* c) {
+    TokenType t = cur(p);
+    return t == c->arrets[0] || t == c->arrets[1] || t == c->arrets[2];
+}
 
-    ASTNode* then_block = parse_block_until(p, TOK_SINONSI, TOK_SINON, TOK_FIN_SI);
-    ASTNode* ifn = ast_new_if(cond, then_block, kw->ligne, kw->colonne);
+// Token qui termine un bloc englobant (mot-clé de fin manquant dans le
+// bloc courant) : les blocs ouverts se ferment sans le consommer, chaque
+// instruction signalant son mot-clé de fin absent
+static bool ferme_bloc_englobant(Parser* p) {
+    TokenType t = cur(p);
+    if (est_fin_structure(t)) return true;
+    for (int i = 0; i < p->nb_cadres_instr; i++) {
+        if (at_arret(p, &p->cadres_instr[i])) return true;
+    }
+    return false;
+}
 
-    while (match(p, TOK_SINONSI)) {
+// Si : après le bloc Alors ou un bloc SinonSi
+static ASTNode* suite_si(Parser* p, ASTNode* ifn) {
+    if (match(p, TOK_SINONSI)) {
         ASTNode* ec = parse_expression(p);
         expect(p, TOK_ALORS, "'Alors' attendu après SinonSi");
         skip_fin_instr(p);
 
-        ASTNode* eb = parse_block_until(p, TOK_SINONSI, TOK_SINON, TOK_FIN_SI);
-        ast_list_push(&ifn->as.if_stmt.elif_conds, ec);
-        ast_list_push(&ifn->as.if_stmt.elif_blocks, eb);
+        ast_list_push(p->arena, &ifn->as.if_stmt.elif_conds, ec);
+        ouvrir_bloc(p, BLOC_SI_SINONSI, ifn, NULL, TOK_SINONSI, TOK_SINON, TOK_FIN_SI, false);
+        return NULL;
     }
 
     if (match(p, TOK_SINON)) {
         skip_fin_instr(p);
-        ifn->as.if_stmt.else_block = parse_block_until(p, TOK_FIN_SI, TOK_EOF, TOK_EOF);
+        ouvrir_bloc(p, BLOC_SI_SINON, ifn, NULL, TOK_FIN_SI, TOK_EOF, TOK_EOF, false);
+        return NULL;
     }
 
     expect(p, TOK_FIN_SI, "'FinSi' attendu");
     return ifn;
 }
 
-static ASTNode* parse_stmt_while(Parser* p) {
-    Token* kw = cur(p);
-    match(p, TOK_TANTQUE);
+// Selon : Cas et Défaut jusqu'à FinSelon
+static ASTNode* suite_selon(Parser* p, ASTNode* sw, bool cas_vu) {
+    while (!is_eof(p) && !at(p, TOK_FIN_SELON)) {
+        skip_fin_instr(p);
+        if (at(p, TOK_FIN_SELON) || is_eof(p)) break;
 
-    ASTNode* cond = parse_expression(p);
-    skip_fin_instr(p);
+        if (match(p, TOK_CAS)) {
+            Token kw_cas = tok_precedent(p);
+            ASTNode* cas = ast_new_case(p->arena, kw_cas.ligne, kw_cas.colonne);
 
-    ASTNode* body = parse_block_until(p, TOK_FINTANTQUE, TOK_EOF, TOK_EOF);
-    expect(p, TOK_FINTANTQUE, "'FinTantQue' attendu");
-    return ast_new_while(cond, body, kw->ligne, kw->colonne);
-}
+            ASTNode* v1 = parse_expression(p);
+            ast_list_push(p->arena, &cas->as.case_stmt.values, v1);
+            while (match(p, TOK_VIRGULE)) {
+                ASTNode* vx = parse_expression(p);
+                ast_list_push(p->arena, &cas->as.case_stmt.values, vx);
+            }
 
-static ASTNode* parse_stmt_for(Parser* p) {
-    Token* kw = cur(p);
-    match(p, TOK_POUR);
+            expect(p, TOK_DEUX_POINTS, "':' attendu après Cas ...");
+            skip_fin_instr(p);
 
-    Token* var = cur(p);
-    expect(p, TOK_ID, "Variable de boucle attendue (ID)");
+            ouvrir_bloc(p, BLOC_SELON_CAS, sw, cas, TOK_CAS, TOK_DEFAUT, TOK_FIN_SELON, true);
+            return NULL;
+        }
 
-    expect(p, TOK_AFFECTATION, "'<-' attendu dans Pour");
-    ASTNode* start = parse_expression(p);
+        if (match(p, TOK_DEFAUT)) {
+            expect(p, TOK_DEUX_POINTS, "':' attendu après Défaut");
+            skip_fin_instr(p);
 
-    expect(p, TOK_JUSQUA, "'jusqu'à' attendu");
-    ASTNode* end = parse_expression(p);
+            ouvrir_bloc(p, BLOC_SELON_DEFAUT, sw, NULL, TOK_FIN_SELON, TOK_EOF, TOK_EOF, true);
+            return NULL;
+        }
 
-    ASTNode* step = NULL;
-    if (match(p, TOK_PAS)) {
-        step = parse_expression(p);
+        if (ferme_bloc_englobant(p)) break;
+        parser_add_error(p, "Dans Selon: attendu 'Cas', 'Défaut' ou 'FinSelon'");
+        synchroniser(p);
     }
 
-    skip_fin_instr(p);
-
-    ASTNode* body = parse_block_until(p, TOK_FIN_POUR, TOK_EOF, TOK_EOF);
-    expect(p, TOK_FIN_POUR, "'FinPour' attendu");
+    if (!cas_vu) {
+        parser_add_error(p, "Selon: au moins un Cas ou Défaut est attendu");
+    }
 
-    return ast_new_for(var->valeur, start, end, step, body, kw->ligne, kw->colonne);
+    expect(p, TOK_FIN_SELON, "'FinSelon' attendu");
+    return sw;
 }
 
-static ASTNode* parse_stmt_repeat(Parser* p) {
-    Token* kw = cur(p);
-    match(p, TOK_REPETER);
-    skip_fin_instr(p);
+// Lit l'en-tête de l'instruction composée courante et ouvre son premier
+// bloc. Retourne NULL (bloc ouvert) ou l'instruction déjà complète.
+static ASTNode* ouvrir_instr(Parser* p) {
+    Token kw = tok_courant(p);
+
+    if (match(p, TOK_SI)) {
+        ASTNode* cond = parse_expression(p);
+        expect(p, TOK_ALORS, "'Alors' attendu");
+        skip_fin_instr(p);
 
-    ASTNode* body = parse_block_until(p, TOK_TANTQUE, TOK_EOF, TOK_EOF);
+        ASTNode* ifn = ast_new_if(p->arena, cond, NULL, kw.ligne, kw.colonne);
+        ouvrir_bloc(p, BLOC_SI_ALORS, ifn, NULL, TOK_SINONSI, TOK_SINON, TOK_FIN_SI, false);
+        return NULL;
+    }
 
-    ASTNode* until_cond = NULL;
     if (match(p, TOK_TANTQUE)) {
-        until_cond = parse_expression(p);
+        ASTNode* cond = parse_expression(p);
+        skip_fin_instr(p);
+
+        ASTNode* wh = ast_new_while(p->arena, cond, NULL, kw.ligne, kw.colonne);
+        ouvrir_bloc(p, BLOC_TANTQUE, wh, NULL, TOK_FINTANTQUE, TOK_EOF, TOK_EOF, false);
+        return NULL;
     }
 
-    return ast_new_repeat(body, until_cond, kw->ligne, kw->colonne);
-}
+    if (match(p, TOK_POUR)) {
+        Token var = tok_courant(p);
+        expect(p, TOK_ID, "Variable de boucle attendue (ID)");
 
-// SELON / CAS / DEFAUT
+        expect(p, TOK_AFFECTATION, "'<-' attendu dans Pour");
+        ASTNode* start = parse_expression(p);
 
-static ASTNode* parse_stmt_switch(Parser* p) {
-    Token* kw = cur(p);
-    match(p, TOK_SELON);
+        expect(p, TOK_JUSQUA, "'jusqu'à' attendu");
+        ASTNode* end = parse_expression(p);
 
-    ASTNode* expr = parse_expression(p);
-    skip_fin_instr(p);
+        ASTNode* step = NULL;
+        if (match(p, TOK_PAS)) {
+            step = parse_expression(p);
+        }
 
-    ASTNode* sw = ast_new_switch(expr, kw->ligne, kw->colonne);
+        skip_fin_instr(p);
 
-    bool saw_case_or_default = false;
+        ASTNode* fr = ast_new_for(p->arena, tok_nom(p, &var), start, end, step, NULL, kw.ligne, kw.colonne);
+        ouvrir_bloc(p, BLOC_POUR, fr, NULL, TOK_FIN_POUR, TOK_EOF, TOK_EOF, false);
+        return NULL;
+    }
 
-    while (!is_eof(p) && !at(p, TOK_FIN_SELON)) {
+    if (match(p, TOK_REPETER)) {
         skip_fin_instr(p);
-        if (at(p, TOK_FIN_SELON) || is_eof(p)) break;
 
-        if (match(p, TOK_CAS)) {
-            saw_case_or_default = true;
-            ASTNode* cas = ast_new_case(prev(p)->ligne, prev(p)->colonne);
+        ASTNode* rp = ast_new_repeat(p->arena, NULL, NULL, kw.ligne, kw.colonne);
+        ouvrir_bloc(p, BLOC_REPETER, rp, NULL, TOK_TANTQUE, TOK_EOF, TOK_EOF, false);
+        return NULL;
+    }
 
-            ASTNode* v1 = parse_expression(p);
-            ast_list_push(&cas->as.case_stmt.values, v1);
-            while (match(p, TOK_VIRGULE)) {
-                ASTNode* vx = parse_expression(p);
-                ast_list_push(&cas->as.case_stmt.values, vx);
+    // Selon
+    match(p, TOK_SELON);
+    ASTNode* expr = parse_expression(p);
+    skip_fin_instr(p);
+
+    ASTNode* sw = ast_new_switch(p->arena, expr, kw.ligne, kw.colonne);
+    return suite_selon(p, sw, false);
+}
+
+// Le bloc du cadre c est terminé : l'instruction reprend. Retourne NULL
+// (nouveau bloc ouvert) ou l'instruction complète.
+static ASTNode* reprendre_instr(Parser* p, const CadreInstr* c) {
+    ASTNode* n = c->instr;
+
+    switch (c->role) {
+        case BLOC_SI_ALORS:
+            n->as.if_stmt.then_block = c->bloc;
+            return suite_si(p, n);
+
+        case BLOC_SI_SINONSI:
+            ast_list_push(p->arena, &n->as.if_stmt.elif_blocks, c->bloc);
+            return suite_si(p, n);
+
+        case BLOC_SI_SINON:
+            n->as.if_stmt.else_block = c->bloc;
+            expect(p, TOK_FIN_SI, "'FinSi' attendu");
+            return n;
+
+        case BLOC_TANTQUE:
+            n->as.while_stmt.body = c->bloc;
+            expect(p, TOK_FINTANTQUE, "'FinTantQue' attendu");
+            return n;
+
+        case BLOC_POUR:
+            n->as.for_stmt.body = c->bloc;
+            expect(p, TOK_FIN_POUR, "'FinPour' attendu");
+            return n;
+
+        case BLOC_REPETER:
+            n->as.repeat_stmt.body = c->bloc;
+            if (match(p, TOK_TANTQUE)) {
+                n->as.repeat_stmt.until_cond = parse_expression(p);
             }
+            return n;
 
-            expect(p, TOK_DEUX_POINTS, "':' attendu après Cas ...");
-            skip_fin_instr(p);
+        case BLOC_SELON_CAS:
+            c->cas->as.case_stmt.body = c->bloc;
+            ast_list_push(p->arena, &n->as.switch_stmt.cases, c->cas);
+            return suite_selon(p, n, c->cas_vu);
 
-            cas->as.case_stmt.body = parse_block_until(p, TOK_CAS, TOK_DEFAUT, TOK_FIN_SELON);
-            ast_list_push(&sw->as.switch_stmt.cases, cas);
-            continue;
+        case BLOC_SELON_DEFAUT:
+            n->as.switch_stmt.default_block = c->bloc;
+            return suite_selon(p, n, c->cas_vu);
+    }
+    return n;
+}
+
+// Instruction composée complète, blocs imbriqués compris
+static ASTNode* parse_stmt_compose(Parser* p) {
+    int base = p->nb_cadres_instr;
+    ASTNode* fini = ouvrir_instr(p);
+
+    while (p->nb_cadres_instr > base) {
+        CadreInstr* c = &p->cadres_instr[p->nb_cadres_instr - 1];
+
+        // Instruction composée qui vient de se terminer dans ce bloc
+        if (fini) {
+            ast_block_add(p->arena, c->bloc, fini);
+            fini = NULL;
+            skip_fin_instr(p);
         }
 
-        if (match(p, TOK_DEFAUT)) {
-            saw_case_or_default = true;
-            expect(p, TOK_DEUX_POINTS, "':' attendu après Défaut");
+        // Suite du bloc au sommet (comme parse_block_until)
+        bool ouvert = false;
+        while (!is_eof(p) && !at_arret(p, c)) {
             skip_fin_instr(p);
+            if (at_arret(p, c) || is_eof(p)) break;
 
-            sw->as.switch_stmt.default_block = parse_block_until(p, TOK_FIN_SELON, TOK_EOF, TOK_EOF);
-            continue;
-        }
+            if (!is_start_of_stmt(p)) {
+                if (ferme_bloc_englobant(p)) break;
+                parser_add_error(p, "Instruction attendue dans bloc");
+                synchroniser(p);
+                continue;
+            }
 
-        parser_add_error(p, "Dans Selon: attendu 'Cas', 'Défaut' ou 'FinSelon'");
-        p->pos++;
-    }
+            if (est_instr_composee(p)) {
+                fini = ouvrir_instr(p);
+                ouvert = true;
+                break;
+            }
 
-    if (!saw_case_or_default) {
-        parser_add_error(p, "Selon: au moins un Cas ou Défaut est attendu");
-    }
+            ASTNode* st = parse_statement(p);
+            if (st) ast_block_add(p->arena, c->bloc, st);
+            skip_fin_instr(p);
+        }
+        if (ouvert) continue;
 
-    expect(p, TOK_FIN_SELON, "'FinSelon' attendu");
-    return sw;
+        CadreInstr termine = p->cadres_instr[--p->nb_cadres_instr];
+        fini = reprendre_instr(p, &termine);
+    }
+    return fini;
 }
 
 // Lvalue + expressions
 
 static ASTNode* parse_lvalue(Parser* p) {
-    Token* id = cur(p);
+    Token id = tok_courant(p);
     expect(p, TOK_ID, "ID attendu");
 
-    ASTNode* base = ast_new_ident(id->valeur, id->ligne, id->colonne);
+    ASTNode* base = ast_new_ident(p->arena, tok_nom(p, &id), id.ligne, id.colonne);
 
     while (true) {
         if (match(p, TOK_CROCHET_OUVRANT)) {
             ASTNode* idx = parse_expression(p);
             expect(p, TOK_CROCHET_FERMANT, "']' attendu");
-            base = ast_new_index(base, idx, id->ligne, id->colonne);
+            base = ast_new_index(p->arena, base, idx, id.ligne, id.colonne);
             continue;
         }
         if (match(p, TOK_POINT)) {
-            Token* fld = cur(p);
+            Token fld = tok_courant(p);
             expect(p, TOK_ID, "Nom de champ attendu après '.'");
-            base = ast_new_field_access(base, fld->valeur, fld->ligne, fld->colonne);
+            base = ast_new_field_access(p->arena, base, tok_nom(p, &fld), fld.ligne, fld.colonne);
             continue;
         }
         break;
@@ -786,163 +1270,236 @@ static ASTNode* parse_lvalue(Parser* p) {
     return base;
 }
 
-static ASTNode* parse_expression(Parser* p) { return parse_expr_or(p); }
-
-static ASTNode* parse_expr_or(Parser* p) {
-    ASTNode* left = parse_expr_and(p);
-    while (match(p, TOK_OU)) {
-        Token* op = prev(p);
-        ASTNode* right = parse_expr_and(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
-    }
-    return left;
-}
-
-static ASTNode* parse_expr_and(Parser* p) {
-    ASTNode* left = parse_expr_cmp(p);
-    while (match(p, TOK_ET)) {
-        Token* op = prev(p);
-        ASTNode* right = parse_expr_cmp(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
+// EXPRESSIONS (sans récursion)
+//
+// Analyse par précédence avec des piles explicites : opérandes,
+// opérateurs en attente et cadres des sous-expressions ouvertes ('(',
+// indice '[', arguments d'appel). La profondeur d'imbrication ne coûte
+// pas de pile C. L'arbre est celui de la descente récursive : les
+// unaires s'appliquent à l'opérande postfixe complet, les binaires sont
+// associatifs à gauche ('^' compris) selon leur force de liaison
+// (0 = pas un opérateur binaire).
+
+static const uint8_t LIAISON_BINAIRE[TOK_NB_TYPES] = {
+    [TOK_OU] = 1,
+    [TOK_ET] = 2,
+    [TOK_EGAL] = 3, [TOK_DIFFERENT] = 3,
+    [TOK_INFERIEUR] = 3, [TOK_INFERIEUR_EGAL] = 3,
+    [TOK_SUPERIEUR] = 3, [TOK_SUPERIEUR_EGAL] = 3,
+    [TOK_PLUS] = 4, [TOK_MOINS] = 4,
+    [TOK_FOIS] = 5, [TOK_DIVISE] = 5, [TOK_DIV_ENTIER] = 5, [TOK_MODULO] = 5,
+    [TOK_PUISSANCE] = 6,
+};
+
+typedef struct OperateurEnAttente {
+    TokenType op;
+    bool unaire;
+    int ligne, colonne;
+} OperateurEnAttente;
+
+typedef enum {
+    CADRE_RACINE,
+    CADRE_PAREN,
+    CADRE_INDICE,
+    CADRE_APPEL
+} TypeCadreExpr;
+
+typedef struct CadreExpr {
+    TypeCadreExpr type;
+    ASTNode* noeud;         // INDICE : base indexée ; APPEL : nœud CALL
+    int ligne, colonne;     // INDICE : position du '['
+    int bas_operateurs;     // opérateurs du cadre : [bas_operateurs, nb)
+} CadreExpr;
+
+static void empiler_operande(Parser* p, ASTNode* n) {
+    if (p->nb_operandes >= p->cap_operandes) {
+        p->operandes = (ASTNode**)pile_agrandir(p->operandes, &p->cap_operandes, sizeof(ASTNode*));
     }
-    return left;
+    p->operandes[p->nb_operandes++] = n;
 }
 
-static bool is_cmp(TokenType t) {
-    return t == TOK_EGAL || t == TOK_DIFFERENT ||
-           t == TOK_INFERIEUR || t == TOK_INFERIEUR_EGAL ||
-           t == TOK_SUPERIEUR || t == TOK_SUPERIEUR_EGAL;
+static ASTNode* depiler_operande(Parser* p) {
+    return p->operandes[--p->nb_operandes];
 }
 
-static ASTNode* parse_expr_cmp(Parser* p) {
-    ASTNode* left = parse_expr_add(p);
-    while (is_cmp(cur(p)->type)) {
-        Token* op = cur(p);
-        p->pos++;
-        ASTNode* right = parse_expr_add(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
+static void empiler_operateur(Parser* p, const Token* op, bool unaire) {
+    if (p->nb_operateurs >= p->cap_operateurs) {
+        p->operateurs = (OperateurEnAttente*)pile_agrandir(p->operateurs, &p->cap_operateurs,
+                                                           sizeof(OperateurEnAttente));
     }
-    return left;
+    OperateurEnAttente* o = &p->operateurs[p->nb_operateurs++];
+    o->op = op->type;
+    o->unaire = unaire;
+    o->ligne = op->ligne;
+    o->colonne = op->colonne;
 }
 
-static ASTNode* parse_expr_add(Parser* p) {
-    ASTNode* left = parse_expr_mul(p);
-    while (at(p, TOK_PLUS) || at(p, TOK_MOINS)) {
-        Token* op = cur(p);
-        p->pos++;
-        ASTNode* right = parse_expr_mul(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
+static void ouvrir_cadre_expr(Parser* p, TypeCadreExpr type, ASTNode* noeud, int ligne, int colonne) {
+    if (p->nb_cadres_expr >= p->cap_cadres_expr) {
+        p->cadres_expr = (CadreExpr*)pile_agrandir(p->cadres_expr, &p->cap_cadres_expr,
+                                                   sizeof(CadreExpr));
     }
-    return left;
+    CadreExpr* c = &p->cadres_expr[p->nb_cadres_expr++];
+    c->type = type;
+    c->noeud = noeud;
+    c->ligne = ligne;
+    c->colonne = colonne;
+    c->bas_operateurs = p->nb_operateurs;
 }
 
-static ASTNode* parse_expr_mul(Parser* p) {
-    ASTNode* left = parse_expr_pow(p);
-    while (at(p, TOK_FOIS) || at(p, TOK_DIVISE) || at(p, TOK_DIV_ENTIER) || at(p, TOK_MODULO)) {
-        Token* op = cur(p);
-        p->pos++;
-        ASTNode* right = parse_expr_pow(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
+// Unaires en attente au sommet : ils portent sur l'opérande au sommet
+static void reduire_unaires(Parser* p, int bas) {
+    while (p->nb_operateurs > bas && p->operateurs[p->nb_operateurs - 1].unaire) {
+        OperateurEnAttente o = p->operateurs[--p->nb_operateurs];
+        ASTNode* e = depiler_operande(p);
+        empiler_operande(p, ast_new_unary(p->arena, o.op, e, o.ligne, o.colonne));
     }
-    return left;
 }
 
-static ASTNode* parse_expr_pow(Parser* p) {
-    ASTNode* left = parse_expr_unary(p);
-    while (match(p, TOK_PUISSANCE)) {
-        Token* op = prev(p);
-        ASTNode* right = parse_expr_unary(p);
-        left = ast_new_binary(op->type, left, right, op->ligne, op->colonne);
+// Binaires en attente de force >= min (associativité à gauche)
+static void reduire_binaires(Parser* p, int bas, int min) {
+    while (p->nb_operateurs > bas && LIAISON_BINAIRE[p->operateurs[p->nb_operateurs - 1].op] >= min) {
+        OperateurEnAttente o = p->operateurs[--p->nb_operateurs];
+        ASTNode* right = depiler_operande(p);
+        ASTNode* left = depiler_operande(p);
+        empiler_operande(p, ast_new_binary(p->arena, o.op, left, right, o.ligne, o.colonne));
     }
-    return left;
 }
 
-static ASTNode* parse_expr_unary(Parser* p) {
-    if (match(p, TOK_NON)) {
-        Token* op = prev(p);
-        ASTNode* e = parse_expr_unary(p);
-        return ast_new_unary(op->type, e, op->ligne, op->colonne);
-    }
-    if (match(p, TOK_MOINS)) {
-        Token* op = prev(p);
-        ASTNode* e = parse_expr_unary(p);
-        return ast_new_unary(op->type, e, op->ligne, op->colonne);
-    }
-    return parse_expr_postfix(p);
-}
+// postfixe_seul : opérande postfixe seulement (début d'instruction
+// "ID ..."), sans opérateur binaire au premier niveau
+static ASTNode* parse_expr_iter(Parser* p, bool postfixe_seul) {
+    int base_cadres = p->nb_cadres_expr;
+    bool attente_operande = true;
 
-static ASTNode* parse_expr_postfix(Parser* p) {
-    ASTNode* base = parse_expr_primary(p);
+    ouvrir_cadre_expr(p, CADRE_RACINE, NULL, 0, 0);
 
     while (true) {
+        if (attente_operande) {
+            // Préfixes : unaires et parenthèses
+            if (at(p, TOK_NON) || at(p, TOK_MOINS)) {
+                consommer(p);
+                Token op = tok_precedent(p);
+                empiler_operateur(p, &op, true);
+                continue;
+            }
+            if (match(p, TOK_PAREN_OUVRANTE)) {
+                ouvrir_cadre_expr(p, CADRE_PAREN, NULL, 0, 0);
+                continue;
+            }
+            empiler_operande(p, parse_expr_primary(p));
+            attente_operande = false;
+            continue;
+        }
+
+        // Suffixes de l'opérande au sommet
         // index
         if (match(p, TOK_CROCHET_OUVRANT)) {
-            Token* br = prev(p);
-            ASTNode* idx = parse_expression(p);
-            expect(p, TOK_CROCHET_FERMANT, "']' attendu");
-            base = ast_new_index(base, idx, br->ligne, br->colonne);
+            Token br = tok_precedent(p);
+            ouvrir_cadre_expr(p, CADRE_INDICE, depiler_operande(p), br.ligne, br.colonne);
+            attente_operande = true;
             continue;
         }
         // field access
         if (match(p, TOK_POINT)) {
-            Token* fld = cur(p);
+            Token fld = tok_courant(p);
             expect(p, TOK_ID, "Nom de champ attendu après '.'");
-            base = ast_new_field_access(base, fld->valeur, fld->ligne, fld->colonne);
+            ASTNode* base = depiler_operande(p);
+            empiler_operande(p, ast_new_field_access(p->arena, base, tok_nom(p, &fld), fld.ligne, fld.colonne));
             continue;
         }
         // call
         if (match(p, TOK_PAREN_OUVRANTE)) {
-            Token* lp = prev(p);
-            ASTNode* call = ast_new_call(base, lp->ligne, lp->colonne);
+            Token lp = tok_precedent(p);
+            ASTNode* call = ast_new_call(p->arena, depiler_operande(p), lp.ligne, lp.colonne);
 
             if (!at(p, TOK_PAREN_FERMANTE)) {
-                ASTNode* a1 = parse_expression(p);
-                ast_list_push(&call->as.call.args, a1);
-                while (match(p, TOK_VIRGULE)) {
-                    ASTNode* ax = parse_expression(p);
-                    ast_list_push(&call->as.call.args, ax);
-                }
+                ouvrir_cadre_expr(p, CADRE_APPEL, call, 0, 0);
+                attente_operande = true;
+                continue;
             }
             expect(p, TOK_PAREN_FERMANTE, "')' attendu");
-            base = call;
+            empiler_operande(p, call);
             continue;
         }
-        break;
-    }
 
-    return base;
+        CadreExpr* c = &p->cadres_expr[p->nb_cadres_expr - 1];
+        reduire_unaires(p, c->bas_operateurs);
+
+        // Opérateur binaire
+        int force = LIAISON_BINAIRE[cur(p)];
+        if (postfixe_seul && p->nb_cadres_expr == base_cadres + 1) force = 0;
+        if (force > 0) {
+            Token op = tok_courant(p);
+            consommer(p);
+            reduire_binaires(p, c->bas_operateurs, force);
+            empiler_operateur(p, &op, false);
+            attente_operande = true;
+            continue;
+        }
+
+        // Fin de la sous-expression du cadre
+        reduire_binaires(p, c->bas_operateurs, 1);
+        ASTNode* e = depiler_operande(p);
+        CadreExpr ferme = p->cadres_expr[--p->nb_cadres_expr];
+
+        switch (ferme.type) {
+            case CADRE_RACINE:
+                return e;
+
+            case CADRE_PAREN:
+                expect(p, TOK_PAREN_FERMANTE, "')' attendu");
+                empiler_operande(p, e);
+                break;
+
+            case CADRE_INDICE:
+                expect(p, TOK_CROCHET_FERMANT, "']' attendu");
+                empiler_operande(p, ast_new_index(p->arena, ferme.noeud, e, ferme.ligne, ferme.colonne));
+                break;
+
+            case CADRE_APPEL:
+                ast_list_push(p->arena, &ferme.noeud->as.call.args, e);
+                if (match(p, TOK_VIRGULE)) {
+                    p->nb_cadres_expr++;    // argument suivant, même cadre
+                    attente_operande = true;
+                    break;
+                }
+                expect(p, TOK_PAREN_FERMANTE, "')' attendu");
+                empiler_operande(p, ferme.noeud);
+                break;
+        }
+    }
 }
 
+static ASTNode* parse_expression(Parser* p) { return parse_expr_iter(p, false); }
+
 static ASTNode* parse_expr_primary(Parser* p) {
-    Token* t = cur(p);
+    Token t = tok_courant(p);
 
     if (match(p, TOK_CONST_ENTIERE)) {
         long long v = 0;
-        if (t->valeur) v = atoll(t->valeur);
-        return ast_new_lit_int(v, t->ligne, t->colonne);
+        v = atoll(tok_texte(p, &t));
+        return ast_new_lit_int(p->arena, v, t.ligne, t.colonne);
     }
     if (match(p, TOK_CONST_REEL)) {
-        return ast_new_lit_real(t->valeur ? t->valeur : "0", t->ligne, t->colonne);
+        return ast_new_lit_real(p->arena, tok_texte(p, &t), t.ligne, t.colonne);
     }
     if (match(p, TOK_CONST_CHAINE)) {
-        return ast_new_lit_string(t->valeur ? t->valeur : "", t->ligne, t->colonne);
+        return ast_new_lit_string(p->arena, tok_texte(p, &t), t.ligne, t.colonne);
     }
     if (match(p, TOK_VRAI)) {
-        return ast_new_lit_bool(true, t->ligne, t->colonne);
+        return ast_new_lit_bool(p->arena, true, t.ligne, t.colonne);
     }
     if (match(p, TOK_FAUX)) {
-        return ast_new_lit_bool(false, t->ligne, t->colonne);
+        return ast_new_lit_bool(p->arena, false, t.ligne, t.colonne);
     }
     if (match(p, TOK_ID)) {
-        return ast_new_ident(t->valeur, t->ligne, t->colonne);
-    }
-    if (match(p, TOK_PAREN_OUVRANTE)) {
-        ASTNode* e = parse_expression(p);
-        expect(p, TOK_PAREN_FERMANTE, "')' attendu");
-        return e;
+        return ast_new_ident(p->arena, tok_nom(p, &t), t.ligne, t.colonne);
     }
+    // '(' expr ')' : voir parse_expr_iter()
 
+    // Fin de ligne ou mot-clé : laissés à l'instruction ou au bloc
     parser_add_error(p, "Expression attendue");
-    p->pos++;
-    return ast_new_ident("<?>", t->ligne, t->colonne);
+    if (!est_point_reprise(cur(p))) consommer(p);
+    return ast_new_ident(p->arena, "<?>", t.ligne, t.colonne);
 }
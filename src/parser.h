@@ -2,19 +2,66 @@
 #define PARSER_H
 
 #include "token.h"
+#include "lexer.h"
 #include "ast.h"
 
+// Budget d'erreurs syntaxiques par fichier : au-delà, l'analyse s'arrête
+#define PARSER_ERREURS_MAX 20
+
+// Définitions analysées en parallèle (voir parser.c) : au moins ce nombre
+// de tokens, et ce nombre de définitions par thread
+#define PARSER_SEUIL_PARALLELE 200000
+#define PARSER_DEFS_MIN_GROUPE 16
+
 typedef struct {
-    Token* tokens;
-    int count;
+    Lexer* lexer;
+    const uint8_t* types;   // types des tokens du lexer (seul tableau lu
+    int count;              // pour avancer ; voir tok_courant())
     int pos;
+    TableLignes* lignes;    // positions des tokens (celle du lexer, ou
+                            // celle d'un thread de parse_program())
+
+    // Mode flux : tokens tirés du lexer à la demande (tokens == NULL)
+    Lexer* flux;
+    Token precedent;
+
+    ASTArena* arena;      // nœuds de l'AST construit (à l'appelant)
+
+    const char* source;   // texte des tokens (Token.debut / longueur)
+    char* texte;          // tampon de tok_texte()
+    int texte_cap;
 
     char** errors;
     int err_count;
     int err_cap;
+
+    // Reprise sur erreur (mode panique, voir parser.c)
+    bool panique;         // erreur signalée, fin d'instruction pas encore
+                          // atteinte : les erreurs en cascade sont ignorées
+    bool abandon;         // budget épuisé : cur() ne rend plus que TOK_EOF
+
+    // Piles de l'analyse sans récursion (voir parser.c) : les
+    // imbrications d'expressions et de blocs n'utilisent pas la pile C.
+    // Conservées d'un appel à l'autre.
+    ASTNode** operandes;
+    int nb_operandes;
+    int cap_operandes;
+    struct OperateurEnAttente* operateurs;
+    int nb_operateurs;
+    int cap_operateurs;
+    struct CadreExpr* cadres_expr;
+    int nb_cadres_expr;
+    int cap_cadres_expr;
+    struct CadreInstr* cadres_instr;
+    int nb_cadres_instr;
+    int cap_cadres_instr;
 } Parser;
 
-void parser_init(Parser* p, Token* tokens, int count);
+// Après analyser_lexicalement() : le parser lit les tableaux du lexer.
+// L'AST est alloué dans arena, qui doit survivre à parse_program().
+void parser_init(Parser* p, Lexer* lexer, ASTArena* arena);
+// Le parser consomme directement le lexer (mémoire de tokens constante)
+void parser_init_flux(Parser* p, Lexer* lexer, ASTArena* arena);
 void parser_free(Parser* p);
 
 ASTNode* parse_program(Parser* p);
@@ -0,0 +1,364 @@
+#include "pliage.h"
+#include "semantique.h"
+#include "token.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Un seul parcours en profondeur (ast_parcourir) : à la sortie d'un nœud,
+// ses enfants ont déjà été pliés, et chaque champ enfant dont la valeur
+// est connue est remplacé par un littéral. La valeur d'un enfant ne
+// regarde donc qu'un niveau (littéraux, constantes, opération sur des
+// littéraux) : pas de récursion, quelle que soit la profondeur de
+// l'arbre. Les déclarations précèdent leurs utilisations dans l'ordre du
+// parcours : la valeur d'une `Constante` est déjà pliée quand on la lit.
+
+typedef enum { V_ENTIER, V_REEL, V_BOOLEEN, V_CHAINE } GenreValeur;
+
+typedef struct {
+    GenreValeur genre;
+    long long entier;
+    double reel;
+    bool booleen;
+    char* chaine;       // texte du littéral (arena), non recopié
+} Valeur;
+
+// Nœuds déjà parcourus : avec --partage, un nœud a plusieurs parents et
+// l'arbre n'est parcouru qu'une fois par nœud
+
+typedef struct {
+    ASTNode** cles;
+    uint32_t cap;       // puissance de 2
+    uint32_t nb;
+} EnsembleNoeuds;
+
+typedef struct {
+    ASTArena* arena;
+    EnsembleNoeuds vus;
+    int nb_remplaces;
+} Pliage;
+
+static uint32_t hacher_pointeur(const ASTNode* n, uint32_t cap) {
+    uint64_t v = (uint64_t)(uintptr_t)n;
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdull;
+    v ^= v >> 33;
+    return (uint32_t)v & (cap - 1);
+}
+
+static bool ensemble_agrandir(EnsembleNoeuds* e) {
+    uint32_t ncap = (e->cap == 0) ? 1024 : e->cap * 2;
+    ASTNode** cles = (ASTNode**)calloc(ncap, sizeof(ASTNode*));
+    if (!cles) return false;
+
+    for (uint32_t i = 0; i < e->cap; i++) {
+        if (!e->cles[i]) continue;
+        uint32_t j = hacher_pointeur(e->cles[i], ncap);
+        while (cles[j]) j = (j + 1) & (ncap - 1);
+        cles[j] = e->cles[i];
+    }
+    free(e->cles);
+    e->cles = cles;
+    e->cap = ncap;
+    return true;
+}
+
+// false si n y était déjà (ou si la mémoire manque : on reparcourt)
+static bool ensemble_ajouter(EnsembleNoeuds* e, ASTNode* n) {
+    if ((e->nb + 1) * 2 > e->cap && !ensemble_agrandir(e)) return true;
+    uint32_t i = hacher_pointeur(n, e->cap);
+    while (e->cles[i]) {
+        if (e->cles[i] == n) return false;
+        i = (i + 1) & (e->cap - 1);
+    }
+    e->cles[i] = n;
+    e->nb++;
+    return true;
+}
+
+// Valeurs
+
+static bool entier_32(long long v) {
+    return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+// Lexème "1,5", "1.5" ou ".5"
+static bool lire_reel(const char* texte, double* r) {
+    if (!texte) return false;
+    char tampon[64];
+    size_t n = strlen(texte);
+    if (n == 0 || n >= sizeof(tampon)) return false;
+    for (size_t i = 0; i <= n; i++) tampon[i] = (texte[i] == ',') ? '.' : texte[i];
+    char* fin;
+    *r = strtod(tampon, &fin);
+    return *fin == '\0' && isfinite(*r);
+}
+
+static double en_reel(const Valeur* v) {
+    return (v->genre == V_REEL) ? v->reel : (double)v->entier;
+}
+
+static bool est_nombre(const Valeur* v) {
+    return v->genre == V_ENTIER || v->genre == V_REEL;
+}
+
+// Littéral, ou identificateur d'une constante dont la valeur (déjà
+// pliée) est un littéral du même type. Une constante caractère, dont la
+// valeur est un littéral chaîne, n'est pas propagée.
+static bool valeur_feuille(ASTNode* e, Valeur* v) {
+    if (!e) return false;
+    switch (e->kind) {
+        case AST_LITERAL_INT:
+            v->genre = V_ENTIER;
+            v->entier = e->as.lit_int.value;
+            return entier_32(v->entier);
+        case AST_LITERAL_REAL:
+            v->genre = V_REEL;
+            return lire_reel(e->as.lit_real.text, &v->reel);
+        case AST_LITERAL_BOOL:
+            v->genre = V_BOOLEEN;
+            v->booleen = e->as.lit_bool.value;
+            return true;
+        case AST_LITERAL_STRING:
+            v->genre = V_CHAINE;
+            v->chaine = e->as.lit_string.text;
+            return v->chaine != NULL;
+        case AST_IDENT: {
+            ASTNode* d = e->as.ident.decl;
+            if (!d || d->kind != AST_DECL_CONST || !e->type) return false;
+            ASTNode* valeur = d->as.decl_const.value;
+            if (!valeur || valeur->kind == AST_IDENT || !valeur_feuille(valeur, v)) return false;
+            if (valeur->type == e->type) return true;
+            // Constante réelle initialisée par un entier
+            if (e->type->kind == TY_REAL && v->genre == V_ENTIER) {
+                v->reel = (double)v->entier;
+                v->genre = V_REEL;
+                return true;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+static bool valeur_unaire(ASTNode* e, Valeur* v) {
+    Valeur a;
+    if (!valeur_feuille(e->as.unary.expr, &a)) return false;
+
+    if (e->as.unary.op == TOK_NON && a.genre == V_BOOLEEN) {
+        v->genre = V_BOOLEEN;
+        v->booleen = !a.booleen;
+        return true;
+    }
+    if (e->as.unary.op == TOK_MOINS && a.genre == V_ENTIER) {
+        v->genre = V_ENTIER;
+        v->entier = -a.entier;
+        return entier_32(v->entier);
+    }
+    if (e->as.unary.op == TOK_MOINS && a.genre == V_REEL) {
+        v->genre = V_REEL;
+        v->reel = -a.reel;
+        return true;
+    }
+    return false;
+}
+
+static bool comparer(TokenType op, int c, Valeur* v) {
+    v->genre = V_BOOLEEN;
+    switch (op) {
+        case TOK_EGAL:           v->booleen = c == 0; return true;
+        case TOK_DIFFERENT:      v->booleen = c != 0; return true;
+        case TOK_INFERIEUR:      v->booleen = c < 0;  return true;
+        case TOK_INFERIEUR_EGAL: v->booleen = c <= 0; return true;
+        case TOK_SUPERIEUR:      v->booleen = c > 0;  return true;
+        case TOK_SUPERIEUR_EGAL: v->booleen = c >= 0; return true;
+        default: return false;
+    }
+}
+
+static bool valeur_binaire(ASTNode* e, Valeur* v) {
+    Valeur a, b;
+    if (!valeur_feuille(e->as.binary.lhs, &a) || !valeur_feuille(e->as.binary.rhs, &b)) return false;
+    TokenType op = e->as.binary.op;
+
+    if (op == TOK_ET || op == TOK_OU) {
+        if (a.genre != V_BOOLEEN || b.genre != V_BOOLEEN) return false;
+        v->genre = V_BOOLEEN;
+        v->booleen = (op == TOK_ET) ? (a.booleen && b.booleen) : (a.booleen || b.booleen);
+        return true;
+    }
+
+    if (op == TOK_EGAL || op == TOK_DIFFERENT) {
+        if (a.genre == V_BOOLEEN && b.genre == V_BOOLEEN) return comparer(op, a.booleen != b.booleen, v);
+        if (a.genre == V_CHAINE && b.genre == V_CHAINE) return comparer(op, strcmp(a.chaine, b.chaine), v);
+    }
+
+    if (!est_nombre(&a) || !est_nombre(&b)) return false;
+
+    if (a.genre == V_ENTIER && b.genre == V_ENTIER) {
+        long long x = a.entier, y = b.entier;
+        v->genre = V_ENTIER;
+        switch (op) {
+            case TOK_PLUS:  v->entier = x + y; return entier_32(v->entier);
+            case TOK_MOINS: v->entier = x - y; return entier_32(v->entier);
+            case TOK_FOIS:  v->entier = x * y; return entier_32(v->entier);
+            case TOK_DIV_ENTIER:
+                if (x < 0 || y <= 0) return false;
+                v->entier = x / y;
+                return true;
+            case TOK_MODULO:
+                if (x < 0 || y <= 0) return false;
+                v->entier = x % y;
+                return true;
+            case TOK_PUISSANCE:
+                if (y < 0) return false;
+                // -1, 0 et 1 ne débordent jamais : pas de boucle sur y
+                if (x == 0 || x == 1) {
+                    v->entier = (y == 0) ? 1 : x;
+                    return true;
+                }
+                if (x == -1) {
+                    v->entier = (y % 2 == 0) ? 1 : -1;
+                    return true;
+                }
+                // |x| >= 2 : sorti des 32 bits en au plus 32 tours
+                v->entier = 1;
+                for (long long i = 0; i < y; i++) {
+                    v->entier *= x;
+                    if (!entier_32(v->entier)) return false;
+                }
+                return true;
+            case TOK_DIVISE:
+                return false;
+            default:
+                return comparer(op, (x > y) - (x < y), v);
+        }
+    }
+
+    double x = en_reel(&a), y = en_reel(&b);
+    v->genre = V_REEL;
+    switch (op) {
+        case TOK_PLUS:   v->reel = x + y; break;
+        case TOK_MOINS:  v->reel = x - y; break;
+        case TOK_FOIS:   v->reel = x * y; break;
+        case TOK_DIVISE:
+            if (y == 0.0) return false;
+            v->reel = x / y;
+            break;
+        case TOK_DIV_ENTIER:
+        case TOK_MODULO:
+        case TOK_PUISSANCE:
+            return false;
+        default:
+            return comparer(op, (x > y) - (x < y), v);
+    }
+    return isfinite(v->reel);
+}
+
+// Nouveaux littéraux
+
+// Texte le plus court relu exactement, toujours avec un point ou un
+// exposant (3.0 et non 3 : le littéral doit rester réel dans la cible)
+static char* texte_reel(ASTArena* a, double r) {
+    char tampon[40];
+    for (int precision = 15; precision <= 17; precision++) {
+        snprintf(tampon, sizeof(tampon), "%.*g", precision, r);
+        if (strtod(tampon, NULL) == r) break;
+    }
+    if (!strpbrk(tampon, ".e")) strcat(tampon, ".0");
+    return ast_arena_texte(a, tampon, strlen(tampon));
+}
+
+// Littéral de même type (annotation) que n, NULL si la valeur ne s'y
+// prête pas
+static ASTNode* litteral(Pliage* pl, ASTNode* n, const Valeur* v) {
+    if (!n->type) return NULL;
+    ASTNode* l = NULL;
+
+    switch (n->type->kind) {
+        case TY_INT:
+            if (v->genre != V_ENTIER) return NULL;
+            l = ast_new_node(pl->arena, AST_LITERAL_INT, n->line, n->col);
+            if (l) l->as.lit_int.value = v->entier;
+            break;
+        case TY_REAL:
+            if (!est_nombre(v)) return NULL;
+            l = ast_new_node(pl->arena, AST_LITERAL_REAL, n->line, n->col);
+            if (l) l->as.lit_real.text = texte_reel(pl->arena, en_reel(v));
+            if (l && !l->as.lit_real.text) l = NULL;
+            break;
+        case TY_BOOL:
+            if (v->genre != V_BOOLEEN) return NULL;
+            l = ast_new_node(pl->arena, AST_LITERAL_BOOL, n->line, n->col);
+            if (l) l->as.lit_bool.value = v->booleen;
+            break;
+        case TY_STRING:
+            if (v->genre != V_CHAINE) return NULL;
+            l = ast_new_node(pl->arena, AST_LITERAL_STRING, n->line, n->col);
+            if (l) l->as.lit_string.text = v->chaine;
+            break;
+        default:
+            return NULL;
+    }
+    if (l) l->type = n->type;
+    return l;
+}
+
+static void plier_champ(Pliage* pl, ASTNode** champ) {
+    ASTNode* n = *champ;
+    if (!n) return;
+
+    Valeur v;
+    bool connue;
+    switch (n->kind) {
+        case AST_IDENT:  connue = valeur_feuille(n, &v); break;
+        case AST_UNARY:  connue = valeur_unaire(n, &v); break;
+        case AST_BINARY: connue = valeur_binaire(n, &v); break;
+        default:         return;   // littéral déjà, ou valeur inconnue
+    }
+    if (!connue) return;
+
+    ASTNode* l = litteral(pl, n, &v);
+    if (!l) return;
+    *champ = l;
+    pl->nb_remplaces++;
+}
+
+// Visiteur
+
+// Les types (dimensions des paramètres tableaux) ne sont pas annotés par
+// l'analyse : on n'y descend pas
+static bool entrer(ASTNode* n, void* ctx) {
+    if (n->kind == AST_TYPE_ARRAY) return false;
+    return ensemble_ajouter(&((Pliage*)ctx)->vus, n);
+}
+
+static void sortir(ASTNode* n, void* ctx) {
+    Pliage* pl = (Pliage*)ctx;
+    for (const ASTEnfant* e = AST_ENFANTS[n->kind]; e->genre != AST_ENFANT_FIN; e++) {
+        char* champ = (char*)n + e->offset;
+        if (e->genre == AST_ENFANT_NOEUD) {
+            plier_champ(pl, (ASTNode**)champ);
+        } else {
+            ASTList* l = (ASTList*)champ;
+            for (int i = 0; i < l->count; i++) plier_champ(pl, &l->items[i]);
+        }
+    }
+}
+
+int pliage_programme(ASTNode* prog, ASTArena* arena) {
+    if (!prog) return 0;
+
+    Pliage pl;
+    memset(&pl, 0, sizeof(pl));
+    pl.arena = arena;
+
+    ASTVisiteur visiteur = { entrer, sortir, &pl };
+    ast_parcourir(prog, &visiteur, 1);
+
+    free(pl.vus.cles);
+    return pl.nb_remplaces;
+}
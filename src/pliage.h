@@ -0,0 +1,30 @@
+#ifndef PLIAGE_H
+#define PLIAGE_H
+
+#include "ast.h"
+
+// Pliage et propagation des constantes (option --pliage).
+//
+// Sur un AST vérifié (annotations `type` et `ident.decl` posées par
+// l'analyse sémantique), les sous-expressions dont la valeur est connue
+// à la compilation sont remplacées par un littéral du même type : les
+// identificateurs de `Constante` par leur valeur, puis les opérations
+// (arithmétique entière et réelle, `Div`, `Mod`, `^`, comparaisons, `Et`,
+// `Ou`, `Non`, égalité de chaînes) dont les opérandes sont des
+// littéraux. Les trois générateurs émettent donc le code plié.
+//
+// Une opération n'est pliée que si son résultat est celui du programme
+// non plié avec chaque cible : entiers dans l'intervalle 32 bits, `Div`
+// et `Mod` sur des opérandes positifs (C et Java tronquent, Python
+// arrondit vers le bas), `/` seulement avec un opérande réel (la
+// division de deux entiers diffère d'une cible à l'autre). `^` n'est
+// plié qu'entre entiers, exposant positif : les trois cibles émettent
+// alors une puissance entière, exacte dans l'intervalle 32 bits ; les
+// puissances réelles dépendent de la bibliothèque mathématique de la
+// cible.
+//
+// Les nouveaux littéraux sont alloués dans arena, à la position du
+// sous-arbre remplacé. Rend le nombre de sous-arbres remplacés.
+int pliage_programme(ASTNode* prog, ASTArena* arena);
+
+#endif
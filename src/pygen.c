@@ -1,11 +1,13 @@
 #include "pygen.h"
 #include "token.h"
+#include "semantique.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 /* String builder */
 
@@ -50,21 +52,13 @@ static void str_free(Str* s) {
     s->len = s->cap = 0;
 }
 
-static char* dupstr(const char* s) {
-    if (!s) return NULL;
-    size_t n = strlen(s) + 1;
-    char* p = (char*)malloc(n);
-    if (p) memcpy(p, s, n);
-    return p;
-}
-
-/* Types + symboles (pour READ + init) */
+/* Types (déclarations et valeurs par défaut) */
 
 typedef enum { PT_UNKNOWN, PT_INT, PT_FLOAT, PT_BOOL, PT_CHAR, PT_STRING, PT_STRUCT, PT_ARRAY } PTypeKind;
 
 typedef struct PType {
     PTypeKind kind;
-    char* struct_name;
+    const char* struct_name;   /* interné */
     struct PType* elem;
     int dims;
 } PType;
@@ -75,119 +69,78 @@ static PType* pt_new(PTypeKind k) {
     return t;
 }
 
-static PType* pt_clone(const PType* src) {
-    if (!src) return pt_new(PT_UNKNOWN);
-    PType* t = pt_new(src->kind);
-    if (src->struct_name) t->struct_name = dupstr(src->struct_name);
-    if (src->elem) t->elem = pt_clone(src->elem);
-    t->dims = src->dims;
-    return t;
-}
-
 static void pt_free(PType* t) {
     if (!t) return;
-    free(t->struct_name);
     pt_free(t->elem);
     free(t);
 }
 
-typedef struct { char* name; PType* type; } Sym;
-typedef struct { Sym* items; int count; int cap; } SymTab;
-
-static void symtab_add(SymTab* st, const char* name, PType* type) {
-    if (!st || !name || !type) return;
-    if (st->count >= st->cap) {
-        st->cap = (st->cap == 0) ? 16 : st->cap * 2;
-        st->items = (Sym*)realloc(st->items, (size_t)st->cap * sizeof(Sym));
-    }
-    st->items[st->count].name = dupstr(name);
-    st->items[st->count].type = pt_clone(type);
-    st->count++;
-}
-
-static PType* symtab_lookup(SymTab* st, const char* name) {
-    if (!st || !name) return NULL;
-    for (int i = 0; i < st->count; i++) {
-        if (strcmp(st->items[i].name, name) == 0) return st->items[i].type;
-    }
-    return NULL;
-}
-
-static void symtab_free(SymTab* st) {
-    if (!st) return;
-    for (int i = 0; i < st->count; i++) {
-        free(st->items[i].name);
-        pt_free(st->items[i].type);
-    }
-    free(st->items);
-    st->items = NULL;
-    st->count = st->cap = 0;
-}
-
 /* Générateur Python */
 
 typedef struct {
     Str out;
     int indent;
 
-    /* structs: nom + fields */
-    struct { char* name; SymTab fields; }* structs;
-    int struct_count;
-
-    /* funcs: nom + ret */
-    struct { char* name; PType* ret; }* funcs;
-    int func_count;
-
-    /* scopes vars */
-    SymTab* scopes;
-    int scope_count;
-
     int tmp_id; /* noms temporaires uniques */
 
+    /* Masquage : en Python, un nom affecté dans une fonction y est local
+       partout, même avant l'affectation. Une déclaration locale qui masque
+       une globale est donc émise sous un autre nom (_l_<nom>) ; les
+       identificateurs la retrouvent par ident.decl. */
+    const char** globales;   /* noms internés des globales, triés */
+    int nb_globales;
+    ASTNode** masquants;     /* déclarations locales de la fonction courante */
+    int nb_masquants;
 } PG;
 
 static void emit_indent(PG* pg) { for (int i = 0; i < pg->indent; i++) str_append(&pg->out, "    "); }
 static void emit_ln(PG* pg, const char* s) { emit_indent(pg); str_append(&pg->out, s); str_append(&pg->out, "\n"); }
 
-static void push_scope(PG* pg) {
-    pg->scopes = (SymTab*)realloc(pg->scopes, (size_t)(pg->scope_count + 1) * sizeof(SymTab));
-    memset(&pg->scopes[pg->scope_count], 0, sizeof(SymTab));
-    pg->scope_count++;
+static void tmp_name(PG* pg, const char* prefix, char* buf, size_t n) {
+    snprintf(buf, n, "%s%d", prefix, pg->tmp_id++);
 }
 
-static void pop_scope(PG* pg) {
-    if (pg->scope_count <= 0) return;
-    pg->scope_count--;
-    symtab_free(&pg->scopes[pg->scope_count]);
+/* Masquage des globales */
+
+static const char* decl_name(ASTNode* d) {
+    if (!d) return NULL;
+    if (d->kind == AST_DECL_VAR) return d->as.decl_var.name;
+    if (d->kind == AST_DECL_CONST) return d->as.decl_const.name;
+    if (d->kind == AST_DECL_ARRAY) return d->as.decl_array.name;
+    return NULL;
 }
 
-static void tmp_name(PG* pg, const char* prefix, char* buf, size_t n) {
-    snprintf(buf, n, "%s%d", prefix, pg->tmp_id++);
+/* Noms internés : comparés par adresse */
+static int cmp_noms(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t)*(const char* const*)a;
+    uintptr_t y = (uintptr_t)*(const char* const*)b;
+    return (x > y) - (x < y);
 }
 
-static PType* lookup_var(PG* pg, const char* name) {
-    for (int i = pg->scope_count - 1; i >= 0; i--) {
-        PType* t = symtab_lookup(&pg->scopes[i], name);
-        if (t) return pt_clone(t);
-    }
-    return NULL;
+static bool est_globale(PG* pg, const char* name) {
+    return name && pg->nb_globales > 0 &&
+           bsearch(&name, pg->globales, (size_t)pg->nb_globales, sizeof(const char*), cmp_noms) != NULL;
 }
 
-static PType* lookup_func_ret(PG* pg, const char* name) {
-    for (int i = 0; i < pg->func_count; i++) {
-        if (strcmp(pg->funcs[i].name, name) == 0) return pt_clone(pg->funcs[i].ret);
+static bool est_masquant(PG* pg, ASTNode* d) {
+    for (int i = 0; i < pg->nb_masquants; i++) {
+        if (pg->masquants[i] == d) return true;
     }
-    return NULL;
+    return false;
 }
 
-static PType* lookup_struct_field(PG* pg, const char* struct_name, const char* field) {
-    for (int i = 0; i < pg->struct_count; i++) {
-        if (strcmp(pg->structs[i].name, struct_name) == 0) {
-            PType* t = symtab_lookup(&pg->structs[i].fields, field);
-            return t ? pt_clone(t) : NULL;
+/* Nom Python d'une déclaration (d) ou d'une variable de boucle (d NULL) */
+static void emit_name(PG* pg, ASTNode* d, const char* name) {
+    bool masque = false;
+    if (d) {
+        masque = est_masquant(pg, d);
+    } else {
+        for (int i = 0; i < pg->nb_masquants && !masque; i++) {
+            masque = (decl_name(pg->masquants[i]) == name);
         }
     }
-    return NULL;
+    if (masque) str_append(&pg->out, "_l_");
+    str_append(&pg->out, name);
 }
 
 /* AST -> PType */
@@ -208,7 +161,7 @@ static PType* ast_to_ptype(ASTNode* t) {
 
     if (t->kind == AST_TYPE_NAMED) {
         PType* p = pt_new(PT_STRUCT);
-        p->struct_name = dupstr(t->as.type_named.name);
+        p->struct_name = t->as.type_named.name;
         return p;
     }
 
@@ -222,74 +175,21 @@ static PType* ast_to_ptype(ASTNode* t) {
     return pt_new(PT_UNKNOWN);
 }
 
-/* Inférence expr (pour READ) */
-
-static PType* infer_expr(PG* pg, ASTNode* e) {
-    if (!e) return pt_new(PT_UNKNOWN);
-
-    switch (e->kind) {
-        case AST_LITERAL_INT: return pt_new(PT_INT);
-        case AST_LITERAL_REAL: return pt_new(PT_FLOAT);
-        case AST_LITERAL_BOOL: return pt_new(PT_BOOL);
-        case AST_LITERAL_STRING: return pt_new(PT_STRING);
-
-        case AST_IDENT: {
-            PType* t = lookup_var(pg, e->as.ident.name);
-            return t ? t : pt_new(PT_UNKNOWN);
-        }
-
-        case AST_UNARY:
-            if (e->as.unary.op == TOK_NON) return pt_new(PT_BOOL);
-            return infer_expr(pg, e->as.unary.expr);
-
-        case AST_BINARY: {
-            TokenType op = e->as.binary.op;
-            if ((op >= TOK_INFERIEUR && op <= TOK_DIFFERENT) || op == TOK_ET || op == TOK_OU) return pt_new(PT_BOOL);
-            PType* l = infer_expr(pg, e->as.binary.lhs);
-            PType* r = infer_expr(pg, e->as.binary.rhs);
-            bool want_float = (l->kind == PT_FLOAT || r->kind == PT_FLOAT || op == TOK_DIVISE);
-            pt_free(l); pt_free(r);
-            return want_float ? pt_new(PT_FLOAT) : pt_new(PT_INT);
-        }
-
-        case AST_CALL:
-            if (e->as.call.callee && e->as.call.callee->kind == AST_IDENT) {
-                PType* t = lookup_func_ret(pg, e->as.call.callee->as.ident.name);
-                return t ? t : pt_new(PT_UNKNOWN);
-            }
-            return pt_new(PT_UNKNOWN);
-
-        case AST_FIELD_ACCESS: {
-            PType* b = infer_expr(pg, e->as.field_access.base);
-            if (b && b->kind == PT_STRUCT && b->struct_name) {
-                PType* f = lookup_struct_field(pg, b->struct_name, e->as.field_access.field);
-                pt_free(b);
-                return f ? f : pt_new(PT_UNKNOWN);
-            }
-            pt_free(b);
-            return pt_new(PT_UNKNOWN);
-        }
-
-        case AST_INDEX: {
-            PType* b = infer_expr(pg, e->as.index.base);
-            if (b && b->kind == PT_ARRAY && b->elem) {
-                if (b->dims > 1) {
-                    PType* n = pt_clone(b);
-                    n->dims--;
-                    pt_free(b);
-                    return n;
-                } else {
-                    PType* el = pt_clone(b->elem);
-                    pt_free(b);
-                    return el;
-                }
-            }
-            pt_free(b);
-            return pt_new(PT_UNKNOWN);
-        }
+/* Types des expressions : annotations de l'analyse sémantique */
 
-        default:
-            return pt_new(PT_UNKNOWN);
+static PTypeKind kind_expr(ASTNode* e) {
+    if (!e || !e->type) return PT_UNKNOWN;
+    /* '/' donne toujours un float */
+    if (e->kind == AST_BINARY && e->as.binary.op == TOK_DIVISE) return PT_FLOAT;
+    switch (e->type->kind) {
+        case TY_INT: return PT_INT;
+        case TY_REAL: return PT_FLOAT;
+        case TY_BOOL: return PT_BOOL;
+        case TY_CHAR: return PT_CHAR;
+        case TY_STRING: return PT_STRING;
+        case TY_STRUCT: return PT_STRUCT;
+        case TY_ARRAY: return PT_ARRAY;
+        default: return PT_UNKNOWN;
     }
 }
 
@@ -341,7 +241,7 @@ static void emit_expr(PG* pg, ASTNode* e) {
         case AST_LITERAL_REAL: str_append(&pg->out, e->as.lit_real.text ? e->as.lit_real.text : "0.0"); break;
         case AST_LITERAL_BOOL: str_append(&pg->out, e->as.lit_bool.value ? "True" : "False"); break;
         case AST_LITERAL_STRING: emit_string_literal(pg, e->as.lit_string.text); break;
-        case AST_IDENT: str_append(&pg->out, e->as.ident.name); break;
+        case AST_IDENT: emit_name(pg, e->as.ident.decl, e->as.ident.name); break;
 
         case AST_UNARY:
             if (e->as.unary.op == TOK_NON) str_append(&pg->out, "not ");
@@ -465,10 +365,8 @@ static void emit_decl(PG* pg, ASTNode* d, bool is_global) {
         t = arr;
     }
 
-    symtab_add(&pg->scopes[pg->scope_count - 1], name, t);
-
     emit_indent(pg);
-    str_append(&pg->out, name);
+    emit_name(pg, d, name);
     str_append(&pg->out, " = ");
 
     if (d->kind == AST_DECL_CONST) {
@@ -513,28 +411,27 @@ static void emit_write(PG* pg, ASTNode* s) {
 }
 
 static void emit_read_one(PG* pg, ASTNode* target) {
-    PType* t = infer_expr(pg, target);
+    PTypeKind k = kind_expr(target);
 
     emit_indent(pg);
     emit_expr(pg, target);
     str_append(&pg->out, " = ");
 
-    if (t->kind == PT_INT) {
+    if (k == PT_INT) {
         str_append(&pg->out, "int(input())\n");
-    } else if (t->kind == PT_FLOAT) {
+    } else if (k == PT_FLOAT) {
         str_append(&pg->out, "float(input())\n");
-    } else if (t->kind == PT_BOOL) {
+    } else if (k == PT_BOOL) {
         char tmp[32]; tmp_name(pg, "_s", tmp, sizeof(tmp));
         str_printf(&pg->out,
             "(lambda %s: (%s == \"true\" or %s == \"1\"))((input().strip().lower()))\n",
             tmp, tmp, tmp);
-    } else if (t->kind == PT_CHAR) {
+    } else if (k == PT_CHAR) {
         str_append(&pg->out, "(input()[:1] or \"\\0\")\n");
     } else {
         str_append(&pg->out, "input()\n");
     }
 
-    pt_free(t);
 }
 
 static void emit_switch(PG* pg, ASTNode* s) {
@@ -661,7 +558,7 @@ static void emit_stmt(PG* pg, ASTNode* s) {
         case AST_FOR: {
             emit_indent(pg);
             str_append(&pg->out, "for ");
-            str_append(&pg->out, s->as.for_stmt.var);
+            emit_name(pg, NULL, s->as.for_stmt.var);
             str_append(&pg->out, " in range(");
 
             emit_expr(pg, s->as.for_stmt.start);
@@ -733,8 +630,6 @@ static void emit_block(PG* pg, ASTNode* b) {
         return;
     }
 
-    push_scope(pg);
-
     for (int i = 0; i < b->as.block.stmts.count; i++) {
         ASTNode* st = b->as.block.stmts.items[i];
         if (!st) continue;
@@ -748,33 +643,6 @@ static void emit_block(PG* pg, ASTNode* b) {
         if (st->kind == AST_DECL_VAR || st->kind == AST_DECL_CONST || st->kind == AST_DECL_ARRAY) continue;
         emit_stmt(pg, st);
     }
-
-    pop_scope(pg);
-}
-
-/* Pré-déclaration fonctions + structs */
-
-static void predeclare(PG* pg, ASTNode* program) {
-    pg->funcs = (void*)calloc((size_t)program->as.program.defs.count, sizeof(*pg->funcs));
-    pg->structs = (void*)calloc((size_t)program->as.program.defs.count, sizeof(*pg->structs));
-
-    for (int i = 0; i < program->as.program.defs.count; i++) {
-        ASTNode* d = program->as.program.defs.items[i];
-        if (!d) continue;
-
-        if (d->kind == AST_DEF_FUNC) {
-            int k = pg->func_count++;
-            pg->funcs[k].name = dupstr(d->as.def_func.name);
-            pg->funcs[k].ret = ast_to_ptype(d->as.def_func.return_type);
-        } else if (d->kind == AST_DEF_PROC) {
-            int k = pg->func_count++;
-            pg->funcs[k].name = dupstr(d->as.def_proc.name);
-            pg->funcs[k].ret = pt_new(PT_UNKNOWN);
-        } else if (d->kind == AST_DEF_STRUCT) {
-            int sidx = pg->struct_count++;
-            pg->structs[sidx].name = dupstr(d->as.def_struct.name);
-        }
-    }
 }
 
 static void emit_structs(PG* pg, ASTNode* program) {
@@ -792,11 +660,6 @@ static void emit_structs(PG* pg, ASTNode* program) {
         ASTNode* d = program->as.program.defs.items[i];
         if (!d || d->kind != AST_DEF_STRUCT) continue;
 
-        int idx = -1;
-        for (int k = 0; k < pg->struct_count; k++) {
-            if (strcmp(pg->structs[k].name, d->as.def_struct.name) == 0) { idx = k; break; }
-        }
-
         str_printf(&pg->out, "class %s:\n", d->as.def_struct.name);
         pg->indent++;
 
@@ -811,7 +674,6 @@ static void emit_structs(PG* pg, ASTNode* program) {
                 if (!f || f->kind != AST_FIELD) continue;
 
                 PType* ft = ast_to_ptype(f->as.field.type);
-                if (idx >= 0) symtab_add(&pg->structs[idx].fields, f->as.field.name, ft);
 
                 emit_indent(pg);
                 str_printf(&pg->out, "self.%s = ", f->as.field.name);
@@ -837,6 +699,17 @@ static void emit_funcproc(PG* pg, ASTNode* def) {
 
     pg->tmp_id = 0;
 
+    /* Déclarations locales (Objets) qui masquent une globale */
+    pg->nb_masquants = 0;
+    if (body && body->kind == AST_BLOCK) {
+        for (int i = 0; i < body->as.block.stmts.count; i++) {
+            ASTNode* st = body->as.block.stmts.items[i];
+            if (!est_globale(pg, decl_name(st))) continue;
+            pg->masquants = (ASTNode**)realloc(pg->masquants, (size_t)(pg->nb_masquants + 1) * sizeof(ASTNode*));
+            pg->masquants[pg->nb_masquants++] = st;
+        }
+    }
+
     emit_indent(pg);
     str_append(&pg->out, "def ");
     str_append(&pg->out, name);
@@ -849,19 +722,9 @@ static void emit_funcproc(PG* pg, ASTNode* def) {
     str_append(&pg->out, "):\n");
 
     pg->indent++;
-    push_scope(pg);
-
-    for (int i = 0; i < params->count; i++) {
-        ASTNode* p = params->items[i];
-        PType* pt = ast_to_ptype(p->as.param.type);
-        symtab_add(&pg->scopes[pg->scope_count - 1], p->as.param.name, pt);
-        pt_free(pt);
-    }
-
     emit_block(pg, body);
-
-    pop_scope(pg);
     pg->indent--;
+    pg->nb_masquants = 0;
 
     emit_ln(pg, "");
 }
@@ -877,9 +740,6 @@ bool pygen_generate(ASTNode* program, const char* output_path) {
     pg.indent = 0;
     pg.tmp_id = 0;
 
-    push_scope(&pg);
-    predeclare(&pg, program);
-
     emit_ln(&pg, "# Generated Python code");
     emit_ln(&pg, "import math");
     emit_ln(&pg, "");
@@ -887,11 +747,14 @@ bool pygen_generate(ASTNode* program, const char* output_path) {
     emit_structs(&pg, program);
 
     emit_ln(&pg, "# Globales");
+    pg.globales = (const char**)malloc((size_t)program->as.program.decls.count * sizeof(const char*) + 1);
     for (int i = 0; i < program->as.program.decls.count; i++) {
         ASTNode* d = program->as.program.decls.items[i];
         if (!d) continue;
+        if (pg.globales && decl_name(d)) pg.globales[pg.nb_globales++] = decl_name(d);
         emit_decl(&pg, d, true);
     }
+    if (pg.globales) qsort(pg.globales, (size_t)pg.nb_globales, sizeof(const char*), cmp_noms);
     emit_ln(&pg, "");
 
     for (int i = 0; i < program->as.program.defs.count; i++) {
@@ -911,6 +774,9 @@ bool pygen_generate(ASTNode* program, const char* output_path) {
     emit_ln(&pg, "main()");
     pg.indent--;
 
+    free(pg.globales);
+    free(pg.masquants);
+
     FILE* f = fopen(output_path, "w");
     if (!f) {
         str_free(&pg.out);
@@ -922,19 +788,5 @@ bool pygen_generate(ASTNode* program, const char* output_path) {
 
     str_free(&pg.out);
 
-    for (int i = 0; i < pg.struct_count; i++) {
-        free(pg.structs[i].name);
-        symtab_free(&pg.structs[i].fields);
-    }
-    for (int i = 0; i < pg.func_count; i++) {
-        free(pg.funcs[i].name);
-        pt_free(pg.funcs[i].ret);
-    }
-    free(pg.structs);
-    free(pg.funcs);
-
-    while (pg.scope_count > 0) pop_scope(&pg);
-    free(pg.scopes);
-
     return true;
 }
@@ -1,8 +1,14 @@
+// sysconf : POSIX
+#define _POSIX_C_SOURCE 200809L
+
 #include "semantique.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
 
 
 static char* sdup(const char* s) {
@@ -53,30 +59,120 @@ void sem_print_errors(SemContext* ctx) {
 
 // Construction / comparaison des types
 
-static Type* type_new(TypeKind k) {
-    Type* t = (Type*)calloc(1, sizeof(Type));
-    if (!t) return NULL;
-    t->kind = k;
-    return t;
+// Types canoniques : un seul objet Type par type. Les primitifs sont des
+// singletons statiques ; tableaux (élément canonique, dimensions) et
+// structures (nom interné) passent par une table ouverte partagée par
+// tout le processus (verrou, comme intern.c). Deux types sont égaux si et
+// seulement si leurs pointeurs le sont, et aucun Type n'est alloué par
+// expression analysée.
+
+static Type types_prim[] = {
+    [TY_ERROR]  = { .kind = TY_ERROR },
+    [TY_VOID]   = { .kind = TY_VOID },
+    [TY_INT]    = { .kind = TY_INT },
+    [TY_REAL]   = { .kind = TY_REAL },
+    [TY_BOOL]   = { .kind = TY_BOOL },
+    [TY_CHAR]   = { .kind = TY_CHAR },
+    [TY_STRING] = { .kind = TY_STRING },
+};
+
+static pthread_mutex_t types_verrou = PTHREAD_MUTEX_INITIALIZER;
+static Type** types;        // NULL : case libre
+static uint32_t types_cap;  // puissance de 2
+static uint32_t types_nb;
+
+static uint32_t type_hacher(TypeKind k, const void* p, int dims) {
+    uint64_t v = ((uint64_t)(uintptr_t)p ^ ((uint64_t)(uint32_t)dims << 3) ^ (uint64_t)k)
+                 * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(v >> 32);
 }
 
-static Type* type_make_prim(TypeKind k) { return type_new(k); }
-static Type* type_make_void(void) { return type_make_prim(TY_VOID); }
-static Type* type_make_error(void){ return type_make_prim(TY_ERROR); }
+static bool types_agrandir(void) {
+    uint32_t ncap = (types_cap == 0) ? 256 : types_cap * 2;
+    Type** n = (Type**)calloc(ncap, sizeof(Type*));
+    if (!n) return false;
+
+    for (uint32_t i = 0; i < types_cap; i++) {
+        Type* t = types[i];
+        if (!t) continue;
+        uint32_t h = (t->kind == TY_ARRAY)
+            ? type_hacher(TY_ARRAY, t->as.array.elem, t->as.array.dims)
+            : type_hacher(TY_STRUCT, t->as.st.name, 0);
+        uint32_t j = h & (ncap - 1);
+        while (n[j]) j = (j + 1) & (ncap - 1);
+        n[j] = t;
+    }
+    free(types);
+    types = n;
+    types_cap = ncap;
+    return true;
+}
 
-static Type* type_make_array(Type* elem, int dims) {
-    Type* t = type_new(TY_ARRAY);
-    if (!t) return NULL;
-    t->as.array.elem = elem;
-    t->as.array.dims = dims;
-    return t;
+// Tableau (p = élément, dims) ou structure (p = nom) canonique
+static Type* type_canonique(TypeKind k, const void* p, int dims) {
+    uint32_t h = type_hacher(k, p, dims);
+
+    pthread_mutex_lock(&types_verrou);
+
+    Type* r = NULL;
+    if ((types_nb + 1) * 2 > types_cap && !types_agrandir()) goto fin;
+
+    uint32_t i = h & (types_cap - 1);
+    while (types[i]) {
+        Type* t = types[i];
+        if (t->kind == k && (k == TY_ARRAY
+                ? (t->as.array.elem == p && t->as.array.dims == dims)
+                : t->as.st.name == p)) {
+            r = t;
+            goto fin;
+        }
+        i = (i + 1) & (types_cap - 1);
+    }
+
+    r = (Type*)calloc(1, sizeof(Type));
+    if (r) {
+        r->kind = k;
+        if (k == TY_ARRAY) {
+            r->as.array.elem = (Type*)p;
+            r->as.array.dims = dims;
+        } else {
+            r->as.st.name = (const char*)p;
+        }
+        types[i] = r;
+        types_nb++;
+    }
+
+fin:
+    pthread_mutex_unlock(&types_verrou);
+    return r;
 }
 
-static Type* type_make_struct(const char* name) {
-    Type* t = type_new(TY_STRUCT);
-    if (!t) return NULL;
-    t->as.st.name = sdup(name);
-    return t;
+Type* sem_type_primitif(TypeKind k) {
+    return (k <= TY_STRING) ? &types_prim[k] : &types_prim[TY_ERROR];
+}
+
+Type* sem_type_tableau(Type* elem, int dims) {
+    return type_canonique(TY_ARRAY, elem, dims);
+}
+
+Type* sem_type_structure(const char* nom) {
+    return type_canonique(TY_STRUCT, nom, 0);
+}
+
+static Type* type_make_prim(TypeKind k) { return &types_prim[k]; }
+static Type* type_make_void(void) { return type_make_prim(TY_VOID); }
+static Type* type_make_error(void){ return type_make_prim(TY_ERROR); }
+static Type* type_make_array(Type* elem, int dims) { return sem_type_tableau(elem, dims); }
+static Type* type_make_struct(const char* name) { return sem_type_structure(name); }
+
+void sem_types_liberer(void) {
+    pthread_mutex_lock(&types_verrou);
+    for (uint32_t i = 0; i < types_cap; i++) free(types[i]);
+    free(types);
+    types = NULL;
+    types_cap = 0;
+    types_nb = 0;
+    pthread_mutex_unlock(&types_verrou);
 }
 
 static bool type_is_numeric(Type* t) {
@@ -89,18 +185,9 @@ static bool type_is_integral(Type* t) {
     return t->kind == TY_INT || t->kind == TY_CHAR || t->kind == TY_BOOL;
 }
 
+// Types canoniques : égalité des pointeurs
 static bool type_equal(Type* a, Type* b) {
-    if (!a || !b) return false;
-    if (a->kind != b->kind) return false;
-
-    if (a->kind == TY_ARRAY) {
-        return a->as.array.dims == b->as.array.dims && type_equal(a->as.array.elem, b->as.array.elem);
-    }
-    if (a->kind == TY_STRUCT) {
-        if (!a->as.st.name || !b->as.st.name) return false;
-        return strcmp(a->as.st.name, b->as.st.name) == 0;
-    }
-    return true;
+    return a && a == b;
 }
 
 static bool type_assignable(Type* dst, Type* src) {
@@ -140,13 +227,9 @@ static Scope* scope_push(SemContext* ctx) {
 
 static void symbol_free(Symbol* sym) {
     if (!sym) return;
-    free(sym->name);
 
     if (sym->param_types) free(sym->param_types);
-    if (sym->param_names) {
-        for (int i = 0; i < sym->param_count; i++) free(sym->param_names[i]);
-        free(sym->param_names);
-    }
+    if (sym->param_names) free(sym->param_names);
 }
 
 static void scope_pop(SemContext* ctx) {
@@ -156,13 +239,50 @@ static void scope_pop(SemContext* ctx) {
 
     for (int i = 0; i < s->count; i++) symbol_free(&s->symbols[i]);
     free(s->symbols);
+    free(s->index);
     free(s);
 }
 
+// Noms internés (intern.h) : égaux si et seulement si les pointeurs le
+// sont, et hachés par leur adresse (hachage de Fibonacci)
+static uint32_t hacher_nom(const char* name) {
+    uint64_t v = (uint64_t)(uintptr_t)name * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(v >> 32);
+}
+
+static void index_inserer(int* index, int cap, const char* name, int pos) {
+    uint32_t i = hacher_nom(name) & (uint32_t)(cap - 1);
+    while (index[i]) i = (i + 1) & (uint32_t)(cap - 1);
+    index[i] = pos + 1;
+}
+
+// (Re)construit l'index pour au moins n symboles (remplissage <= 50 %)
+static bool scope_indexer(Scope* s, int n) {
+    int ncap = (s->index_cap == 0) ? 32 : s->index_cap;
+    while (ncap < n * 2) ncap *= 2;
+    if (ncap == s->index_cap) return true;
+
+    int* index = (int*)calloc((size_t)ncap, sizeof(int));
+    if (!index) return false;
+    for (int i = 0; i < s->count; i++) index_inserer(index, ncap, s->symbols[i].name, i);
+    free(s->index);
+    s->index = index;
+    s->index_cap = ncap;
+    return true;
+}
+
 static Symbol* scope_lookup_here(Scope* s, const char* name) {
     if (!s || !name) return NULL;
+    if (s->index) {
+        uint32_t masque = (uint32_t)(s->index_cap - 1);
+        for (uint32_t i = hacher_nom(name) & masque; s->index[i]; i = (i + 1) & masque) {
+            Symbol* sym = &s->symbols[s->index[i] - 1];
+            if (sym->name == name) return sym;
+        }
+        return NULL;
+    }
     for (int i = 0; i < s->count; i++) {
-        if (strcmp(s->symbols[i].name, name) == 0) return &s->symbols[i];
+        if (s->symbols[i].name == name) return &s->symbols[i];
     }
     return NULL;
 }
@@ -175,7 +295,7 @@ static Symbol* scope_lookup(Scope* s, const char* name) {
     return NULL;
 }
 
-static Symbol* scope_add(Scope* s, const char* name) {
+static Symbol* scope_add(Scope* s, const char* name, ASTNode* decl) {
     if (!s || !name) return NULL;
     if (s->count >= s->cap) {
         int ncap = (s->cap == 0) ? 16 : s->cap * 2;
@@ -184,9 +304,14 @@ static Symbol* scope_add(Scope* s, const char* name) {
         s->symbols = n;
         s->cap = ncap;
     }
+    if (s->index || s->count + 1 > SCOPE_SEUIL_INDEX) {
+        if (!scope_indexer(s, s->count + 1)) return NULL;
+        index_inserer(s->index, s->index_cap, name, s->count);
+    }
     Symbol* sym = &s->symbols[s->count++];
     memset(sym, 0, sizeof(*sym));
-    sym->name = sdup(name);
+    sym->name = name;
+    sym->decl = decl;
     return sym;
 }
 
@@ -298,6 +423,7 @@ static Type* sem_ident(SemContext* ctx, ASTNode* expr) {
         sem_error(ctx, expr, "Identifiant non déclaré: '%s'", expr->as.ident.name);
         return type_make_error();
     }
+    expr->as.ident.decl = sym->decl;
 
     switch (sym->kind) {
         case SYM_VAR:
@@ -431,7 +557,7 @@ static Type* sem_field_access(SemContext* ctx, ASTNode* expr) {
     const char* fname = expr->as.field_access.field;
 
     for (int i = 0; i < st->param_count; i++) {
-        if (st->param_names && strcmp(st->param_names[i], fname) == 0) {
+        if (st->param_names && st->param_names[i] == fname) {
             return st->param_types[i];
         }
     }
@@ -457,6 +583,7 @@ static Type* sem_call(SemContext* ctx, ASTNode* expr) {
         sem_error(ctx, expr, "'%s' n'est pas une fonction/procédure.", sym->name);
         return type_make_error();
     }
+    callee->as.ident.decl = sym->decl;
 
     int ac = expr->as.call.args.count;
     int pc = sym->param_count;
@@ -478,28 +605,33 @@ static Type* sem_call(SemContext* ctx, ASTNode* expr) {
     return sym->return_type ? sym->return_type : type_make_error();
 }
 
+// Le type calculé est aussi posé sur le nœud (annotation des générateurs)
 static Type* sem_expr(SemContext* ctx, ASTNode* expr) {
     if (!expr) return type_make_error();
 
+    Type* t;
     switch (expr->kind) {
-        case AST_IDENT:          return sem_ident(ctx, expr);
+        case AST_IDENT:          t = sem_ident(ctx, expr); break;
 
         case AST_LITERAL_INT:
         case AST_LITERAL_REAL:
         case AST_LITERAL_STRING:
-        case AST_LITERAL_BOOL:   return sem_literal(ctx, expr);
+        case AST_LITERAL_BOOL:   t = sem_literal(ctx, expr); break;
 
-        case AST_UNARY:          return sem_unary(ctx, expr);
-        case AST_BINARY:         return sem_binary(ctx, expr);
+        case AST_UNARY:          t = sem_unary(ctx, expr); break;
+        case AST_BINARY:         t = sem_binary(ctx, expr); break;
 
-        case AST_INDEX:          return sem_index(ctx, expr);
-        case AST_FIELD_ACCESS:   return sem_field_access(ctx, expr);
-        case AST_CALL:           return sem_call(ctx, expr);
+        case AST_INDEX:          t = sem_index(ctx, expr); break;
+        case AST_FIELD_ACCESS:   t = sem_field_access(ctx, expr); break;
+        case AST_CALL:           t = sem_call(ctx, expr); break;
 
         default:
             sem_error(ctx, expr, "Expression non gérée (kind=%d).", (int)expr->kind);
-            return type_make_error();
+            t = type_make_error();
+            break;
     }
+    expr->type = t;
+    return t;
 }
 
 // Instructions + Blocs
@@ -787,14 +919,14 @@ static void sem_declare_struct(SemContext* ctx, ASTNode* def) {
         return;
     }
 
-    Symbol* sym = scope_add(ctx->scope, name);
+    Symbol* sym = scope_add(ctx->scope, name, def);
     sym->kind = SYM_STRUCT;
     sym->type = type_make_struct(name);
 
     // On réutilise (param_names/param_types/param_count) pour stocker les champs
     int fc = def->as.def_struct.fields.count;
     sym->param_count = fc;
-    sym->param_names = (char**)calloc((size_t)fc, sizeof(char*));
+    sym->param_names = (const char**)calloc((size_t)fc, sizeof(char*));
     sym->param_types = (Type**)calloc((size_t)fc, sizeof(Type*));
 
     for (int i = 0; i < fc; i++) {
@@ -804,12 +936,12 @@ static void sem_declare_struct(SemContext* ctx, ASTNode* def) {
         const char* fname = f->as.field.name;
         // Champ dupliqué
         for (int j = 0; j < i; j++) {
-            if (sym->param_names[j] && strcmp(sym->param_names[j], fname) == 0) {
+            if (sym->param_names[j] && sym->param_names[j] == fname) {
                 sem_error(ctx, f, "Champ dupliqué '%s' dans structure '%s'.", fname, name);
             }
         }
 
-        sym->param_names[i] = sdup(fname);
+        sym->param_names[i] = fname;
         sym->param_types[i] = sem_type_from_ast(ctx, f->as.field.type);
     }
 }
@@ -821,7 +953,7 @@ static void sem_declare_var(SemContext* ctx, ASTNode* decl) {
         return;
     }
 
-    Symbol* sym = scope_add(ctx->scope, name);
+    Symbol* sym = scope_add(ctx->scope, name, decl);
     sym->kind = SYM_VAR;
     sym->type = sem_type_from_ast(ctx, decl->as.decl_var.type);
 
@@ -839,7 +971,7 @@ static void sem_declare_const(SemContext* ctx, ASTNode* decl) {
         return;
     }
 
-    Symbol* sym = scope_add(ctx->scope, name);
+    Symbol* sym = scope_add(ctx->scope, name, decl);
     sym->kind = SYM_CONST;
     sym->type = sem_type_from_ast(ctx, decl->as.decl_const.type);
 
@@ -870,17 +1002,19 @@ static void sem_declare_array(SemContext* ctx, ASTNode* decl) {
 
     Type* elem = sem_type_from_ast(ctx, decl->as.decl_array.elem_type);
 
-    // Vérifier que les dimensions sont des constantes entières
+    // Vérifier que les dimensions sont des constantes entières (et les
+    // annoter comme toute expression)
     for (int i = 0; i < dims; i++) {
         long long v;
         if (!sem_const_int_value(ctx, decl->as.decl_array.dims.items[i], &v)) {
             sem_error(ctx, decl->as.decl_array.dims.items[i], "Dimension de tableau doit être une constante entière.");
         } else {
+            (void)sem_expr(ctx, decl->as.decl_array.dims.items[i]);
             if (v <= 0) sem_error(ctx, decl->as.decl_array.dims.items[i], "Dimension de tableau doit être > 0.");
         }
     }
 
-    Symbol* sym = scope_add(ctx->scope, name);
+    Symbol* sym = scope_add(ctx->scope, name, decl);
     sym->kind = SYM_ARRAY;
     sym->type = type_make_array(elem, dims);
 
@@ -899,7 +1033,7 @@ static void sem_predeclare_funcproc(SemContext* ctx, ASTNode* def, bool is_proc)
         return;
     }
 
-    Symbol* sym = scope_add(ctx->scope, name);
+    Symbol* sym = scope_add(ctx->scope, name, def);
     sym->kind = is_proc ? SYM_PROC : SYM_FUNC;
 
     // Paramètres
@@ -908,17 +1042,17 @@ static void sem_predeclare_funcproc(SemContext* ctx, ASTNode* def, bool is_proc)
 
     sym->param_count = pc;
     sym->param_types = (Type**)calloc((size_t)pc, sizeof(Type*));
-    sym->param_names = (char**)calloc((size_t)pc, sizeof(char*));
+    sym->param_names = (const char**)calloc((size_t)pc, sizeof(char*));
 
     for (int i = 0; i < pc; i++) {
         ASTNode* p = params->items[i];
         if (!p || p->kind != AST_PARAM) continue;
-        sym->param_names[i] = sdup(p->as.param.name);
+        sym->param_names[i] = p->as.param.name;
         sym->param_types[i] = sem_type_from_ast(ctx, p->as.param.type);
 
         // Paramètre dupliqué
         for (int j = 0; j < i; j++) {
-            if (sym->param_names[j] && strcmp(sym->param_names[j], sym->param_names[i]) == 0) {
+            if (sym->param_names[j] && sym->param_names[j] == sym->param_names[i]) {
                 sem_error(ctx, p, "Paramètre dupliqué '%s' dans '%s'.", sym->param_names[i], name);
             }
         }
@@ -949,7 +1083,7 @@ static void sem_check_funcproc_body(SemContext* ctx, ASTNode* def, bool is_proc)
             sem_error(ctx, p, "Paramètre '%s' dupliqué (scope).", p->as.param.name);
             continue;
         }
-        Symbol* s = scope_add(ctx->scope, p->as.param.name);
+        Symbol* s = scope_add(ctx->scope, p->as.param.name, p);
         s->kind = SYM_PARAM;
         s->type = sem_type_from_ast(ctx, p->as.param.type);
     }
@@ -975,6 +1109,132 @@ static void sem_check_funcproc_body(SemContext* ctx, ASTNode* def, bool is_proc)
     scope_pop(ctx);
 }
 
+// CORPS EN PARALLÈLE
+//
+// Après les étapes 1 à 3 de sem_analyze_program, la portée globale
+// (structures, globales, signatures) est figée : vérifier un corps ne
+// fait qu'y lire, et les types canoniques comme les noms internés ont
+// leur propre verrou. Chaque thread prend le corps suivant dans une file
+// commune (répartition à la demande : un long corps n'en retarde pas
+// d'autres) et le vérifie avec son propre SemContext, dont les portées
+// locales ont la portée globale pour parent. Les erreurs de chaque corps
+// sont rangées à part puis reprises dans l'ordre des définitions : les
+// messages sont ceux de la vérification séquentielle.
+
+typedef struct {
+    char** errors;
+    int err_count;
+} ErreursCorps;
+
+typedef struct {
+    Scope* globale;
+    ASTNode** corps;        // définitions de fonction / procédure
+    ErreursCorps* erreurs;  // par corps
+    int nb;
+    int suivant;            // prochain corps à vérifier (sous verrou)
+    pthread_mutex_t verrou;
+} FileCorps;
+
+static int nb_threads_corps(int nb_corps) {
+    if (nb_corps < SEM_SEUIL_PARALLELE) return 1;
+
+    long n;
+    const char* force = getenv("ALGO_THREADS");
+    if (force && *force) n = strtol(force, NULL, 10);
+    else n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    long max = nb_corps / SEM_CORPS_MIN_THREAD;
+    if (n > max) n = max;
+    if (n > 64) n = 64;
+    return (n < 1) ? 1 : (int)n;
+}
+
+static void* verifier_corps(void* arg) {
+    FileCorps* f = (FileCorps*)arg;
+
+    SemContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.scope = f->globale;
+
+    for (;;) {
+        pthread_mutex_lock(&f->verrou);
+        int i = f->suivant++;
+        pthread_mutex_unlock(&f->verrou);
+        if (i >= f->nb) break;
+
+        ASTNode* d = f->corps[i];
+        sem_check_funcproc_body(&ctx, d, d->kind == AST_DEF_PROC);
+
+        f->erreurs[i].errors = ctx.errors;
+        f->erreurs[i].err_count = ctx.err_count;
+        ctx.errors = NULL;
+        ctx.err_count = ctx.err_cap = 0;
+    }
+    return NULL;
+}
+
+// Étape 4 en parallèle ; false si elle reste à faire séquentiellement
+static bool sem_check_bodies_en_parallele(SemContext* ctx, ASTNode* program) {
+    ASTList* defs = &program->as.program.defs;
+
+    int nb_corps = 0;
+    for (int i = 0; i < defs->count; i++) {
+        ASTNode* d = defs->items[i];
+        if (d && (d->kind == AST_DEF_FUNC || d->kind == AST_DEF_PROC)) nb_corps++;
+    }
+    int nb = nb_threads_corps(nb_corps);
+    if (nb < 2) return false;
+
+    FileCorps f;
+    memset(&f, 0, sizeof(f));
+    f.globale = ctx->scope;
+    f.corps = (ASTNode**)malloc((size_t)nb_corps * sizeof(ASTNode*));
+    f.erreurs = (ErreursCorps*)calloc((size_t)nb_corps, sizeof(ErreursCorps));
+    pthread_t* threads = (pthread_t*)malloc((size_t)nb * sizeof(pthread_t));
+    bool* lances = (bool*)calloc((size_t)nb, sizeof(bool));
+    if (!f.corps || !f.erreurs || !threads || !lances) {
+        free(f.corps); free(f.erreurs); free(threads); free(lances);
+        return false;
+    }
+    for (int i = 0; i < defs->count; i++) {
+        ASTNode* d = defs->items[i];
+        if (d && (d->kind == AST_DEF_FUNC || d->kind == AST_DEF_PROC)) f.corps[f.nb++] = d;
+    }
+    pthread_mutex_init(&f.verrou, NULL);
+
+    // Le thread appelant participe
+    for (int t = 1; t < nb; t++) {
+        lances[t] = pthread_create(&threads[t], NULL, verifier_corps, &f) == 0;
+    }
+    verifier_corps(&f);
+    for (int t = 1; t < nb; t++) {
+        if (lances[t]) pthread_join(threads[t], NULL);
+    }
+    pthread_mutex_destroy(&f.verrou);
+
+    // Reprise des erreurs dans l'ordre des définitions
+    for (int i = 0; i < f.nb; i++) {
+        ErreursCorps* e = &f.erreurs[i];
+        for (int k = 0; k < e->err_count; k++) {
+            if (ctx->err_count >= ctx->err_cap) {
+                int ncap = (ctx->err_cap == 0) ? 16 : ctx->err_cap * 2;
+                char** n = (char**)realloc(ctx->errors, (size_t)ncap * sizeof(char*));
+                if (!n) { free(e->errors[k]); continue; }
+                ctx->errors = n;
+                ctx->err_cap = ncap;
+            }
+            ctx->errors[ctx->err_count++] = e->errors[k];
+        }
+        free(e->errors);
+    }
+
+    free(lances);
+    free(threads);
+    free(f.erreurs);
+    free(f.corps);
+    return true;
+}
+
 // API publique
 
 void sem_init(SemContext* ctx) {
@@ -1025,12 +1285,15 @@ bool sem_analyze_program(SemContext* ctx, ASTNode* program) {
         else if (d->kind == AST_DEF_PROC) sem_predeclare_funcproc(ctx, d, true);
     }
 
-    // 4) Vérifier les corps des fonctions/procédures
-    for (int i = 0; i < program->as.program.defs.count; i++) {
-        ASTNode* d = program->as.program.defs.items[i];
-        if (!d) continue;
-        if (d->kind == AST_DEF_FUNC) sem_check_funcproc_body(ctx, d, false);
-        else if (d->kind == AST_DEF_PROC) sem_check_funcproc_body(ctx, d, true);
+    // 4) Vérifier les corps des fonctions/procédures (en parallèle pour
+    //    un grand nombre de corps, voir plus haut)
+    if (!sem_check_bodies_en_parallele(ctx, program)) {
+        for (int i = 0; i < program->as.program.defs.count; i++) {
+            ASTNode* d = program->as.program.defs.items[i];
+            if (!d) continue;
+            if (d->kind == AST_DEF_FUNC) sem_check_funcproc_body(ctx, d, false);
+            else if (d->kind == AST_DEF_PROC) sem_check_funcproc_body(ctx, d, true);
+        }
     }
 
     // 5) Bloc principal
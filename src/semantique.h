@@ -25,7 +25,7 @@ typedef struct {
 } ArrayInfo;
 
 typedef struct {
-    char* name; // struct name
+    const char* name; // struct name (interné)
 } StructInfo;
 
 struct Type {
@@ -48,9 +48,10 @@ typedef enum {
 } SymbolKind;
 
 typedef struct Symbol {
-    char* name;
+    const char* name;   // interné (intern.h) : comparé par pointeur
     SymbolKind kind;
     Type* type;
+    ASTNode* decl;      // déclaration (reportée dans ident.decl)
 
     // for const int evaluation (useful for dims/case labels)
     bool has_int_value;
@@ -59,17 +60,31 @@ typedef struct Symbol {
     // functions/procs
     int param_count;
     Type** param_types;
-    char** param_names;   // optional
+    const char** param_names;   // optional, internés
     Type* return_type;    // func only (proc => TY_VOID)
 } Symbol;
 
+// Au-delà de SCOPE_SEUIL_INDEX symboles, un scope est indexé par une
+// table de hachage (adresse du nom interné -> position dans symbols) ;
+// en dessous, une recherche linéaire suffit et rien n'est alloué.
+#define SCOPE_SEUIL_INDEX 8
+
 typedef struct Scope {
     struct Scope* parent;
     Symbol* symbols;
     int count;
     int cap;
+
+    int* index;        // position + 1, 0 : case libre (NULL : pas d'index)
+    int index_cap;     // puissance de 2
 } Scope;
 
+// Corps des fonctions/procédures vérifiés en parallèle (voir
+// semantique.c) : au moins ce nombre de corps, et ce nombre de corps par
+// thread
+#define SEM_SEUIL_PARALLELE 64
+#define SEM_CORPS_MIN_THREAD 16
+
 // =====================
 // Semantic context
 // =====================
@@ -99,4 +114,14 @@ bool sem_analyze_program(SemContext* ctx, ASTNode* program);
 
 void sem_print_errors(SemContext* ctx);
 
+// Types canoniques (un seul objet par type : comparer les pointeurs),
+// valides jusqu'à sem_types_liberer()
+Type* sem_type_primitif(TypeKind k);   // TY_ERROR .. TY_STRING
+Type* sem_type_tableau(Type* elem, int dims);
+Type* sem_type_structure(const char* nom);
+
+// Libère les types canoniques (tableaux, structures) : après la dernière
+// analyse, les Type* rendus ne sont plus valides
+void sem_types_liberer(void);
+
 #endif
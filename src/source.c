@@ -0,0 +1,94 @@
+// mmap / fstat / read : POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "source.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SOURCE_TAILLE_BLOC (64 * 1024)
+
+// Lecture par blocs jusqu'à EOF (stdin, tube, FIFO, fichier spécial)
+static bool lire_par_blocs(SourceEntree* src, int fd) {
+    size_t cap = SOURCE_TAILLE_BLOC;
+    size_t n = 0;
+    char* buf = (char*)malloc(cap);
+    if (!buf) return false;
+
+    while (true) {
+        if (cap - n < SOURCE_TAILLE_BLOC) {
+            size_t ncap = cap * 2;
+            char* nbuf = (char*)realloc(buf, ncap);
+            if (!nbuf) { free(buf); return false; }
+            buf = nbuf;
+            cap = ncap;
+        }
+
+        ssize_t lu = read(fd, buf + n, SOURCE_TAILLE_BLOC);
+        if (lu == 0) break;
+        if (lu < 0) { free(buf); return false; }
+        n += (size_t)lu;
+    }
+
+    src->donnees = buf;
+    src->longueur = n;
+    src->projete = false;
+    return true;
+}
+
+bool source_ouvrir(SourceEntree* src, const char* chemin) {
+    src->donnees = NULL;
+    src->longueur = 0;
+    src->projete = false;
+
+    if (strcmp(chemin, "-") == 0) {
+        return lire_par_blocs(src, STDIN_FILENO);
+    }
+
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return false; }
+
+    bool ok;
+    if (!S_ISREG(st.st_mode)) {
+        ok = lire_par_blocs(src, fd);
+    } else if (st.st_size == 0) {
+        // mmap refuse une longueur nulle
+        src->donnees = "";
+        src->longueur = 0;
+        src->projete = true;
+        ok = true;
+    } else {
+        void* m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED) {
+            ok = lire_par_blocs(src, fd);
+        } else {
+            // Le lexer parcourt la source une fois, du début à la fin
+            posix_madvise(m, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+            src->donnees = (const char*)m;
+            src->longueur = (size_t)st.st_size;
+            src->projete = true;
+            ok = true;
+        }
+    }
+
+    close(fd);
+    return ok;
+}
+
+void source_fermer(SourceEntree* src) {
+    if (!src->donnees) return;
+
+    if (src->projete) {
+        if (src->longueur > 0) munmap((void*)src->donnees, src->longueur);
+    } else {
+        free((void*)src->donnees);
+    }
+    src->donnees = NULL;
+    src->longueur = 0;
+}
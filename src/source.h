@@ -0,0 +1,23 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Texte source d'un programme.
+// Un fichier régulier est projeté en mémoire (mmap, lecture seule) ;
+// l'entrée standard, un tube ou une FIFO sont lus par blocs.
+// Les données ne sont PAS terminées par '\0' : la fin est donnée par
+// longueur (le lexer teste son pointeur de fin).
+typedef struct {
+    const char* donnees;
+    size_t longueur;
+
+    bool projete;       // true: munmap à la fermeture, false: free
+} SourceEntree;
+
+// chemin == "-" : entrée standard
+bool source_ouvrir(SourceEntree* src, const char* chemin);
+void source_fermer(SourceEntree* src);
+
+#endif
@@ -2,123 +2,158 @@
 #define TOKENS_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+// Liste des tokens : X(NOM, catégories)
+// Chaque entrée produit deux valeurs consécutives TOK_NOM (paire) et
+// TOK_NOM_ERR (impaire), leur nom et leurs catégories (voir TC_*).
+// Ajouter un token se fait ici seulement.
+#define TOKENS(X) \
+    /* 1. Mots-clés de structure */ \
+    X(ALGORITHME,      TC_MOT_CLE) \
+    X(DEBUT,           TC_MOT_CLE) \
+    X(FIN,             TC_MOT_CLE | TC_FIN_BLOC) \
+    \
+    /* 2. Déclarations, types et constantes */ \
+    X(OBJETS,          TC_MOT_CLE) \
+    X(VARIABLE,        TC_MOT_CLE) \
+    X(CONSTANTE,       TC_MOT_CLE) \
+    X(ENTIER,          TC_MOT_CLE | TC_TYPE) \
+    X(REEL,            TC_MOT_CLE | TC_TYPE) \
+    X(CARACTERE,       TC_MOT_CLE | TC_TYPE) \
+    X(CHAINE,          TC_MOT_CLE | TC_TYPE) \
+    X(BOOLEEN,         TC_MOT_CLE | TC_TYPE) \
+    X(CONST_ENTIERE,   TC_CONSTANTE) \
+    X(CONST_REEL,      TC_CONSTANTE) \
+    X(CONST_CHAINE,    TC_CONSTANTE) \
+    X(ID,              TC_DEBUT_INSTR) \
+    X(TABLEAU,         TC_MOT_CLE | TC_TYPE) \
+    X(DE,              TC_MOT_CLE) \
+    X(STRUCTURE,       TC_MOT_CLE | TC_DEBUT_DEF) \
+    X(FIN_STRUCT,      TC_MOT_CLE) \
+    \
+    /* 3. Entrées / sorties */ \
+    X(ECRIRE,          TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(LIRE,            TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(RETOUR,          TC_MOT_CLE | TC_DEBUT_INSTR) \
+    \
+    /* 4. Constantes logiques et opérateurs logiques */ \
+    X(VRAI,            TC_MOT_CLE | TC_CONSTANTE) \
+    X(FAUX,            TC_MOT_CLE | TC_CONSTANTE) \
+    X(ET,              TC_MOT_CLE | TC_OPERATEUR) \
+    X(OU,              TC_MOT_CLE | TC_OPERATEUR) \
+    X(NON,             TC_MOT_CLE | TC_OPERATEUR) \
+    \
+    /* 5. Comparateurs */ \
+    X(INFERIEUR,       TC_OPERATEUR | TC_COMPARATEUR) \
+    X(INFERIEUR_EGAL,  TC_OPERATEUR | TC_COMPARATEUR) \
+    X(SUPERIEUR,       TC_OPERATEUR | TC_COMPARATEUR) \
+    X(SUPERIEUR_EGAL,  TC_OPERATEUR | TC_COMPARATEUR) \
+    X(EGAL,            TC_OPERATEUR | TC_COMPARATEUR) \
+    X(DIFFERENT,       TC_OPERATEUR | TC_COMPARATEUR) \
+    \
+    /* 6. Affectation, séparateurs, ponctuation */ \
+    X(AFFECTATION,     TC_OPERATEUR) \
+    X(DEUX_POINTS,     TC_SEPARATEUR) \
+    X(VIRGULE,         TC_SEPARATEUR) \
+    X(PAREN_OUVRANTE,  TC_SEPARATEUR) \
+    X(PAREN_FERMANTE,  TC_SEPARATEUR) \
+    X(CROCHET_OUVRANT, TC_SEPARATEUR) \
+    X(CROCHET_FERMANT, TC_SEPARATEUR) \
+    X(GUILLEMET,       TC_SEPARATEUR) \
+    X(POINT,           TC_SEPARATEUR) \
+    X(FIN_INSTR,       TC_SEPARATEUR | TC_FIN_BLOC) \
+    \
+    /* 7. Opérateurs arithmétiques */ \
+    X(PLUS,            TC_OPERATEUR) \
+    X(MOINS,           TC_OPERATEUR) \
+    X(FOIS,            TC_OPERATEUR) \
+    X(DIVISE,          TC_OPERATEUR) \
+    X(DIV_ENTIER,      TC_MOT_CLE | TC_OPERATEUR) \
+    X(MODULO,          TC_MOT_CLE | TC_OPERATEUR) \
+    X(PUISSANCE,       TC_OPERATEUR) \
+    \
+    /* 8. Structures de contrôle */ \
+    X(SI,              TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(SINONSI,         TC_MOT_CLE | TC_FIN_BLOC) \
+    X(ALORS,           TC_MOT_CLE) \
+    X(SINON,           TC_MOT_CLE | TC_FIN_BLOC) \
+    X(FIN_SI,          TC_MOT_CLE | TC_FIN_BLOC) \
+    X(SELON,           TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(CAS,             TC_MOT_CLE | TC_FIN_BLOC) \
+    X(DEFAUT,          TC_MOT_CLE | TC_FIN_BLOC) \
+    X(FIN_SELON,       TC_MOT_CLE | TC_FIN_BLOC) \
+    X(SORTIR,          TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(POUR,            TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(JUSQUA,          TC_MOT_CLE) \
+    X(REPETER,         TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(PAS,             TC_MOT_CLE) \
+    X(FIN_POUR,        TC_MOT_CLE | TC_FIN_BLOC) \
+    X(QUITTER_POUR,    TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(TANTQUE,         TC_MOT_CLE | TC_DEBUT_INSTR) \
+    X(FINTANTQUE,      TC_MOT_CLE | TC_FIN_BLOC) \
+    \
+    /* 9. Procédures et fonctions */ \
+    X(PROCEDURE,       TC_MOT_CLE | TC_DEBUT_DEF) \
+    X(FIN_PROC,        TC_MOT_CLE | TC_FIN_BLOC) \
+    X(FONCTION,        TC_MOT_CLE | TC_DEBUT_DEF) \
+    X(FIN_FONCT,       TC_MOT_CLE | TC_FIN_BLOC) \
+    X(RETOURNER,       TC_MOT_CLE | TC_DEBUT_INSTR) \
+    \
+    /* 10. Autres tokens spéciaux */ \
+    X(EOF,             TC_FIN_BLOC) \
+    X(COMMENTAIRE,     0) \
+    X(COMMENTAIRES,    0)
 
 // Énumération des tokens (normaux et erreur)
+#define TOKEN_ENUM(nom, categories) TOK_##nom, TOK_##nom##_ERR,
 typedef enum {
-    // 1. Mots-clés de structure
-    TOK_ALGORITHME, TOK_ALGORITHME_ERR,
-    TOK_DEBUT, TOK_DEBUT_ERR,
-    TOK_FIN, TOK_FIN_ERR,
-
-    // 2. Déclarations, types et constantes
-    TOK_OBJETS, TOK_OBJETS_ERR,
-    TOK_VARIABLE, TOK_VARIABLE_ERR,
-    TOK_CONSTANTE, TOK_CONSTANTE_ERR,
-    TOK_ENTIER, TOK_ENTIER_ERR,
-    TOK_REEL, TOK_REEL_ERR,
-    TOK_CARACTERE, TOK_CARACTERE_ERR,
-    TOK_CHAINE, TOK_CHAINE_ERR,
-    TOK_BOOLEEN, TOK_BOOLEEN_ERR,
-    TOK_CONST_ENTIERE, TOK_CONST_ENTIERE_ERR,
-    TOK_CONST_REEL, TOK_CONST_REEL_ERR,
-    TOK_CONST_CHAINE, TOK_CONST_CHAINE_ERR,
-    TOK_ID, TOK_ID_ERR,
-    TOK_TABLEAU, TOK_TABLEAU_ERR,
-    TOK_DE, TOK_DE_ERR,
-    TOK_STRUCTURE, TOK_STRUCTURE_ERR,
-    TOK_FIN_STRUCT, TOK_FIN_STRUCT_ERR,
-
-    // 3. Entrées / sorties
-    TOK_ECRIRE, TOK_ECRIRE_ERR,
-    TOK_LIRE, TOK_LIRE_ERR,
-    TOK_RETOUR, TOK_RETOUR_ERR,
-
-    // 4. Constantes logiques et opérateurs logiques
-    TOK_VRAI, TOK_VRAI_ERR,
-    TOK_FAUX, TOK_FAUX_ERR,
-    TOK_ET, TOK_ET_ERR,
-    TOK_OU, TOK_OU_ERR,
-    TOK_NON, TOK_NON_ERR,
-
-    // 5. Comparateurs
-    TOK_INFERIEUR, TOK_INFERIEUR_ERR,
-    TOK_INFERIEUR_EGAL, TOK_INFERIEUR_EGAL_ERR,
-    TOK_SUPERIEUR, TOK_SUPERIEUR_ERR,
-    TOK_SUPERIEUR_EGAL, TOK_SUPERIEUR_EGAL_ERR,
-    TOK_EGAL, TOK_EGAL_ERR,
-    TOK_DIFFERENT, TOK_DIFFERENT_ERR,
-
-    // 6. Affectation, séparateurs, ponctuation
-    TOK_AFFECTATION, TOK_AFFECTATION_ERR,
-    TOK_DEUX_POINTS, TOK_DEUX_POINTS_ERR,
-    TOK_VIRGULE, TOK_VIRGULE_ERR,
-    TOK_PAREN_OUVRANTE, TOK_PAREN_OUVRANTE_ERR,
-    TOK_PAREN_FERMANTE, TOK_PAREN_FERMANTE_ERR,
-    TOK_CROCHET_OUVRANT, TOK_CROCHET_OUVRANT_ERR,
-    TOK_CROCHET_FERMANT, TOK_CROCHET_FERMANT_ERR,
-    TOK_GUILLEMET, TOK_GUILLEMET_ERR,
-    TOK_POINT, TOK_POINT_ERR,
-    TOK_FIN_INSTR, TOK_FIN_INSTR_ERR,
-
-    // 7. Opérateurs arithmétiques
-    TOK_PLUS, TOK_PLUS_ERR,
-    TOK_MOINS, TOK_MOINS_ERR,
-    TOK_FOIS, TOK_FOIS_ERR,
-    TOK_DIVISE, TOK_DIVISE_ERR,
-    TOK_DIV_ENTIER, TOK_DIV_ENTIER_ERR,
-    TOK_MODULO, TOK_MODULO_ERR,
-    TOK_PUISSANCE, TOK_PUISSANCE_ERR,
-
-    // 8. Structures de contrôle
-    TOK_SI, TOK_SI_ERR,
-    TOK_SINONSI, TOK_SINONSI_ERR,
-    TOK_ALORS, TOK_ALORS_ERR,
-    TOK_SINON, TOK_SINON_ERR,
-    TOK_FIN_SI, TOK_FIN_SI_ERR,
-    TOK_SELON, TOK_SELON_ERR,
-    TOK_CAS, TOK_CAS_ERR,
-    TOK_DEFAUT, TOK_DEFAUT_ERR,
-    TOK_FIN_SELON, TOK_FIN_SELON_ERR,
-    TOK_SORTIR, TOK_SORTIR_ERR,
-    TOK_POUR, TOK_POUR_ERR,
-    TOK_JUSQUA, TOK_JUSQUA_ERR,
-    TOK_REPETER, TOK_REPETER_ERR,
-    TOK_PAS, TOK_PAS_ERR,
-    TOK_FIN_POUR, TOK_FIN_POUR_ERR,
-    TOK_QUITTER_POUR, TOK_QUITTER_POUR_ERR,
-    TOK_TANTQUE, TOK_TANTQUE_ERR,
-    TOK_FINTANTQUE, TOK_FINTANTQUE_ERR,
-
-    // 9. Procédures et fonctions
-    TOK_PROCEDURE, TOK_PROCEDURE_ERR,
-    TOK_FIN_PROC, TOK_FIN_PROC_ERR,
-    TOK_FONCTION, TOK_FONCTION_ERR,
-    TOK_FIN_FONCT, TOK_FIN_FONCT_ERR,
-    TOK_RETOURNER, TOK_RETOURNER_ERR,
-
-    // 10. Autres tokens spéciaux
-    TOK_EOF, TOK_EOF_ERR,
-    TOK_COMMENTAIRE, TOK_COMMENTAIRE_ERR,
-    TOK_COMMENTAIRES, TOK_COMMENTAIRES_ERR
+    TOKENS(TOKEN_ENUM)
+    TOK_NB_TYPES
 } TokenType;
+#undef TOKEN_ENUM
+
+// Catégories d'un token (les tokens d'erreur n'en ont aucune)
+enum {
+    TC_MOT_CLE     = 1 << 0,
+    TC_OPERATEUR   = 1 << 1,
+    TC_SEPARATEUR  = 1 << 2,
+    TC_CONSTANTE   = 1 << 3,
+    TC_TYPE        = 1 << 4,    // type de donnée
+    TC_COMPARATEUR = 1 << 5,
+    TC_DEBUT_INSTR = 1 << 6,    // peut commencer une instruction
+    TC_DEBUT_DEF   = 1 << 7,    // Structure, Fonction, Procédure
+    TC_FIN_BLOC    = 1 << 8     // termine un bloc ou une instruction
+                                // (suit un Retourner sans expression)
+};
+
+// Catégories indexées par TokenType
+extern const uint16_t TOKEN_CATEGORIES[TOK_NB_TYPES];
+
+static inline bool token_a_categorie(TokenType type, unsigned categories) {
+    return (TOKEN_CATEGORIES[type] & categories) != 0;
+}
 
 // Structure d'un token
+// Le texte est une tranche de la source : source + debut, sur longueur
+// octets, sans '\0' final. Un token ne possède rien.
 typedef struct {
     TokenType type;
-    char* valeur;
+    int debut;      // offset du lexème dans la source
+    int longueur;   // longueur du lexème en octets
     int ligne;
     int colonne;
 } Token;
 
 // Prototypes des fonctions
-Token* creer_token(TokenType type, const char* valeur, int ligne, int colonne);
+Token* creer_token(TokenType type, int debut, int longueur, int ligne, int colonne);
 void detruire_token(Token* token);
 Token* copier_token(const Token* token);
 
 const char* token_to_string(TokenType type);
-void afficher_token_ligne(const Token* token);
-void afficher_token_compact(const Token* token);
-void afficher_token_detail(const Token* token);
+void afficher_token_ligne(const Token* token, const char* source);
+void afficher_token_compact(const Token* token, const char* source);
+void afficher_token_detail(const Token* token, const char* source);
 
 bool est_token_erreur(TokenType type);
 bool est_mot_cle(TokenType type);
@@ -127,9 +162,9 @@ bool est_separateur(TokenType type);
 bool est_constante(TokenType type);
 bool est_type_donnee(TokenType type);
 
-bool tokens_egaux(const Token* t1, const Token* t2);
+bool tokens_egaux(const Token* t1, const Token* t2, const char* source);
 bool tokens_types_egaux(const Token* t1, const Token* t2);
-bool tokens_valeurs_egales(const Token* t1, const Token* t2);
+bool tokens_valeurs_egales(const Token* t1, const Token* t2, const char* source);
 
 bool token_valeur_vide(const Token* token);
 bool token_valide(const Token* token);
@@ -0,0 +1,60 @@
+#!/bin/sh
+# Cache de l'AST (--cache) : pour chaque programme de tests/valid, copié
+# dans un répertoire temporaire, deux compilations --cache --semantique
+# (écriture puis relecture du cache) ne doivent générer aucun code ; deux
+# compilations --cache --cible c doivent générer le même out.c que sans
+# cache.
+#
+# Usage (depuis la racine) : sh tests/cache.sh [./compilateur]
+
+COMPILATEUR=$(cd "$(dirname "${1:-./compilateur}")" && pwd)/$(basename "${1:-./compilateur}")
+RACINE=$(pwd)
+TMP=${TMPDIR:-/tmp}/cache.$$
+
+if [ ! -x "$COMPILATEUR" ]; then
+    echo "ECHEC : compilateur introuvable : $COMPILATEUR" >&2
+    exit 1
+fi
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+echecs=0
+verifies=0
+for f in "$RACINE"/tests/valid/*; do
+    nom=$(basename "$f")
+    rm -rf "$TMP"/* && cp "$f" "$TMP/prog.algo" && cd "$TMP" || exit 1
+
+    "$COMPILATEUR" --cache --semantique --cible c prog.algo > journal1 2>&1
+    "$COMPILATEUR" --cache --semantique --cible c prog.algo > journal2 2>&1
+    if [ -f prog.algoast ] && ! grep -q "AST chargé depuis le cache" journal2; then
+        echo "ECHEC : $nom, cache écrit mais non relu" >&2
+        echecs=$((echecs + 1))
+    fi
+    if [ -f out.c ]; then
+        echo "ECHEC : $nom, code généré avec --semantique" >&2
+        echecs=$((echecs + 1))
+    fi
+
+    if [ -f prog.algoast ]; then
+        "$COMPILATEUR" --cible c prog.algo > /dev/null 2>&1 && mv out.c sans_cache.c
+        "$COMPILATEUR" --cache --cible c prog.algo > /dev/null 2>&1
+        if ! cmp -s sans_cache.c out.c; then
+            echo "ECHEC : $nom, out.c différent depuis le cache" >&2
+            echecs=$((echecs + 1))
+        fi
+        verifies=$((verifies + 1))
+    fi
+    cd "$RACINE"
+done
+
+echo "programmes relus depuis le cache : $verifies"
+if [ "$echecs" -gt 0 ]; then
+    echo "ECHEC : $echecs" >&2
+    exit 1
+fi
+if [ "$verifies" -eq 0 ]; then
+    echo "ECHEC : aucun programme vérifié" >&2
+    exit 1
+fi
+echo "OK"
@@ -0,0 +1,86 @@
+#!/bin/sh
+# Test de charge : des centaines de fonctions et de procédures, dont
+# certaines fautives. Leurs corps sont vérifiés en parallèle
+# (SEM_SEUIL_PARALLELE, semantique.h) : les messages doivent être ceux
+# de la vérification séquentielle (ALGO_THREADS=1), dans le même ordre.
+# Affiche les durées et l'accélération (--semantique : ni tokens, ni AST,
+# ni génération).
+#
+# Usage (depuis la racine) : sh tests/corps.sh [./compilateur] [corps] [threads]
+
+COMPILATEUR=${1:-./compilateur}
+CORPS=${2:-2000}
+THREADS=${3:-4}
+TMP=${TMPDIR:-/tmp}/corps.$$
+
+trap 'rm -f "$TMP".*' EXIT
+
+# Programme à $1 corps dans le fichier $2 : une fonction sur deux, une
+# procédure sur deux ; un corps sur 50 contient deux erreurs
+awk -v n="$CORPS" 'BEGIN {
+    print "Algorithme CORPS"
+    print "Objets:"
+    print "    g : Variable entier"
+    print "    t : Tableau entier[100]"
+    print "Début"
+    for (f = 0; f < n; f++) {
+        if (f % 2 == 0) printf "    Fonction F%d(a : entier, b : réel) : entier\n", f
+        else printf "    Procédure P%d(a : entier, b : réel)\n", f
+        print "    Objets:"
+        print "        r : Variable entier"
+        print "        x : Variable réel"
+        print "        i : Variable entier"
+        print "    Début"
+        print "        r <- a"
+        print "        x <- b"
+        print "        Pour i <- 0 jusqu\047à 99"
+        for (l = 0; l < 40; l++) {
+            printf "            r <- r + t[(i + %d) mod 100] * %d - g\n", l, l % 7 + 1
+            printf "            x <- x * 2.0 + r / %d\n", l + 1
+        }
+        print "        FinPour"
+        if (f % 50 == 7) {
+            print "        r <- inconnu + 1"
+            print "        x <- r < \"texte\""
+        }
+        if (f % 2 == 0) {
+            if (f >= 2) printf "        r <- r + F%d(r, x)\n", f - 2
+            print "        Retourner r"
+            print "    FinFonct"
+        } else {
+            print "        g <- r"
+            print "    FinProc"
+        }
+    }
+    print "    g <- 0"
+    print "Fin"
+}' > "$TMP.algo"
+
+# Durée en millisecondes de l'analyse avec $1 threads, sortie dans $2
+mesurer() {
+    debut=$(date +%s%N)
+    ALGO_THREADS=$1 "$COMPILATEUR" --flux --semantique "$TMP.algo" > "$2" 2>&1
+    fin=$(date +%s%N)
+    echo $(( (fin - debut) / 1000000 ))
+}
+
+t_seq=$(mesurer 1 "$TMP.seq")
+t_par=$(mesurer "$THREADS" "$TMP.par")
+
+echo "corps $CORPS, 1 thread : ${t_seq} ms"
+echo "corps $CORPS, $THREADS threads : ${t_par} ms"
+if [ "$t_par" -gt 0 ]; then
+    echo "accélération : $(( t_seq * 100 / t_par ))/100"
+fi
+
+if ! grep -q "Erreurs sémantiques" "$TMP.seq"; then
+    echo "ECHEC : erreurs attendues non signalées" >&2
+    tail -n 5 "$TMP.seq" >&2
+    exit 1
+fi
+if ! cmp -s "$TMP.seq" "$TMP.par"; then
+    echo "ECHEC : messages différents de l'analyse séquentielle" >&2
+    diff "$TMP.seq" "$TMP.par" | head -n 10 >&2
+    exit 1
+fi
+echo "OK"
@@ -0,0 +1,82 @@
+#!/bin/sh
+# Test de charge : beaucoup de globales (constantes, tableaux, variables)
+# et des corps denses en expressions qui y font référence. La résolution
+# des noms (scopes indexés par hachage) doit rester en temps constant :
+# l'analyse sémantique est linéaire en la taille du programme
+# (--semantique : ni tokens, ni AST, ni génération).
+#
+# Usage (depuis la racine) : sh tests/globaux.sh [./compilateur] [globales]
+
+COMPILATEUR=${1:-./compilateur}
+GLOBALES=${2:-50000}
+TMP=${TMPDIR:-/tmp}/globaux.$$
+
+trap 'rm -f "$TMP".*' EXIT
+
+# Programme à $1 globales dans le fichier $2 : autant de constantes, de
+# tableaux et de variables, une fonction par tranche de 100 globales et
+# un bloc principal d'une affectation par variable
+generer() {
+    awk -v n="$1" 'BEGIN {
+        srand(1)
+        print "Algorithme GLOBAUX"
+        print "Objets:"
+        for (k = 0; k < n; k++) {
+            m = k % 3
+            if (m == 0) printf "    K%d : Constante entier = %d\n", k, k % 97
+            else if (m == 1) printf "    T%d : Tableau entier[8]\n", k
+            else printf "    V%d : Variable entier\n", k
+        }
+        print "Début"
+        for (f = 0; f < n / 100; f++) {
+            printf "    Fonction F%d(a : entier) : entier\n", f
+            print "    Objets:"
+            print "        r : Variable entier"
+            print "    Début"
+            print "        r <- a"
+            for (l = 0; l < 20; l++) {
+                printf "        r <- r + %s * %s - %s\n", cst(), tab(), var()
+            }
+            print "        Retourner r"
+            print "    FinFonct"
+        }
+        for (k = 2; k < n; k += 3) {
+            printf "    V%d <- (%s + %s) * %s - %s\n", k, cst(), var(), tab(), cst()
+        }
+        print "Fin"
+    }
+    function tirer(m) { return int(rand() * int(n / 3)) * 3 + m }
+    function cst() { return "K" tirer(0) }
+    function tab() { return "T" tirer(1) "[" int(rand() * 8) "]" }
+    function var() { return "V" tirer(2) }' > "$2"
+}
+
+# Durée en millisecondes de la compilation (jusqu'à la sémantique) de $1
+mesurer() {
+    debut=$(date +%s%N)
+    if ! "$COMPILATEUR" --flux --semantique "$1" > "$TMP.sortie" 2>&1; then
+        echo "ECHEC : $(basename "$1")" >&2
+        tail -n 5 "$TMP.sortie" >&2
+        exit 1
+    fi
+    fin=$(date +%s%N)
+    echo $(( (fin - debut) / 1000000 ))
+}
+
+petit=$((GLOBALES / 10))
+generer "$petit" "$TMP.petit"
+generer "$GLOBALES" "$TMP.grand"
+
+t_petit=$(mesurer "$TMP.petit") || exit 1
+t_grand=$(mesurer "$TMP.grand") || exit 1
+
+echo "globales $petit : ${t_petit} ms"
+echo "globales $GLOBALES : ${t_grand} ms"
+
+# Linéaire : 10x plus de globales et d'expressions, environ 10x plus long
+# (marge large pour les petites mesures)
+if [ "$t_grand" -gt $(( (t_petit + 10) * 30 )) ]; then
+    echo "ECHEC : temps non linéaire" >&2
+    exit 1
+fi
+echo "OK"
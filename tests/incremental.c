@@ -0,0 +1,126 @@
+// Ré-analyse incrémentale (lexer_modifier) : sur chaque fichier, des
+// modifications aléatoires (suppression d'une tranche, insertion de
+// fragments choisis pour traverser chaînes, commentaires, parenthèses et
+// fins d'instruction) ; après chacune, tokens, erreurs et état final
+// doivent être ceux d'une analyse complète du nouveau texte.
+//
+// Construit et lancé par tests/incremental.sh.
+// Usage : incremental <graine> <modifications> <fichier>...
+
+#include "../src/lexer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* FRAGMENTS[] = {
+    "", " ", "\n", "\n\n", "x", "x <- 1", "Si ", " Alors\n", "FinSi\n",
+    "(", ")", "[", "]", "\"", "\"abc\"", "'", "'c'", "/*", "*/", "/* c */",
+    "//", "// c\n", "1,5", "3.14", "<-", "<=", "<>", "é", "\xc3", "@", "#",
+    "Ecrire(\"a\", b)\n", "t[i] <- t[i + 1]\n",
+};
+#define NB_FRAGMENTS (sizeof(FRAGMENTS) / sizeof(FRAGMENTS[0]))
+
+static unsigned long long graine;
+
+static size_t hasard(size_t n) {
+    graine = graine * 6364136223846793005ull + 1442695040888963407ull;
+    return (n == 0) ? 0 : (size_t)((graine >> 33) % n);
+}
+
+static char* lire_fichier(const char* chemin, size_t* longueur) {
+    FILE* f = fopen(chemin, "rb");
+    if (!f) return NULL;
+    char* texte = NULL;
+    size_t cap = 0, n = 0, lu;
+    do {
+        if (n + 4096 > cap) {
+            cap = (cap == 0) ? 8192 : cap * 2;
+            char* t = (char*)realloc(texte, cap);
+            if (!t) { free(texte); fclose(f); return NULL; }
+            texte = t;
+        }
+        lu = fread(texte + n, 1, cap - n, f);
+        n += lu;
+    } while (lu > 0);
+    fclose(f);
+    *longueur = n;
+    return texte;
+}
+
+// Première différence entre le lexer modifié et une analyse complète,
+// NULL s'il n'y en a pas
+static const char* comparer(const Lexer* a, const Lexer* b) {
+    if (a->longueur != b->longueur || memcmp(a->source, b->source, a->longueur) != 0) return "le texte";
+    if (a->nb_tokens != b->nb_tokens) return "le nombre de tokens";
+    for (int i = 0; i < a->nb_tokens; i++) {
+        if (a->types[i] != b->types[i] || a->debuts[i] != b->debuts[i] ||
+            a->longueurs[i] != b->longueurs[i]) return "les tokens";
+    }
+    if (a->nb_erreurs != b->nb_erreurs) return "le nombre d'erreurs";
+    for (int i = 0; i < a->nb_erreurs; i++) {
+        if (a->offsets_erreur[i] != b->offsets_erreur[i] ||
+            strcmp(a->textes_erreur[i], b->textes_erreur[i]) != 0) return "les erreurs";
+    }
+    if (a->paren_depth != b->paren_depth || a->bracket_depth != b->bracket_depth) return "les profondeurs";
+    if (a->nb_emis != b->nb_emis || a->dernier_type != b->dernier_type ||
+        a->termine != b->termine) return "l'état final";
+    return NULL;
+}
+
+// nb modifications de la source du fichier ; nombre d'échecs
+static int verifier_fichier(const char* chemin, int nb) {
+    size_t longueur;
+    char* source = lire_fichier(chemin, &longueur);
+    if (!source) {
+        fprintf(stderr, "%s : lecture impossible\n", chemin);
+        return 1;
+    }
+
+    Lexer* lexer = creer_lexer(source, longueur, chemin);
+    if (!lexer) { free(source); return 1; }
+    analyser_lexicalement(lexer);
+
+    int echecs = 0;
+    for (int m = 0; m < nb && echecs == 0; m++) {
+        size_t offset = hasard(lexer->longueur + 1);
+        size_t nb_supprimes = hasard(lexer->longueur - offset + 1);
+        if (nb_supprimes > 16) nb_supprimes = hasard(17);
+
+        char insere[256] = "";
+        for (size_t k = hasard(3); k > 0; k--) strcat(insere, FRAGMENTS[hasard(NB_FRAGMENTS)]);
+
+        if (!lexer_modifier(lexer, offset, nb_supprimes, insere, strlen(insere), NULL)) {
+            fprintf(stderr, "%s : modification %d refusée\n", chemin, m);
+            echecs++;
+            break;
+        }
+
+        Lexer* complet = creer_lexer(lexer->source, lexer->longueur, chemin);
+        if (!complet) { echecs++; break; }
+        analyser_lexicalement(complet);
+        const char* ecart = comparer(lexer, complet);
+        if (ecart) {
+            fprintf(stderr, "%s : modification %d (offset %zu, -%zu, +\"%s\") : écart sur %s\n",
+                    chemin, m, offset, nb_supprimes, insere, ecart);
+            echecs++;
+        }
+        detruire_lexer(complet);
+    }
+
+    detruire_lexer(lexer);
+    free(source);
+    return echecs;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <graine> <modifications> <fichier>...\n", argv[0]);
+        return 2;
+    }
+    graine = strtoull(argv[1], NULL, 10);
+    int nb = atoi(argv[2]);
+
+    int echecs = 0;
+    for (int i = 3; i < argc; i++) echecs += verifier_fichier(argv[i], nb);
+    return (echecs > 0) ? 1 : 0;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Ré-analyse incrémentale (lexer_modifier) : le programme
+# tests/incremental.c, lié aux sources du compilateur, applique des
+# modifications aléatoires à chaque fichier de tests/valid et
+# tests/invalid et compare, après chacune, le résultat à une analyse
+# lexicale complète du nouveau texte (tokens, erreurs, état final).
+#
+# Usage (depuis la racine) : sh tests/incremental.sh [graine] [modifications]
+
+GRAINE=${1:-1}
+MODIFICATIONS=${2:-300}
+TMP=${TMPDIR:-/tmp}/incremental.$$
+
+trap 'rm -f "$TMP"' EXIT
+
+SOURCES=$(ls src/*.c | grep -v '^src/main\.c$')
+gcc -std=c99 -O1 -g -o "$TMP" tests/incremental.c $SOURCES -lpthread || exit 1
+
+set --
+for f in tests/valid/* tests/invalid/*; do
+    [ -f "$f" ] && set -- "$@" "$f"
+done
+
+if ! "$TMP" "$GRAINE" "$MODIFICATIONS" "$@"; then
+    echo "ECHEC (graine $GRAINE)" >&2
+    exit 1
+fi
+echo "fichiers vérifiés : $#, modifications par fichier : $MODIFICATIONS"
+echo "OK"
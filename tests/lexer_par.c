@@ -0,0 +1,112 @@
+// Analyse lexicale parallèle : durée d'analyser_lexicalement() sur un
+// fichier avec ALGO_THREADS_LEXER = 1..max (meilleure de plusieurs
+// mesures), et tokens et erreurs identiques à ceux de l'analyse
+// séquentielle.
+//
+// Construit et lancé par tests/lexer_par.sh.
+// Usage : lexer_par <fichier> <threads max> <mesures>
+
+// clock_gettime, setenv : POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/lexer.h"
+#include "../src/lexer_par.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static char* lire_fichier(const char* chemin, size_t* longueur) {
+    FILE* f = fopen(chemin, "rb");
+    if (!f) return NULL;
+    char* texte = NULL;
+    size_t cap = 0, n = 0, lu;
+    do {
+        if (n + 4096 > cap) {
+            cap = (cap == 0) ? 8192 : cap * 2;
+            char* t = (char*)realloc(texte, cap);
+            if (!t) { free(texte); fclose(f); return NULL; }
+            texte = t;
+        }
+        lu = fread(texte + n, 1, cap - n, f);
+        n += lu;
+    } while (lu > 0);
+    fclose(f);
+    *longueur = n;
+    return texte;
+}
+
+static double maintenant_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static bool memes_resultats(const Lexer* a, const Lexer* b) {
+    if (a->nb_tokens != b->nb_tokens || a->nb_erreurs != b->nb_erreurs) return false;
+    if (memcmp(a->types, b->types, (size_t)a->nb_tokens) != 0 ||
+        memcmp(a->debuts, b->debuts, (size_t)a->nb_tokens * sizeof(uint32_t)) != 0 ||
+        memcmp(a->longueurs, b->longueurs, (size_t)a->nb_tokens * sizeof(uint32_t)) != 0) return false;
+    for (int i = 0; i < a->nb_erreurs; i++) {
+        if (a->offsets_erreur[i] != b->offsets_erreur[i] ||
+            strcmp(a->textes_erreur[i], b->textes_erreur[i]) != 0) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <fichier> <threads max> <mesures>\n", argv[0]);
+        return 2;
+    }
+    size_t longueur;
+    char* source = lire_fichier(argv[1], &longueur);
+    if (!source) {
+        fprintf(stderr, "%s : lecture impossible\n", argv[1]);
+        return 2;
+    }
+    int max = atoi(argv[2]);
+    int mesures = atoi(argv[3]);
+    if (max < 1) max = 1;
+    if (mesures < 1) mesures = 1;
+
+    Lexer* reference = NULL;
+    double t_seq = 0.0;
+    int echecs = 0;
+    for (int n = 1; n <= max; n++) {
+        char valeur[16];
+        snprintf(valeur, sizeof(valeur), "%d", n);
+        setenv("ALGO_THREADS_LEXER", valeur, 1);
+
+        double meilleur = 0.0;
+        for (int m = 0; m < mesures; m++) {
+            Lexer* lexer = creer_lexer(source, longueur, argv[1]);
+            if (!lexer) return 2;
+            double debut = maintenant_ms();
+            analyser_lexicalement(lexer);
+            double duree = maintenant_ms() - debut;
+            if (m == 0 || duree < meilleur) meilleur = duree;
+
+            if (!reference) {
+                reference = lexer;
+            } else {
+                if (!memes_resultats(reference, lexer)) {
+                    fprintf(stderr, "ECHEC : %d threads, tokens ou erreurs différents\n", n);
+                    echecs++;
+                }
+                detruire_lexer(lexer);
+            }
+        }
+        if (n == 1) t_seq = meilleur;
+
+        printf("%d thread%s (%d effectif%s) : %.1f ms",
+               n, (n > 1) ? "s" : "", lexer_par_nb_threads(longueur),
+               (lexer_par_nb_threads(longueur) > 1) ? "s" : "", meilleur);
+        if (n > 1 && meilleur > 0.0) printf(", accélération %.2f", t_seq / meilleur);
+        printf("\n");
+    }
+
+    detruire_lexer(reference);
+    free(source);
+    return (echecs > 0) ? 1 : 0;
+}
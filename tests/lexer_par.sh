@@ -0,0 +1,45 @@
+#!/bin/sh
+# Analyse lexicale parallèle (lexer_par.h), sur demande (ALGO_THREADS_LEXER) :
+# mesure de l'accélération de 1 à n threads sur une source générée de
+# quelques dizaines de Mo (commentaires, chaînes, expressions), et
+# vérification que tokens et erreurs sont ceux de l'analyse séquentielle.
+# Le programme tests/lexer_par.c est lié aux sources du compilateur ;
+# seule analyser_lexicalement() est chronométrée.
+#
+# Usage (depuis la racine) : sh tests/lexer_par.sh [threads max] [Mo] [mesures]
+
+MAX=${1:-4}
+MO=${2:-32}
+MESURES=${3:-3}
+TMP=${TMPDIR:-/tmp}/lexer_par.$$
+
+trap 'rm -f "$TMP" "$TMP".*' EXIT
+
+SOURCES=$(ls src/*.c | grep -v '^src/main\.c$')
+gcc -std=c99 -O2 -o "$TMP" tests/lexer_par.c $SOURCES -lpthread || exit 1
+
+# Source d'environ $MO Mo : une procédure répétée, avec une erreur
+# lexicale toutes les 1000 procédures
+awk -v mo="$MO" 'BEGIN {
+    print "Algorithme LEXER_PAR"
+    print "Début"
+    taille = 0
+    for (p = 0; taille < mo * 1048576; p++) {
+        ligne = sprintf("    Procédure P%d(a : entier, b : réel)\n", p)
+        ligne = ligne "    Objets:\n        r : Variable entier\n    Début\n"
+        ligne = ligne "        /* commentaire\n           sur deux lignes */\n"
+        ligne = ligne sprintf("        r <- (a + %d) * 3 - t[a Mod 7] // fin de ligne\n", p)
+        ligne = ligne "        Ecrire(\"valeur : \", r, \" et b = \", b)\n"
+        if (p % 1000 == 999) ligne = ligne "        r <- r @ 1\n"
+        ligne = ligne "    FinProc\n"
+        printf "%s", ligne
+        taille += length(ligne)
+    }
+    print "Fin"
+}' > "$TMP.algo"
+
+echo "source : $(wc -c < "$TMP.algo") octets"
+if ! "$TMP" "$TMP.algo" "$MAX" "$MESURES"; then
+    exit 1
+fi
+echo "OK"
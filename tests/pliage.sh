@@ -0,0 +1,94 @@
+#!/bin/sh
+# Pliage des constantes (--pliage) : chaque programme de tests/valid est
+# généré sans pliage, puis avec pliage seul, avec partage (--partage) et
+# depuis le cache (--cache, second passage), et exécuté avec la même
+# entrée ; les sorties doivent être identiques. Cibles C et Python, Java
+# si javac est disponible. La version non pliée doit elle aussi compiler
+# et aboutir avec chaque cible.
+#
+# Usage (depuis la racine) : sh tests/pliage.sh [./compilateur]
+
+COMPILATEUR=$(cd "$(dirname "${1:-./compilateur}")" && pwd)/$(basename "${1:-./compilateur}")
+RACINE=$(pwd)
+TMP=${TMPDIR:-/tmp}/pliage.$$
+
+if [ ! -x "$COMPILATEUR" ]; then
+    echo "ECHEC : compilateur introuvable : $COMPILATEUR" >&2
+    exit 1
+fi
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+# Entrée des programmes qui lisent des valeurs
+ENTREE="$TMP/entree"
+for k in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20; do
+    echo 3
+done > "$ENTREE"
+
+CIBLES="c python"
+if command -v javac > /dev/null 2>&1 && command -v java > /dev/null 2>&1; then
+    CIBLES="$CIBLES java"
+fi
+
+# Génère $1 (copié en prog.algo) pour la cible $2 (options $3) dans le
+# répertoire $4, puis l'exécute ; sortie du programme dans $4/sortie. Le
+# cache prog.algoast éventuel est gardé d'un appel à l'autre.
+executer() {
+    mkdir -p "$4" && cp "$1" "$4/prog.algo" && cd "$4" || return 1
+    rm -f out.c out.py Main.java Main.class prog sortie
+    "$COMPILATEUR" --flux $3 --cible "$2" prog.algo > journal 2>&1 || { cd "$RACINE"; return 1; }
+    case "$2" in
+        c)      gcc -w -o prog out.c -lm > /dev/null 2>&1 &&
+                timeout 10 ./prog < "$ENTREE" > sortie 2>&1 ;;
+        python) timeout 10 python3 out.py < "$ENTREE" > sortie 2>&1 ;;
+        java)   javac Main.java > /dev/null 2>&1 &&
+                timeout 10 java Main < "$ENTREE" > sortie 2>&1 ;;
+    esac
+    r=$?
+    cd "$RACINE"
+    return $r
+}
+
+echecs=0
+verifies=0
+for f in "$RACINE"/tests/valid/*; do
+    nom=$(basename "$f")
+    for cible in $CIBLES; do
+        if ! executer "$f" "$cible" "" "$TMP/brut"; then
+            echo "ECHEC : $nom ($cible), version non pliée" >&2
+            echecs=$((echecs + 1))
+            continue
+        fi
+        for options in "--pliage" "--partage --pliage" "--cache --pliage"; do
+            rm -rf "$TMP/plie"
+            # --cache : le premier passage écrit le cache, le second le relit
+            case "$options" in
+                --cache*) executer "$f" "$cible" "$options" "$TMP/plie" ;;
+            esac
+            if ! executer "$f" "$cible" "$options" "$TMP/plie"; then
+                echo "ECHEC : $nom ($cible, $options), version pliée" >&2
+                echecs=$((echecs + 1))
+                continue
+            fi
+            if ! cmp -s "$TMP/brut/sortie" "$TMP/plie/sortie"; then
+                echo "ECHEC : $nom ($cible, $options), sorties différentes" >&2
+                diff "$TMP/brut/sortie" "$TMP/plie/sortie" | head -n 5 >&2
+                echecs=$((echecs + 1))
+                continue
+            fi
+            verifies=$((verifies + 1))
+        done
+    done
+done
+
+echo "exécutions comparées : $verifies"
+if [ "$echecs" -gt 0 ]; then
+    echo "ECHEC : $echecs" >&2
+    exit 1
+fi
+if [ "$verifies" -eq 0 ]; then
+    echo "ECHEC : aucune exécution comparée" >&2
+    exit 1
+fi
+echo "OK"
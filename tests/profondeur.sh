@@ -0,0 +1,72 @@
+#!/bin/sh
+# Test de charge : imbrications très profondes (Si / TantQue / Pour et
+# parenthèses). L'analyse syntaxique et la libération de l'AST
+# n'utilisent pas la pile C : le programme doit passer quelle que soit la
+# profondeur, en temps linéaire (--syntaxe : ni tokens ni AST affichés).
+#
+# Usage (depuis la racine) : sh tests/profondeur.sh [./compilateur] [profondeur]
+
+COMPILATEUR=${1:-./compilateur}
+PROFONDEUR=${2:-100000}
+TMP=${TMPDIR:-/tmp}/profondeur.$$
+
+trap 'rm -f "$TMP".*' EXIT
+
+# Programme de profondeur $1 dans le fichier $2
+generer() {
+    awk -v n="$1" 'BEGIN {
+        print "Algorithme PROFONDEUR"
+        print "Objets:"
+        print "    x : Variable entier"
+        print "    i : Variable entier"
+        print "Début"
+        for (k = 0; k < n; k++) {
+            m = k % 3
+            if (m == 0) print "Si x < 10 Alors"
+            else if (m == 1) print "TantQue x > 0"
+            else print "Pour i <- 1 jusqua 2"
+        }
+        printf "x <- "
+        for (k = 0; k < n; k++) printf "("
+        printf "x"
+        for (k = 0; k < n; k++) printf " + 1)"
+        print ""
+        for (k = n - 1; k >= 0; k--) {
+            m = k % 3
+            if (m == 0) print "FinSi"
+            else if (m == 1) print "FinTantQue"
+            else print "FinPour"
+        }
+        print "Fin"
+    }' > "$2"
+}
+
+# Durée en millisecondes de l'analyse syntaxique du fichier $1
+mesurer() {
+    debut=$(date +%s%N)
+    if ! "$COMPILATEUR" --flux --syntaxe "$1" > "$TMP.sortie" 2>&1; then
+        echo "ECHEC : profondeur $(basename "$1")" >&2
+        tail -n 5 "$TMP.sortie" >&2
+        exit 1
+    fi
+    fin=$(date +%s%N)
+    echo $(( (fin - debut) / 1000000 ))
+}
+
+petite=$((PROFONDEUR / 10))
+generer "$petite" "$TMP.petit"
+generer "$PROFONDEUR" "$TMP.grand"
+
+t_petit=$(mesurer "$TMP.petit") || exit 1
+t_grand=$(mesurer "$TMP.grand") || exit 1
+
+echo "profondeur $petite : ${t_petit} ms"
+echo "profondeur $PROFONDEUR : ${t_grand} ms"
+
+# Linéaire : 10x plus profond, environ 10x plus long (marge large pour
+# les petites mesures)
+if [ "$t_grand" -gt $(( (t_petit + 10) * 30 )) ]; then
+    echo "ECHEC : temps non linéaire" >&2
+    exit 1
+fi
+echo "OK"
@@ -0,0 +1,63 @@
+#!/bin/sh
+# Noyaux de balayage (lexer_simd.h) : la liste des tokens et les erreurs
+# affichées avec chaque valeur d'ALGO_SIMD doivent être celles du noyau
+# scalaire, pour chaque fichier de tests/valid et tests/invalid et pour
+# un fichier généré (commentaires, chaînes et lignes de toutes longueurs,
+# de part et d'autre des blocs de 16 et 32 octets). Un noyau absent du
+# processeur est remplacé par le suivant : le test passe alors aussi.
+#
+# Usage (depuis la racine) : sh tests/simd.sh [./compilateur]
+
+COMPILATEUR=${1:-./compilateur}
+NOYAUX="sse2 avx2"
+TMP=${TMPDIR:-/tmp}/simd.$$
+
+trap 'rm -f "$TMP".*' EXIT
+
+# Longueurs 0 à 79 : fin de commentaire, guillemet, '\n' à chaque
+# position d'un bloc
+awk 'BEGIN {
+    print "Algorithme SIMD"
+    print "Objets:"
+    print "    s : Variable chaine"
+    print "Début"
+    for (n = 0; n < 80; n++) {
+        pad = sprintf("%" n "s", "")
+        printf "    /*%s*/ s <- \"%s\"\n", pad, pad
+        printf "    s <- \"%s\\\"%s\" // %s\n", pad, pad, pad
+        printf "    /*%s\n%s**/\n", pad, pad
+        printf "%s\n", pad
+    }
+    print "    s <- \"non fermée"
+    print "    /* non fermé"
+    print "Fin"
+}' > "$TMP.algo"
+
+# Sortie du compilateur sur $2 avec ALGO_SIMD=$1 (tokens, erreurs,
+# analyse syntaxique)
+lister() {
+    ALGO_SIMD=$1 "$COMPILATEUR" --syntaxe "$2" 2>&1
+}
+
+echecs=0
+verifies=0
+for f in tests/valid/* tests/invalid/* "$TMP.algo"; do
+    [ -f "$f" ] || continue
+    lister scalaire "$f" > "$TMP.scalaire"
+    for noyau in $NOYAUX; do
+        lister "$noyau" "$f" > "$TMP.$noyau"
+        if ! cmp -s "$TMP.scalaire" "$TMP.$noyau"; then
+            echo "ECHEC : $f, ALGO_SIMD=$noyau" >&2
+            diff "$TMP.scalaire" "$TMP.$noyau" | head -n 5 >&2
+            echecs=$((echecs + 1))
+        fi
+        verifies=$((verifies + 1))
+    done
+done
+
+echo "comparaisons : $verifies"
+if [ "$echecs" -gt 0 ]; then
+    echo "ECHEC : $echecs" >&2
+    exit 1
+fi
+echo "OK"